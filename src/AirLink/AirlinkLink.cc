@@ -132,20 +132,26 @@ bool AirlinkLink::_connect()
     });
     MAVLinkProtocol *mavlink = qgcApp()->toolbox()->mavlinkProtocol();
     auto conn = std::make_shared<QMetaObject::Connection>();
-    *conn = connect(mavlink, &MAVLinkProtocol::messageReceived, [this, conn] (LinkInterface* linkSrc, mavlink_message_t message) {
-        if (this != linkSrc || message.msgid != MAVLINK_MSG_ID_AIRLINK_AUTH_RESPONSE) {
+    *conn = connect(mavlink, &MAVLinkProtocol::messagesReceived, [this, conn] (LinkInterface* linkSrc, const QList<mavlink_message_t>& messages) {
+        if (this != linkSrc) {
             return;
         }
-        mavlink_airlink_auth_response_t responseMsg;
-        mavlink_msg_airlink_auth_response_decode(&message, &responseMsg);
-        int answer = responseMsg.resp_type;
-        if (answer != AIRLINK_AUTH_RESPONSE_TYPE::AIRLINK_AUTH_OK) {
-            qDebug() << "Airlink auth failed";
+        for (const mavlink_message_t& message: messages) {
+            if (message.msgid != MAVLINK_MSG_ID_AIRLINK_AUTH_RESPONSE) {
+                continue;
+            }
+            mavlink_airlink_auth_response_t responseMsg;
+            mavlink_msg_airlink_auth_response_decode(&message, &responseMsg);
+            int answer = responseMsg.resp_type;
+            if (answer != AIRLINK_AUTH_RESPONSE_TYPE::AIRLINK_AUTH_OK) {
+                qDebug() << "Airlink auth failed";
+                continue;
+            }
+            qDebug() << "Connected successfully";
+            QObject::disconnect(*conn);
+            _setConnectFlag(false);
             return;
         }
-        qDebug() << "Connected successfully";
-        QObject::disconnect(*conn);
-        _setConnectFlag(false);
     });
     _setConnectFlag(true);
     pendingTimer->start(0);
@@ -88,7 +88,7 @@ signals:
     void rangeListChanged   ();
 
 private slots:
-    void _receiveMessage    (LinkInterface* link, mavlink_message_t message);
+    void _receiveMessages   (LinkInterface* link, const QList<mavlink_message_t>& messages);
     void _vehicleAdded      (Vehicle* vehicle);
     void _vehicleRemoved    (Vehicle* vehicle);
     void _setActiveVehicle  (Vehicle* vehicle);
@@ -96,6 +96,7 @@ private slots:
 
 private:
     QGCMAVLinkSystem* _findVehicle (uint8_t id);
+    void              _receiveMessage(const mavlink_message_t& message);
 
 private:
 
@@ -14,7 +14,7 @@
 QGC_LOGGING_CATEGORY(MAVLinkMessageLog, "qgc.analyzeview.mavlinkmessage")
 
 //-----------------------------------------------------------------------------
-QGCMAVLinkMessage::QGCMAVLinkMessage(QObject *parent, mavlink_message_t* message)
+QGCMAVLinkMessage::QGCMAVLinkMessage(QObject *parent, const mavlink_message_t* message)
     : QObject(parent)
 {
     _message = *message;
@@ -101,7 +101,7 @@ void QGCMAVLinkMessage::setTargetRateHz(int32_t rate)
 
 //-----------------------------------------------------------------------------
 void
-QGCMAVLinkMessage::update(mavlink_message_t* message)
+QGCMAVLinkMessage::update(const mavlink_message_t* message)
 {
     _count++;
     _message = *message;
@@ -42,7 +42,7 @@ public:
     Q_PROPERTY(bool                 fieldSelected   READ fieldSelected  NOTIFY fieldSelectedChanged)
     Q_PROPERTY(bool                 selected        READ selected       NOTIFY selectedChanged)
 
-    QGCMAVLinkMessage   (QObject* parent, mavlink_message_t* message);
+    QGCMAVLinkMessage   (QObject* parent, const mavlink_message_t* message);
     ~QGCMAVLinkMessage  ();
 
     quint32             id              () const { return _message.msgid;  }
@@ -58,7 +58,7 @@ public:
     bool                selected        () const { return _selected; }
 
     void                updateFieldSelection();
-    void                update          (mavlink_message_t* message);
+    void                update          (const mavlink_message_t* message);
     void                updateFreq      ();
     void                setSelected     (bool sel);
     void                setTargetRateHz (int32_t rate);
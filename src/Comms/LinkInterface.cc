@@ -9,6 +9,7 @@
 
 #include "LinkInterface.h"
 #include "LinkManager.h"
+#include "MAVLinkParser.h"
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
 #include "MAVLinkSigning.h"
@@ -19,6 +20,7 @@
 #include "MockLink.h"
 #endif
 
+#include <QtCore/QTimer>
 #include <QtQml/QQmlEngine>
 
 QGC_LOGGING_CATEGORY(LinkInterfaceLog, "LinkInterfaceLog")
@@ -36,6 +38,15 @@ LinkInterface::~LinkInterface()
         qCWarning(LinkInterfaceLog) << Q_FUNC_INFO << "still have vehicle references:" << _vehicleReferenceCount;
     }
 
+    if (_mavlinkParserThread) {
+        // The parser is deleted by the thread on its way out
+        _mavlinkParserThread->quit();
+        (void) _mavlinkParserThread->wait();
+        delete _mavlinkParserThread;
+        _mavlinkParserThread = nullptr;
+        _mavlinkParser = nullptr;
+    }
+
     _config.reset();
 }
 
@@ -69,6 +80,10 @@ bool LinkInterface::initMavlinkSigning(void)
             // FIXME: What should we do here?
             return false;
         }
+
+        if (_mavlinkParser) {
+            _mavlinkParser->updateSigning();
+        }
     }
 
     return true;
@@ -111,8 +126,66 @@ void LinkInterface::_freeMavlinkChannel()
 
 void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
 {
-    const QByteArray data(bytes, length);
-    (void) QMetaObject::invokeMethod(this, "_writeBytes", Qt::AutoConnection, data);
+    writeBytesThreadSafe(QByteArray(bytes, length));
+}
+
+void LinkInterface::writeBytesThreadSafe(const QByteArray &bytes)
+{
+    if (bytes.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&_writeQueueMutex);
+
+    const qsizetype maxWriteSize = _maxCoalescedWriteSize();
+    if (_writeQueue.isEmpty() || ((_writeQueue.last().size() + bytes.size()) > maxWriteSize)) {
+        // Start a new write, which shares bytes rather than copying it
+        _writeQueue.append(bytes);
+    } else {
+        _writeQueue.last().append(bytes);
+    }
+    _writeQueueBytes += bytes.size();
+
+    if (!_writeFlushScheduled) {
+        _writeFlushScheduled = true;
+        if (_writeLatencyMSecs > 0) {
+            QTimer::singleShot(_writeLatencyMSecs, Qt::PreciseTimer, this, &LinkInterface::_flushWriteQueue);
+        } else {
+            (void) QMetaObject::invokeMethod(this, &LinkInterface::_flushWriteQueue, Qt::QueuedConnection);
+        }
+    } else if ((_writeLatencyMSecs > 0) && !_writeFlushUrgent && (_writeQueueBytes >= maxWriteSize)) {
+        // A full write is waiting, no point holding it back for the rest of the latency window
+        _writeFlushUrgent = true;
+        (void) QMetaObject::invokeMethod(this, &LinkInterface::_flushWriteQueue, Qt::QueuedConnection);
+    }
+}
+
+void LinkInterface::setWriteLatencyMSecs(int msecs)
+{
+    QMutexLocker locker(&_writeQueueMutex);
+    _writeLatencyMSecs = qMax(msecs, 0);
+}
+
+int LinkInterface::writeLatencyMSecs()
+{
+    QMutexLocker locker(&_writeQueueMutex);
+    return _writeLatencyMSecs;
+}
+
+void LinkInterface::_flushWriteQueue()
+{
+    QList<QByteArray> writes;
+    {
+        QMutexLocker locker(&_writeQueueMutex);
+        writes.swap(_writeQueue);
+        _writeQueueBytes = 0;
+        _writeFlushScheduled = false;
+        _writeFlushUrgent = false;
+    }
+
+    for (const QByteArray &bytes : writes) {
+        _writeBytes(bytes);
+    }
 }
 
 void LinkInterface::removeVehicleReference()
@@ -10,11 +10,14 @@
 #pragma once
 
 #include <QtCore/QThread>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
 
 #include "LinkConfiguration.h"
 
 class LinkManager;
+class MAVLinkParser;
 
 Q_DECLARE_LOGGING_CATEGORY(LinkInterfaceLog)
 
@@ -40,7 +43,17 @@ public:
     bool mavlinkChannelIsSet() const;
     bool decodedFirstMavlinkPacket(void) const { return _decodedFirstMavlinkPacket; }
     void setDecodedFirstMavlinkPacket(bool decodedFirstMavlinkPacket) { _decodedFirstMavlinkPacket = decodedFirstMavlinkPacket; }
+    /// Framing stage running on its own worker thread, set up by LinkManager
+    MAVLinkParser *mavlinkParser() const { return _mavlinkParser; }
+    /// Queues @a bytes for writing on the link's thread. Writes queued close together are coalesced into a single
+    /// write, see setWriteLatencyMSecs.
     void writeBytesThreadSafe(const char *bytes, int length);
+    /// Same as above, but @a bytes is handed to the link's thread without being copied
+    void writeBytesThreadSafe(const QByteArray &bytes);
+    /// Upper bound on how long a queued write may wait to be coalesced with later ones. With 0 writes are only
+    /// coalesced with those queued before the link's thread gets around to writing, so no latency is added.
+    void setWriteLatencyMSecs(int msecs);
+    int writeLatencyMSecs();
     void addVehicleReference() { ++_vehicleReferenceCount; }
     void removeVehicleReference();
     bool initMavlinkSigning();
@@ -65,20 +78,35 @@ protected:
 
     void _connectionRemoved();
 
+    /// Largest single write coalesced writes are combined into. Bigger writes still go out as is.
+    virtual qsizetype _maxCoalescedWriteSize() const { return 16 * 1024; }
+
     SharedLinkConfigurationPtr _config;
 
 private slots:
     /// Not thread safe if called directly, only writeBytesThreadSafe is thread safe
     virtual void _writeBytes(const QByteArray &bytes) = 0;
 
+    /// Writes out everything queued by writeBytesThreadSafe. Runs on the link's thread.
+    void _flushWriteQueue();
+
 private:
     /// connect is private since all links should be created through LinkManager::createConnectedLink calls
     virtual bool _connect() = 0;
 
     uint8_t _mavlinkChannel = std::numeric_limits<uint8_t>::max();
+    MAVLinkParser *_mavlinkParser = nullptr;
+    QThread *_mavlinkParserThread = nullptr;    ///< Runs _mavlinkParser, deletes it when finished
     bool _decodedFirstMavlinkPacket = false;
     int _vehicleReferenceCount = 0;
     bool _signingSignatureFailure = false;
+
+    QMutex _writeQueueMutex;
+    QList<QByteArray> _writeQueue;          ///< Coalesced writes, guarded by _writeQueueMutex
+    qsizetype _writeQueueBytes = 0;         ///< Guarded by _writeQueueMutex
+    bool _writeFlushScheduled = false;      ///< Guarded by _writeQueueMutex
+    bool _writeFlushUrgent = false;         ///< Guarded by _writeQueueMutex
+    int _writeLatencyMSecs = 0;             ///< Guarded by _writeQueueMutex
 };
 
 typedef std::shared_ptr<LinkInterface> SharedLinkInterfacePtr;
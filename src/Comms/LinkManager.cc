@@ -10,6 +10,7 @@
 #include "LinkManager.h"
 #include "DeviceInfo.h"
 #include "LogReplayLink.h"
+#include "MAVLinkParser.h"
 #include "MAVLinkProtocol.h"
 #include "MultiVehicleManager.h"
 #include "QGCApplication.h"
@@ -89,6 +90,8 @@ void LinkManager::setToolbox(QGCToolbox *toolbox)
     _autoConnectSettings = toolbox->settingsManager()->autoConnectSettings();
     _mavlinkProtocol = _toolbox->mavlinkProtocol();
 
+    (void) connect(toolbox->settingsManager()->appSettings()->linkWriteLatency(), &Fact::rawValueChanged, this, &LinkManager::_linkWriteLatencyChanged);
+
     if (!qgcApp()->runningUnitTests()) {
         (void) connect(_portListTimer, &QTimer::timeout, this, &LinkManager::_updateAutoConnectLinks);
         _portListTimer->start(_autoconnectUpdateTimerMSecs); // timeout must be long enough to get past bootloader on second pass
@@ -159,9 +162,21 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr &config)
 
     (void) _rgLinks.append(link);
     config->setLink(link);
+    link->setWriteLatencyMSecs(_toolbox->settingsManager()->appSettings()->linkWriteLatency()->rawValue().toInt());
+
+    // The parser gets a thread of its own. Serial and TCP links live on the main thread, so using the link's thread
+    // would leave framing and loss accounting on the main thread for them.
+    link->_mavlinkParserThread = new QThread();
+    link->_mavlinkParserThread->setObjectName(QStringLiteral("MAVLinkParser %1").arg(config->name()));
+    link->_mavlinkParser = new MAVLinkParser(link.get(), _mavlinkProtocol);
+    link->_mavlinkParser->moveToThread(link->_mavlinkParserThread);
+    (void) connect(link->_mavlinkParserThread, &QThread::finished, link->_mavlinkParser, &QObject::deleteLater);
+    link->_mavlinkParserThread->start();
 
     (void) connect(link.get(), &LinkInterface::communicationError, _app, &QGCApplication::criticalMessageBoxOnMainThread);
-    (void) connect(link.get(), &LinkInterface::bytesReceived, _mavlinkProtocol, &MAVLinkProtocol::receiveBytes);
+    (void) connect(link.get(), &LinkInterface::bytesReceived, link->_mavlinkParser, &MAVLinkParser::parseBytes);
+    (void) connect(link->_mavlinkParser, &MAVLinkParser::messagesReceived, _mavlinkProtocol, &MAVLinkProtocol::receiveMessages);
+    (void) connect(link->_mavlinkParser, &MAVLinkParser::messageStatus, _mavlinkProtocol, &MAVLinkProtocol::mavlinkMessageStatus);
     (void) connect(link.get(), &LinkInterface::bytesSent, _mavlinkProtocol, &MAVLinkProtocol::logSentBytes);
     (void) connect(link.get(), &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
 
@@ -175,6 +190,8 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr &config)
         return false;
     }
 
+    _mavlinkProtocol->updateForwardingLinks();
+
     return true;
 }
 
@@ -219,7 +236,9 @@ void LinkManager::_linkDisconnected()
     }
 
     (void) disconnect(link, &LinkInterface::communicationError, _app, &QGCApplication::criticalMessageBoxOnMainThread);
-    (void) disconnect(link, &LinkInterface::bytesReceived, _mavlinkProtocol, &MAVLinkProtocol::receiveBytes);
+    (void) disconnect(link, &LinkInterface::bytesReceived, link->_mavlinkParser, &MAVLinkParser::parseBytes);
+    (void) disconnect(link->_mavlinkParser, &MAVLinkParser::messagesReceived, _mavlinkProtocol, &MAVLinkProtocol::receiveMessages);
+    (void) disconnect(link->_mavlinkParser, &MAVLinkParser::messageStatus, _mavlinkProtocol, &MAVLinkProtocol::mavlinkMessageStatus);
     (void) disconnect(link, &LinkInterface::bytesSent, _mavlinkProtocol, &MAVLinkProtocol::logSentBytes);
     (void) disconnect(link, &LinkInterface::disconnected, this, &LinkManager::_linkDisconnected);
 
@@ -229,11 +248,20 @@ void LinkManager::_linkDisconnected()
         if (it->get() == link) {
             qCDebug(LinkManagerLog) << "LinkManager::_linkDisconnected" << it->get()->linkConfiguration()->name() << it->use_count();
             (void) _rgLinks.erase(it);
+            _mavlinkProtocol->updateForwardingLinks();
             return;
         }
     }
 }
 
+void LinkManager::_linkWriteLatencyChanged()
+{
+    const int latencyMSecs = _toolbox->settingsManager()->appSettings()->linkWriteLatency()->rawValue().toInt();
+    for (SharedLinkInterfacePtr &link: _rgLinks) {
+        link->setWriteLatencyMSecs(latencyMSecs);
+    }
+}
+
 SharedLinkInterfacePtr LinkManager::sharedLinkInterfacePointerForLink(const LinkInterface *link)
 {
     for (SharedLinkInterfacePtr &sharedLink: _rgLinks) {
@@ -610,6 +638,7 @@ void LinkManager::createMavlinkForwardingSupportLink()
     _createDynamicForwardLink(_mavlinkForwardingSupportLinkName, hostName);
     _mavlinkSupportForwardingEnabled = true;
     emit mavlinkSupportForwardingEnabledChanged();
+    _mavlinkProtocol->updateForwardingLinks();
 }
 
 void LinkManager::_removeConfiguration(const LinkConfiguration *config)
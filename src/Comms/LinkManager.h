@@ -127,6 +127,7 @@ signals:
 
 private slots:
     void _linkDisconnected();
+    void _linkWriteLatencyChanged();
 
 private:
     QmlObjectListModel *_qmlLinkConfigurations();
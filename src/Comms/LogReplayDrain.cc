@@ -0,0 +1,232 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogReplayDrain.h"
+#include "LogReplayLink.h"
+#include "LinkManager.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "QGCLoggingCategory.h"
+#include "Vehicle.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTimer>
+
+QGC_LOGGING_CATEGORY(LogReplayDrainLog, "LogReplayDrainLog")
+
+LogReplayDrain::LogReplayDrain(const QStringList& logFiles, const QString& outputDir, const QStringList& factPaths, double sampleRateHz, QObject* parent)
+    : QObject               (parent)
+    , _logFiles             (logFiles)
+    , _outputDir            (outputDir)
+    , _factPaths            (factPaths)
+    , _sampleIntervalUSecs  (static_cast<quint64>(1000000.0 / (sampleRateHz > 0 ? sampleRateHz : defaultSampleRateHz)))
+{
+
+}
+
+QStringList LogReplayDrain::logFiles(const QString& path)
+{
+    const QFileInfo pathInfo(path);
+    if (!pathInfo.isDir()) {
+        return pathInfo.exists() ? QStringList(pathInfo.absoluteFilePath()) : QStringList();
+    }
+
+    QStringList logFiles;
+    const QDir dir(path);
+    for (const QString& fileName: dir.entryList(QStringList(QStringLiteral("*.tlog")), QDir::Files, QDir::Name)) {
+        logFiles.append(dir.absoluteFilePath(fileName));
+    }
+    return logFiles;
+}
+
+void LogReplayDrain::start(void)
+{
+    (void) connect(qgcApp()->toolbox()->multiVehicleManager(), &MultiVehicleManager::vehicleAdded, this, &LogReplayDrain::_vehicleAdded);
+
+    QTimer::singleShot(0, this, &LogReplayDrain::_startNextLog);
+}
+
+void LogReplayDrain::_startNextLog(void)
+{
+    if (_nextLogIndex >= _logFiles.count()) {
+        qCInfo(LogReplayDrainLog) << "Processed" << _logFiles.count() << "logs," << _failedLogs << "failed";
+        emit finished(_failedLogs ? 1 : 0);
+        return;
+    }
+
+    // The vehicle from the previous log goes away asynchronously after its link is removed
+    if (qgcApp()->toolbox()->multiVehicleManager()->vehicles()->count() != 0) {
+        QTimer::singleShot(100, this, &LogReplayDrain::_startNextLog);
+        return;
+    }
+
+    const QFileInfo logFileInfo(_logFiles[_nextLogIndex++]);
+    const QDir outputDir(_outputDir.isEmpty() ? logFileInfo.absolutePath() : _outputDir);
+    _csvFile.setFileName(outputDir.filePath(logFileInfo.completeBaseName() + QStringLiteral(".csv")));
+    if (!_csvFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qCWarning(LogReplayDrainLog) << "Unable to create" << _csvFile.fileName() << _csvFile.errorString();
+        _failedLogs++;
+        QTimer::singleShot(0, this, &LogReplayDrain::_startNextLog);
+        return;
+    }
+    _csvStream.setDevice(&_csvFile);
+
+    qCInfo(LogReplayDrainLog) << "Replaying" << logFileInfo.absoluteFilePath();
+
+    LogReplayLinkConfiguration* const linkConfig = new LogReplayLinkConfiguration(logFileInfo.fileName());
+    linkConfig->setLogFilename(logFileInfo.absoluteFilePath());
+    linkConfig->setDynamic(true);
+    linkConfig->setDrain(true);
+    linkConfig->setDrainSliceUSecs(_sampleIntervalUSecs);
+
+    LinkManager* const linkManager = qgcApp()->toolbox()->linkManager();
+    SharedLinkConfigurationPtr sharedConfig = linkManager->addConfiguration(linkConfig);
+    _linkConfig = linkConfig;
+    if (!linkManager->createConnectedLink(sharedConfig)) {
+        qCWarning(LogReplayDrainLog) << "Unable to start replay of" << logFileInfo.absoluteFilePath();
+        _finishLog(false);
+        return;
+    }
+
+    _link = qobject_cast<LogReplayLink*>(sharedConfig->link());
+    (void) connect(_link, &LogReplayLink::drainSliceComplete,  this, &LogReplayDrain::_sliceComplete);
+    (void) connect(_link, &LogReplayLink::playbackAtEnd,       this, &LogReplayDrain::_playbackAtEnd);
+    (void) connect(_link, &LogReplayLink::communicationError,  this, &LogReplayDrain::_communicationError);
+
+    _nextSampleUSecs = 0;
+    _firstSampleUSecs = 0;
+    _sampleCount = 0;
+    _logTimer.start();
+
+    // Drain mode links wait for play, so nothing can be emitted before we are connected
+    _link->play();
+}
+
+void LogReplayDrain::_vehicleAdded(Vehicle* vehicle)
+{
+    if (!_link || _vehicle) {
+        return;
+    }
+
+    _vehicle = vehicle;
+    _resolveFacts();
+
+    _csvStream << "time_usec";
+    for (const QPair<QString, Fact*>& fact: _facts) {
+        _csvStream << ',' << fact.first;
+    }
+    _csvStream << '\n';
+}
+
+void LogReplayDrain::_resolveFacts(void)
+{
+    _facts.clear();
+
+    if (_factPaths.isEmpty()) {
+        _addFactGroup(_vehicle, QString());
+        return;
+    }
+
+    for (const QString& factPath: _factPaths) {
+        const int separator = factPath.lastIndexOf(QLatin1Char('.'));
+        FactGroup* factGroup = _vehicle;
+        if (separator != -1) {
+            const QString groupName = factPath.left(separator);
+            factGroup = _vehicle->factGroups().value(groupName);
+        }
+        const QString factName = factPath.mid(separator + 1);
+        if (!factGroup || !factGroup->factExists(factName)) {
+            qCWarning(LogReplayDrainLog) << "Unknown fact" << factPath;
+            continue;
+        }
+        _facts.append(qMakePair(factPath, factGroup->getFact(factName)));
+    }
+}
+
+void LogReplayDrain::_addFactGroup(FactGroup* factGroup, const QString& prefix)
+{
+    for (const QString& factName: factGroup->factNames()) {
+        _facts.append(qMakePair(prefix + factName, factGroup->getFact(factName)));
+    }
+    for (auto it = factGroup->factGroups().cbegin(); it != factGroup->factGroups().cend(); ++it) {
+        _addFactGroup(it.value(), prefix + it.key() + QLatin1Char('.'));
+    }
+}
+
+void LogReplayDrain::_sliceComplete(quint64 logTimeUSecs)
+{
+    if (_vehicle && (logTimeUSecs >= _nextSampleUSecs)) {
+        _writeSample(logTimeUSecs);
+        _nextSampleUSecs = logTimeUSecs + _sampleIntervalUSecs;
+    }
+
+    LogReplayLink* const link = qobject_cast<LogReplayLink*>(sender());
+    if (link) {
+        link->drainSliceProcessed();
+    }
+}
+
+void LogReplayDrain::_writeSample(quint64 logTimeUSecs)
+{
+    if (_sampleCount++ == 0) {
+        _firstSampleUSecs = logTimeUSecs;
+    }
+
+    _csvStream << logTimeUSecs;
+    for (const QPair<QString, Fact*>& fact: _facts) {
+        _csvStream << ',' << fact.second->rawValue().toString();
+    }
+    _csvStream << '\n';
+}
+
+void LogReplayDrain::_playbackAtEnd(void)
+{
+    _finishLog(true);
+}
+
+void LogReplayDrain::_communicationError(const QString& title, const QString& error)
+{
+    qCWarning(LogReplayDrainLog) << title << error;
+    _finishLog(false);
+}
+
+void LogReplayDrain::_finishLog(bool success)
+{
+    if (_link) {
+        (void) disconnect(_link, nullptr, this, nullptr);
+    }
+    if (_linkConfig) {
+        qgcApp()->toolbox()->linkManager()->removeConfiguration(_linkConfig);
+        _linkConfig = nullptr;
+    }
+
+    _csvStream.flush();
+    _csvStream.setDevice(nullptr);
+    _csvFile.close();
+
+    if (success && !_vehicle) {
+        qCWarning(LogReplayDrainLog) << "No vehicle found in log";
+        success = false;
+    }
+    if (success) {
+        const double logSecs = (_sampleCount > 1) ? ((_nextSampleUSecs - _sampleIntervalUSecs - _firstSampleUSecs) / 1e6) : 0;
+        const double elapsedSecs = _logTimer.elapsed() / 1000.0;
+        qCInfo(LogReplayDrainLog) << "Wrote" << _sampleCount << "samples of" << _facts.count() << "facts to" << _csvFile.fileName()
+                                  << QStringLiteral("(%1s of log in %2s)").arg(logSecs, 0, 'f', 1).arg(elapsedSecs, 0, 'f', 1);
+    } else {
+        _failedLogs++;
+    }
+
+    _link = nullptr;
+    _vehicle = nullptr;
+    _facts.clear();
+
+    QTimer::singleShot(0, this, &LogReplayDrain::_startNextLog);
+}
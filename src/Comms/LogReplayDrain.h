@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+
+class Fact;
+class FactGroup;
+class LinkConfiguration;
+class LogReplayLink;
+class Vehicle;
+
+Q_DECLARE_LOGGING_CATEGORY(LogReplayDrainLog)
+
+/// Headless batch replay of telemetry logs. Each log is played through a LogReplayLink in drain mode, so it goes
+/// through the normal MAVLinkProtocol and Vehicle handling as fast as it can be processed. The selected vehicle Facts
+/// are sampled against log time and written to a CSV file per log. Started by the --replay-drain command line option.
+class LogReplayDrain : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @param logFiles     Logs to process, in order
+    /// @param outputDir    Directory for the CSV files, empty to write each one next to its log
+    /// @param factPaths    Facts to export: "name" for vehicle facts, "group.name" for fact group facts, empty for all
+    /// @param sampleRateHz Samples per second of log time
+    LogReplayDrain(const QStringList& logFiles, const QString& outputDir, const QStringList& factPaths, double sampleRateHz, QObject* parent = nullptr);
+
+    /// Starts processing once the event loop is running
+    void start(void);
+
+    /// @return The telemetry logs for @a path, which is either a single log or a directory of them
+    static QStringList logFiles(const QString& path);
+
+    static constexpr double defaultSampleRateHz = 10.0;
+
+signals:
+    /// All logs have been processed. @a exitCode is non-zero if any of them failed.
+    void finished(int exitCode);
+
+private slots:
+    void _startNextLog      (void);
+    void _vehicleAdded      (Vehicle* vehicle);
+    void _sliceComplete     (quint64 logTimeUSecs);
+    void _playbackAtEnd     (void);
+    void _communicationError(const QString& title, const QString& error);
+
+private:
+    void _resolveFacts  (void);
+    void _addFactGroup  (FactGroup* factGroup, const QString& prefix);
+    void _writeSample   (quint64 logTimeUSecs);
+    void _finishLog     (bool success);
+
+    QStringList     _logFiles;
+    QString         _outputDir;
+    QStringList     _factPaths;
+    quint64         _sampleIntervalUSecs;
+
+    int                     _nextLogIndex = 0;
+    int                     _failedLogs = 0;
+    LinkConfiguration*      _linkConfig = nullptr;
+    QPointer<LogReplayLink> _link;
+    QPointer<Vehicle>       _vehicle;
+
+    QFile                           _csvFile;
+    QTextStream                     _csvStream;
+    QList<QPair<QString, Fact*>>    _facts;             ///< Column name, Fact
+    quint64                         _nextSampleUSecs = 0;
+    quint64                         _firstSampleUSecs = 0;
+    int                             _sampleCount = 0;
+    QElapsedTimer                   _logTimer;
+};
@@ -18,7 +18,6 @@
 #include "MAVLinkLib.h"
 
 #include <QtCore/QFileInfo>
-#include <QtCore/QtEndian>
 #include <QtTest/QSignalSpy>
 
 LogReplayLinkConfiguration::LogReplayLinkConfiguration(const QString& name)
@@ -31,6 +30,8 @@ LogReplayLinkConfiguration::LogReplayLinkConfiguration(const LogReplayLinkConfig
     : LinkConfiguration(copy)
 {
     _logFilename = copy->logFilename();
+    _drain = copy->drain();
+    _drainSliceUSecs = copy->drainSliceUSecs();
 }
 
 void LogReplayLinkConfiguration::copyFrom(const LinkConfiguration *source)
@@ -39,6 +40,8 @@ void LogReplayLinkConfiguration::copyFrom(const LinkConfiguration *source)
     const LogReplayLinkConfiguration* ssource = qobject_cast<const LogReplayLinkConfiguration*>(source);
     if (ssource) {
         _logFilename = ssource->logFilename();
+        _drain = ssource->drain();
+        _drainSliceUSecs = ssource->drainSliceUSecs();
     } else {
         qWarning() << "Internal error";
     }
@@ -68,8 +71,9 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr& config)
     : LinkInterface              (config)
     , _logReplayConfig           (qobject_cast<LogReplayLinkConfiguration*>(config.get()))
     , _connected                 (false)
-    , _mavlinkChannel            (0)
     , _logCurrentTimeUSecs       (0)
+    , _logPosition               (0)
+    , _logAtEnd                  (false)
     , _logStartTimeUSecs         (0)
     , _logEndTimeUSecs           (0)
     , _logDurationUSecs          (0)
@@ -78,12 +82,15 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr& config)
     , _playbackStartLogTimeUSecs (0)
     , _mavlink                   (nullptr)
     , _logFileSize               (0)
+    , _readBufferFileOffset      (0)
+    , _readBufferLength          (0)
 {
     if (!_logReplayConfig) {
         qWarning() << "Internal error";
     }
 
     _errorTitle = tr("Log Replay Error");
+    _readBuffer.resize(_readBlockSize);
     
     _readTickTimer.moveToThread(this);
     
@@ -136,8 +143,10 @@ void LogReplayLink::run(void)
     _connected = true;
     emit connected();
     
-    // Start playback
-    _play();
+    // Start playback, drain mode waits for the receiver to connect up and call play
+    if (!_logReplayConfig->drain()) {
+        _play();
+    }
 
     // Run normal event loop until exit
     exec();
@@ -157,106 +166,45 @@ void LogReplayLink::_writeBytes(const QByteArray &bytes)
     Q_UNUSED(bytes);
 }
 
-/// Parses a BigEndian quint64 timestamp
-/// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_parseTimestamp(const QByteArray& bytes)
-{
-    quint64 timestamp = qFromBigEndian(*((quint64*)(bytes.constData())));
-    quint64 currentTimestamp = ((quint64)QDateTime::currentMSecsSinceEpoch()) * 1000;
-    
-    // Now if the parsed timestamp is in the future, it must be an old file where the timestamp was stored as
-    // little endian, so switch it.
-    if (timestamp > currentTimestamp) {
-        timestamp = qbswap(timestamp);
-    }
-    
-    return timestamp;
-}
-
-/// Reads the next mavlink message from the log
-///     @param bytes[output] Bytes for mavlink message
-/// @return Unix timestamp in microseconds UTC for NEXT mavlink message or 0 if no message found
-quint64 LogReplayLink::_readNextMavlinkMessage(QByteArray& bytes)
-{
-    char                nextByte;
-    mavlink_status_t    status;
-
-    bytes.clear();
-
-    while (_logFile.getChar(&nextByte)) { // Loop over every byte
-        mavlink_message_t message;
-        bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, &message, &status);
-
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            // This is the possible beginning of a mavlink message, clear any partial bytes
-            bytes.clear();
+/// Reads the record at _logPosition, skipping forward over any garbage. The log is read in large blocks and the
+/// records are framed straight out of the block, so there is no per byte file access.
+///     @param record[output] Record found, offsets are file offsets
+/// @return false if there are no more records in the log
+bool LogReplayLink::_readRecord(TLogIndex::Record& record)
+{
+    while (true) {
+        const qint64 bufferPos = _logPosition - _readBufferFileOffset;
+        const bool bufferAtEnd = (_readBufferFileOffset + _readBufferLength) >= static_cast<qint64>(_logFileSize);
+        if ((bufferPos < 0) || (bufferPos >= _readBufferLength) ||
+                (!bufferAtEnd && ((_readBufferLength - bufferPos) < (TLogIndex::cbTimestamp + MAVLINK_MAX_PACKET_LEN)))) {
+            // Refill so the buffer starts at the current record
+            if (!_logFile.seek(_logPosition)) {
+                return false;
+            }
+            _readBufferFileOffset = _logPosition;
+            _readBufferLength = qMax<qint64>(0, _logFile.read(_readBuffer.data(), _readBuffer.size()));
+            if (_readBufferLength == 0) {
+                return false;
+            }
+            continue;
         }
-        bytes.append(nextByte);
 
-        if (messageFound) {
-            // Return the timestamp for the next message
-            QByteArray rawTime = _logFile.read(cbTimestamp);
-            return _parseTimestamp(rawTime);
+        const uchar* const data = reinterpret_cast<const uchar*>(_readBuffer.constData());
+        if (TLogIndex::nextRecord(data, _readBufferLength, bufferPos, record)) {
+            record.offset += _readBufferFileOffset;
+            record.frameOffset += _readBufferFileOffset;
+            _logPosition = record.offset;
+            return true;
         }
-    }
 
-    return 0;
-}
-
-/// Seeks to the beginning of the next successfully parsed mavlink message in the log file.
-///     @param nextMsg[output] Parsed next message that was found
-/// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_seekToNextMavlinkMessage(mavlink_message_t* nextMsg)
-{
-    char                nextByte;
-    mavlink_status_t    status;
-    qint64              messageStartPos = -1;
-
-    mavlink_reset_channel_status(_mavlinkChannel);
-
-    while (_logFile.getChar(&nextByte)) {
-        bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, nextMsg, &status);
-
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            // This is the possible beginning of a mavlink message
-            messageStartPos = _logFile.pos() - 1;
-        }
-        
-        // If we've found a message, jump back to the start of the message, grab the timestamp,
-        // and go back to the end of this file.
-        if (messageFound && messageStartPos != -1) {
-            _logFile.seek(messageStartPos - cbTimestamp);
-            QByteArray rawTime = _logFile.read(cbTimestamp);
-            return _parseTimestamp(rawTime);
+        if (bufferAtEnd) {
+            _logPosition = _logFileSize;
+            return false;
         }
-    }
-    
-    return 0;
-}
-
-quint64 LogReplayLink::_findLastTimestamp(void)
-{
-    char                nextByte;
-    mavlink_status_t    status;
-    quint64             lastTimestamp = 0;
-    mavlink_message_t   msg;
 
-    // We read through the entire file looking for the last good timestamp. This can be somewhat slow, but trying to work from the
-    // end of the file can be way slower due to all the seeking back and forth required. So instead we take the simple reliable approach.
-
-    _logFile.reset();
-    mavlink_reset_channel_status(_mavlinkChannel);
-
-    while (_logFile.bytesAvailable() > cbTimestamp) {
-        lastTimestamp = _parseTimestamp(_logFile.read(cbTimestamp));
-
-        bool endOfMessage = false;
-        while (!endOfMessage && _logFile.getChar(&nextByte)) {
-            endOfMessage = mavlink_parse_char(_mavlinkChannel, nextByte, &msg, &status);
-        }
+        // Nothing in this block, continue from the part of the block which could still hold the start of a record
+        _logPosition = _readBufferFileOffset + qMax(bufferPos + 1, _readBufferLength - (TLogIndex::cbTimestamp + MAVLINK_MAX_PACKET_LEN));
     }
-
-    return lastTimestamp;
 }
 
 bool LogReplayLink::_loadLogFile(void)
@@ -280,9 +228,15 @@ bool LogReplayLink::_loadLogFile(void)
     }
     logFileInfo.setFile(logFilename);
     _logFileSize = logFileInfo.size();
-    
-    startTimeUSecs = _parseTimestamp(_logFile.read(cbTimestamp));
-    endTimeUSecs = _findLastTimestamp();
+
+    // The index gives us the start and end times without reading through the whole log, and lets movePlayhead
+    // jump straight to a timestamp.
+    if (!_index.load(_logFile)) {
+        errorMsg = tr("The log file '%1' is corrupt or empty.").arg(logFilename);
+        goto Error;
+    }
+    startTimeUSecs = _index.startTimeUSecs();
+    endTimeUSecs = _index.endTimeUSecs();
 
     if (endTimeUSecs <= startTimeUSecs) {
         errorMsg = tr("The log file '%1' is corrupt or empty.").arg(logFilename);
@@ -295,8 +249,11 @@ bool LogReplayLink::_loadLogFile(void)
     _logDurationUSecs = endTimeUSecs - startTimeUSecs;
     _logCurrentTimeUSecs = startTimeUSecs;
 
-    // Reset our log file so when we go to read it for the first time, we start at the beginning.
-    _logFile.reset();
+    // Start reading from the first record in the log
+    _logPosition = _index.entries().first().offset;
+    _logAtEnd = false;
+    _readBufferFileOffset = 0;
+    _readBufferLength = 0;
 
     logDurationSecondsTotal = (_logDurationUSecs) / 1000000;
     
@@ -312,42 +269,64 @@ Error:
     return false;
 }
 
-/// This function will read the next available log entry. It will then start
-/// the _readTickTimer timer to read the new log entry at the appropriate time.
+/// This function will read the next available log entries. It will then start
+/// the _readTickTimer timer to read the new log entries at the appropriate time.
 /// It might not perfectly match the timing of the log file, but it will never
 /// induce a static drift into the log file replay.
 void LogReplayLink::_readNextLogEntry(void)
 {
-    QByteArray bytes;
+    if (_logReplayConfig->drain()) {
+        _drainNextSlice();
+        return;
+    }
 
-    // Now parse MAVLink messages, grabbing their timestamps as we go. We stop once we
-    // have at least 3ms until the next one.
+    // All the messages which are due are sent as a single chunk, so the link thread parses them in one go and
+    // the rest of the application sees one batch per tick instead of one event per message.
+    QByteArray chunk;
+    chunk.reserve(_maxChunkBytes + MAVLINK_MAX_PACKET_LEN);
 
     // We track what the next execution time should be in milliseconds, which we use to set
-    // the next timer interrupt.
+    // the next timer interrupt. We stop once we have at least 3ms until the next message.
     int timeToNextExecutionMSecs = 0;
 
-    while (timeToNextExecutionMSecs < 3) {
-        // Read the next mavlink message from the log
-        qint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
-        emit bytesReceived(this, bytes);
-        emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
+    TLogIndex::Record record;
+    while (true) {
+        if (!_readRecord(record)) {
+            _logAtEnd = true;
+            break;
+        }
+        _logCurrentTimeUSecs = record.timeUSecs;
 
-        if (_logFile.atEnd()) {
-            _finishPlayback();
-            return;
+        // Calculate how long we should wait in real time until sending this message.
+        // We pace ourselves relative to the start time of playback to fix any drift (initially set in play())
+        const quint64 currentTimeMSecs =                    (quint64)QDateTime::currentMSecsSinceEpoch();
+        const quint64 desiredPlayheadMovementTimeMSecs =    ((_logCurrentTimeUSecs - _playbackStartLogTimeUSecs) / 1000) / _playbackSpeed;
+        const quint64 desiredCurrentTimeMSecs =             _playbackStartTimeMSecs + desiredPlayheadMovementTimeMSecs;
+
+        timeToNextExecutionMSecs = desiredCurrentTimeMSecs - currentTimeMSecs;
+        if (timeToNextExecutionMSecs >= 3) {
+            break;
         }
 
-        _logCurrentTimeUSecs = nextTimeUSecs;
+        if (chunk.size() >= _maxChunkBytes) {
+            // Let the event loop breathe at very high playback speeds, the rest goes out on the next tick
+            timeToNextExecutionMSecs = 0;
+            break;
+        }
 
-        // Calculate how long we should wait in real time until parsing this message.
-        // We pace ourselves relative to the start time of playback to fix any drift (initially set in play())
+        const qsizetype frameStart = record.frameOffset - _readBufferFileOffset;
+        chunk.append(_readBuffer.constData() + frameStart, record.frameLength);
+        _logPosition = record.endOffset();
+    }
 
-        quint64 currentTimeMSecs =                  (quint64)QDateTime::currentMSecsSinceEpoch();
-        quint64 desiredPlayheadMovementTimeMSecs =  ((_logCurrentTimeUSecs - _playbackStartLogTimeUSecs) / 1000) / _playbackSpeed;
-        quint64 desiredCurrentTimeMSecs =           _playbackStartTimeMSecs + desiredPlayheadMovementTimeMSecs;
+    if (!chunk.isEmpty()) {
+        emit bytesReceived(this, chunk);
+    }
+    emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
 
-        timeToNextExecutionMSecs = desiredCurrentTimeMSecs - currentTimeMSecs;
+    if (_logAtEnd) {
+        _finishPlayback();
+        return;
     }
 
     _signalCurrentLogTimeSecs();
@@ -356,6 +335,54 @@ void LogReplayLink::_readNextLogEntry(void)
     _readTickTimer.start(timeToNextExecutionMSecs);
 }
 
+/// Drain mode version of _readNextLogEntry. Sends the next slice of the log without any pacing, as long as the
+/// receiver is keeping up.
+void LogReplayLink::_drainNextSlice(void)
+{
+    if (_drainSlicesInFlight.loadAcquire() >= _maxDrainSlicesInFlight) {
+        _readTickTimer.start(1);
+        return;
+    }
+
+    QByteArray chunk;
+    chunk.reserve(_maxChunkBytes + MAVLINK_MAX_PACKET_LEN);
+
+    TLogIndex::Record record;
+    quint64 sliceEndUSecs = 0;
+    bool sliceStarted = false;
+    while (chunk.size() < _maxChunkBytes) {
+        if (!_readRecord(record)) {
+            _logAtEnd = true;
+            break;
+        }
+        if (!sliceStarted) {
+            sliceEndUSecs = record.timeUSecs + _logReplayConfig->drainSliceUSecs();
+            sliceStarted = true;
+        } else if (record.timeUSecs >= sliceEndUSecs) {
+            break;
+        }
+
+        const qsizetype frameStart = record.frameOffset - _readBufferFileOffset;
+        chunk.append(_readBuffer.constData() + frameStart, record.frameLength);
+        _logCurrentTimeUSecs = record.timeUSecs;
+        _logPosition = record.endOffset();
+    }
+
+    if (!chunk.isEmpty()) {
+        emit bytesReceived(this, chunk);
+        _drainSlicesInFlight.ref();
+        emit drainSliceComplete(_logCurrentTimeUSecs);
+    }
+    emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
+
+    if (_logAtEnd) {
+        _finishPlayback();
+        return;
+    }
+
+    _readTickTimer.start(0);
+}
+
 void LogReplayLink::_play(void)
 {
     qgcApp()->toolbox()->linkManager()->setConnectionsSuspended(tr("Connect not allowed during Flight Data replay."));
@@ -364,7 +391,7 @@ void LogReplayLink::_play(void)
 #endif
     
     // Make sure we aren't at the end of the file, if we are, reset to the beginning and play from there.
-    if (_logFile.atEnd()) {
+    if (_logAtEnd) {
         _resetPlaybackToBeginning();
     }
     
@@ -389,9 +416,10 @@ void LogReplayLink::_pause(void)
 
 void LogReplayLink::_resetPlaybackToBeginning(void)
 {
-    if (_logFile.isOpen()) {
-        _logFile.reset();
+    if (_index.isValid()) {
+        _logPosition = _index.entries().first().offset;
     }
+    _logAtEnd = false;
     
     // And since we haven't starting playback, clear the time of initial playback and the current timestamp.
     _playbackStartTimeMSecs = 0;
@@ -417,45 +445,22 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
         percentComplete = 100;
     }
     
-    qreal percentCompleteMult = percentComplete / 100.0;
-    
-    // But if we have a timestamped MAVLink log, then actually aim to hit that percentage in terms of
-    // time through the file.
-    qint64 newFilePos = (qint64)(percentCompleteMult * (qreal)_logFile.size());
-
-    // Now seek to the appropriate position, failing gracefully if we can't.
-    if (!_logFile.seek(newFilePos)) {
-        _replayError(tr("Unable to seek to new position"));
-        return;
-    }
-
-    // But we do align to the next MAVLink message for consistency.
-    mavlink_message_t dummy;
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
-
-    // Now calculate the current file location based on time.
-    qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
-
-    // Calculate the effective baud rate of the file in bytes/s.
-    qreal baudRate = _logFile.size() / (qreal)_logDurationUSecs / 1e6;
-
-    // And the desired time is:
-    qreal desiredTimeUSecs = percentCompleteMult * _logDurationUSecs;
-
-    // And now jump the necessary number of bytes in the proper direction
-    qint64 offset = (newRelativeTimeUSecs - desiredTimeUSecs) * baudRate;
-    if (!_logFile.seek(_logFile.pos() + offset)) {
+    // Look up the first message at or after the requested time, the index gets us within a small read of it
+    const quint64 desiredTimeUSecs = _logStartTimeUSecs + static_cast<quint64>((percentComplete / 100.0) * _logDurationUSecs);
+    TLogIndex::Record record;
+    if (!_index.findRecord(_logFile, desiredTimeUSecs, record)) {
         _replayError(tr("Unable to seek to new position"));
         return;
     }
 
-    // And scan until we reach the start of a MAVLink message. We make sure to record this timestamp for
-    // smooth jumping around the file.
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
+    // Playback continues from this record, the read buffer refills itself if the record isn't in it
+    _logPosition = record.offset;
+    _logAtEnd = false;
+    _logCurrentTimeUSecs = record.timeUSecs;
     _signalCurrentLogTimeSecs();
 
     // Now update the UI with our actual final position.
-    newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
+    const qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
     percentComplete = (newRelativeTimeUSecs / _logDurationUSecs) * 100;
     emit playbackPercentCompleteChanged(percentComplete);
 }
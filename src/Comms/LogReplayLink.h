@@ -11,15 +11,15 @@
 
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
+#include "TLogIndex.h"
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QTimer>
 #include <QtCore/QFile>
 
 class LinkManager;
 class MAVLinkProtocol;
 
-typedef struct __mavlink_message mavlink_message_t;
-
 class LogReplayLinkConfiguration : public LinkConfiguration
 {
     Q_OBJECT
@@ -35,6 +35,14 @@ public:
 
     QString logFilenameShort(void);
 
+    /// Drain mode plays the log as fast as it can be processed instead of pacing it to wall clock time. Playback
+    /// doesn't start on connect, call LogReplayLink::play once connected to its signals. Not persisted.
+    bool    drain           (void) const { return _drain; }
+    void    setDrain        (bool drain) { _drain = drain; }
+    /// Drain mode delivers the log in slices of this much log time, see LogReplayLink::drainSliceComplete
+    quint64 drainSliceUSecs (void) const { return _drainSliceUSecs; }
+    void    setDrainSliceUSecs(quint64 drainSliceUSecs) { _drainSliceUSecs = drainSliceUSecs; }
+
     // Virtuals from LinkConfiguration
     LinkType    type                    (void) const override                                         { return LinkConfiguration::TypeLogReplay; }
     void        copyFrom                (const LinkConfiguration* source) override;
@@ -49,6 +57,8 @@ signals:
 private:
     static constexpr const char*  _logFilenameKey = "logFilename";
     QString             _logFilename;
+    bool                _drain = false;
+    quint64             _drainSliceUSecs = 100000;
 };
 
 /// Pseudo link that reads a telemetry log and feeds it into the application.
@@ -67,6 +77,9 @@ public:
     void pause          (void) { emit _pauseOnThread(); }
     void movePlayhead   (qreal percentComplete);
 
+    /// Drain mode: Signals that the receiver has handled a slice from drainSliceComplete. Thread safe.
+    void drainSliceProcessed(void) { _drainSlicesInFlight.deref(); }
+
     // overrides from LinkInterface
     bool isConnected(void) const override { return _connected; }
     bool isLogReplay(void) override { return true; }
@@ -84,6 +97,11 @@ signals:
     void playbackPercentCompleteChanged (qreal percentComplete);
     void currentLogTimeSecs             (int secs);
 
+    /// Drain mode: All messages up to and including @a logTimeUSecs have been emitted through bytesReceived. Emitted
+    /// from the link thread, so it arrives after those messages on a queued connection. Receiver must call
+    /// drainSliceProcessed once handled, that keeps the link from running arbitrarily far ahead of the receiver.
+    void drainSliceComplete             (quint64 logTimeUSecs);
+
     // Internal signals
     void _playOnThread              (void);
     void _pauseOnThread             (void);
@@ -104,10 +122,8 @@ private:
     bool _connect(void) override;
 
     void    _replayError                (const QString& errorMsg);
-    quint64 _parseTimestamp             (const QByteArray& bytes);
-    quint64 _seekToNextMavlinkMessage   (mavlink_message_t* nextMsg);
-    quint64 _findLastTimestamp          (void);
-    quint64 _readNextMavlinkMessage     (QByteArray& bytes);
+    bool    _readRecord                 (TLogIndex::Record& record);
+    void    _drainNextSlice             (void);
     bool    _loadLogFile                (void);
     void    _finishPlayback             (void);
     void    _resetPlaybackToBeginning   (void);
@@ -119,12 +135,13 @@ private:
     LogReplayLinkConfiguration* _logReplayConfig;
 
     bool    _connected;
-    uint8_t _mavlinkChannel;
     QTimer  _readTickTimer;      ///< Timer which signals a read of next log record
 
     QString _errorTitle; ///< Title for communicatorError signals
 
     quint64 _logCurrentTimeUSecs;   ///< The timestamp of the next message in the log file.
+    qint64  _logPosition;           ///< File offset of the next record to play
+    bool    _logAtEnd;              ///< No more records after _logPosition
     quint64 _logStartTimeUSecs;     ///< The first timestamp in the current log file.
     quint64 _logEndTimeUSecs;       ///< The last timestamp in the current log file.
     quint64 _logDurationUSecs;
@@ -136,8 +153,17 @@ private:
     MAVLinkProtocol*    _mavlink;
     QFile               _logFile;
     quint64             _logFileSize;
+    TLogIndex           _index;
+
+    QByteArray          _readBuffer;            ///< Block of the log file which records are framed from
+    qint64              _readBufferFileOffset;  ///< File offset of the first byte in _readBuffer
+    qint64              _readBufferLength;      ///< Valid bytes in _readBuffer
+
+    static constexpr qint64 _readBlockSize = 1024 * 1024;
+    static constexpr qsizetype _maxChunkBytes = 64 * 1024;    ///< Upper bound on bytes emitted per timer tick
 
-    static const int cbTimestamp = sizeof(quint64);
+    QAtomicInt          _drainSlicesInFlight;   ///< Slices emitted but not yet processed by the receiver
+    static constexpr int _maxDrainSlicesInFlight = 4;
 };
 
 class LogReplayLinkController : public QObject
@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkForwardRoute.h"
+
+#include <QtCore/QStringList>
+
+bool MAVLinkForwardRoute::setSysIdFilter(const QString& sysIds)
+{
+    QSet<uint32_t> ids;
+    if (!_parseIdList(sysIds, 255, ids)) {
+        return false;
+    }
+
+    _allSysIds = ids.isEmpty();
+    _sysIds.reset();
+    for (const uint32_t id: ids) {
+        _sysIds.set(id);
+    }
+    return true;
+}
+
+bool MAVLinkForwardRoute::setMsgIdFilter(const QString& msgIds)
+{
+    QSet<uint32_t> ids;
+    if (!_parseIdList(msgIds, 0xFFFFFF, ids)) {
+        return false;
+    }
+
+    _allMsgIds = ids.isEmpty();
+    _msgIds = ids;
+    return true;
+}
+
+int MAVLinkForwardRoute::frameLength(const mavlink_message_t& message)
+{
+    if (message.magic == MAVLINK_STX_MAVLINK1) {
+        return MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + message.len + MAVLINK_NUM_CHECKSUM_BYTES;
+    }
+
+    int length = MAVLINK_CORE_HEADER_LEN + 1 + message.len + MAVLINK_NUM_CHECKSUM_BYTES;
+    if (message.incompat_flags & MAVLINK_IFLAG_SIGNED) {
+        length += MAVLINK_SIGNATURE_BLOCK_LEN;
+    }
+    return length;
+}
+
+bool MAVLinkForwardRoute::_parseIdList(const QString& ids, uint32_t maxId, QSet<uint32_t>& result)
+{
+    result.clear();
+
+    const QStringList items = ids.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (const QString& item: items) {
+        const QStringList range = item.trimmed().split(QLatin1Char('-'));
+        if (range.count() > 2) {
+            return false;
+        }
+
+        bool firstOk = false;
+        bool lastOk = false;
+        const uint first = range.first().trimmed().toUInt(&firstOk);
+        const uint last = (range.count() == 2) ? range.last().trimmed().toUInt(&lastOk) : first;
+        if (range.count() == 1) {
+            lastOk = firstOk;
+        }
+        if (!firstOk || !lastOk || (first > last) || (last > maxId)) {
+            return false;
+        }
+        if ((last - first) > _maxRangeLength) {
+            // Almost certainly a typo, and expanding it would stall the main thread
+            return false;
+        }
+
+        for (uint id = first; id <= last; id++) {
+            result.insert(id);
+        }
+    }
+
+    return true;
+}
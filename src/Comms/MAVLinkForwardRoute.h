@@ -0,0 +1,60 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "LinkInterface.h"
+#include "MAVLinkLib.h"
+
+#include <QtCore/QSet>
+#include <QtCore/QString>
+
+#include <bitset>
+
+/// A destination for forwarded MAVLink traffic along with the filters which pick the messages sent there
+class MAVLinkForwardRoute
+{
+public:
+    MAVLinkForwardRoute() = default;
+    explicit MAVLinkForwardRoute(const WeakLinkInterfacePtr& link) : _link(link) {}
+
+    WeakLinkInterfacePtr link() const { return _link; }
+
+    /// Sets the system ids to forward from a comma separated list such as "1,2,10-20". Empty forwards all systems.
+    /// @return false if @a sysIds can't be parsed, the filter is left unchanged
+    bool setSysIdFilter(const QString& sysIds);
+
+    /// Sets the message ids to forward from a comma separated list such as "0,30-33,253". Empty forwards all messages.
+    /// @return false if @a msgIds can't be parsed, the filter is left unchanged
+    bool setMsgIdFilter(const QString& msgIds);
+
+    /// Called for every forwarded message, so kept inline and cheap
+    bool accepts(const mavlink_message_t& message) const
+    {
+        // Signing setup carries the secret key, it never leaves this link
+        if (message.msgid == MAVLINK_MSG_ID_SETUP_SIGNING) {
+            return false;
+        }
+        return (_allSysIds || _sysIds.test(message.sysid)) && (_allMsgIds || _msgIds.contains(message.msgid));
+    }
+
+    /// Wire length of a message exactly as it was received, including header, checksum and signature
+    static int frameLength(const mavlink_message_t& message);
+
+private:
+    static bool _parseIdList(const QString& ids, uint32_t maxId, QSet<uint32_t>& result);
+
+    static constexpr uint32_t _maxRangeLength = 0xFFFF;
+
+    WeakLinkInterfacePtr    _link;
+    bool                    _allSysIds = true;
+    std::bitset<256>        _sysIds;
+    bool                    _allMsgIds = true;
+    QSet<uint32_t>          _msgIds;
+};
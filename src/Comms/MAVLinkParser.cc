@@ -0,0 +1,273 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkParser.h"
+#include "LinkInterface.h"
+#include "MAVLinkProtocol.h"
+#include "MAVLinkSigning.h"
+#include "QGCLoggingCategory.h"
+
+QGC_LOGGING_CATEGORY(MAVLinkParserLog, "MAVLinkParserLog")
+
+mavlink_signing_streams_t MAVLinkParser::_signingStreams = {};
+QMutex MAVLinkParser::_signingMutex;
+
+namespace {
+
+/// @return true: signing is enabled on @a channel, @a signing holds a copy of its setup
+bool _channelSigning(uint8_t channel, mavlink_signing_t& signing)
+{
+    const mavlink_status_t* const channelStatus = mavlink_get_channel_status(channel);
+    if (!channelStatus || !channelStatus->signing) {
+        signing = {};
+        return false;
+    }
+
+    signing = *channelStatus->signing;
+    return true;
+}
+
+} // namespace
+
+MAVLinkParser::MAVLinkParser(LinkInterface* link, MAVLinkProtocol* protocol)
+    : QObject()
+    , _link(link)
+    , _protocol(protocol)
+    , _mavlinkChannel(link->mavlinkChannel())
+{
+    _reset();
+
+    mavlink_signing_t signing;
+    const bool enabled = _channelSigning(_mavlinkChannel, signing);
+    _setSigning(enabled, signing);
+}
+
+void MAVLinkParser::reset()
+{
+    (void) QMetaObject::invokeMethod(this, &MAVLinkParser::_reset, Qt::QueuedConnection);
+}
+
+void MAVLinkParser::_reset()
+{
+    memset(_firstMessage, 1, sizeof(_firstMessage));
+    memset(_lastIndex, 0, sizeof(_lastIndex));
+    memset(&_status, 0, sizeof(_status));
+    memset(&_message, 0, sizeof(_message));
+    memset(&_rxMessage, 0, sizeof(_rxMessage));
+    _totalReceiveCounter = 0;
+    _totalLossCounter = 0;
+    _runningLossPercent = 0;
+
+    // Only the parse state is reset, signing stays as it was set up
+    mavlink_signing_t* const signing = _rxStatus.signing;
+    mavlink_signing_streams_t* const signingStreams = _rxStatus.signing_streams;
+    memset(&_rxStatus, 0, sizeof(_rxStatus));
+    _rxStatus.signing = signing;
+    _rxStatus.signing_streams = signingStreams;
+}
+
+void MAVLinkParser::updateSigning()
+{
+    mavlink_signing_t signing;
+    const bool enabled = _channelSigning(_mavlinkChannel, signing);
+    (void) QMetaObject::invokeMethod(this, [this, enabled, signing]() {
+        _setSigning(enabled, signing);
+    }, Qt::QueuedConnection);
+}
+
+void MAVLinkParser::_setSigning(bool enabled, const mavlink_signing_t& signing)
+{
+    _rxSigning = signing;
+    _rxStatus.signing = enabled ? &_rxSigning : nullptr;
+    _rxStatus.signing_streams = enabled ? &_signingStreams : nullptr;
+}
+
+uint8_t MAVLinkParser::_parseChar(uint8_t c)
+{
+    const uint8_t result = mavlink_frame_char_buffer(&_rxMessage, &_rxStatus, c, &_message, &_status);
+    if ((result == MAVLINK_FRAMING_BAD_CRC) || (result == MAVLINK_FRAMING_BAD_SIGNATURE)) {
+        // Same as mavlink_parse_char, treat it as a parse failure and resync on a new start byte
+        _rxStatus.parse_error++;
+        _rxStatus.msg_received = MAVLINK_FRAMING_INCOMPLETE;
+        _rxStatus.parse_state = MAVLINK_PARSE_STATE_IDLE;
+        if (c == MAVLINK_STX) {
+            _rxStatus.parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+            _rxMessage.len = 0;
+            mavlink_start_checksum(&_rxMessage);
+        }
+        return MAVLINK_FRAMING_INCOMPLETE;
+    }
+
+    return result;
+}
+
+void MAVLinkParser::parseBytes(LinkInterface* link, const QByteArray& bytes)
+{
+    if (link != _link) {
+        return;
+    }
+
+    // The stream table is shared between all channels, so only signed channels need to serialize
+    const bool signing = _rxStatus.signing != nullptr;
+    const uint64_t signingTimestamp = _rxSigning.timestamp;
+    if (signing) {
+        _signingMutex.lock();
+    }
+
+    // Forwarding routes are owned by the main thread, grab them once per chunk
+    ForwardBatches forwardBatches;
+    for (const MAVLinkForwardRoute& route: _protocol->forwardingRoutes()) {
+        SharedLinkInterfacePtr forwardingLink = route.link().lock();
+        // Never echo a link's traffic back to itself
+        if (forwardingLink && (forwardingLink.get() != link)) {
+            forwardBatches.append({ route, forwardingLink, QByteArray(), true, 0 });
+        }
+    }
+
+    // Reuse the batch buffer. If the main thread still holds the previous batch clear() hands us
+    // a fresh buffer with the same capacity, otherwise the existing allocation is reused as is.
+    _messages.clear();
+    const char* const data = bytes.constData();
+    for (qsizetype i = 0; i < bytes.size(); i++) {
+        if (_parseChar(static_cast<uint8_t>(data[i]))) {
+            _updateLossStats(_message);
+            if (!forwardBatches.isEmpty()) {
+                _forwardMessage(_message, bytes, i + 1, forwardBatches);
+            }
+            _messages.append(_message);
+
+            // Reset message parsing
+            memset(&_status,  0, sizeof(_status));
+            memset(&_message, 0, sizeof(_message));
+        }
+    }
+
+    if (signing) {
+        _signingMutex.unlock();
+
+        // Checking signatures moves the timestamp up to the newest one received. Outgoing packets are signed on the
+        // main thread, which owns the channel's timestamp.
+        if (_rxSigning.timestamp != signingTimestamp) {
+            const mavlink_channel_t channel = static_cast<mavlink_channel_t>(_mavlinkChannel);
+            const uint64_t timestamp = _rxSigning.timestamp;
+            (void) QMetaObject::invokeMethod(_protocol, [channel, timestamp]() {
+                MAVLinkSigning::advanceSigningTimestamp(channel, timestamp);
+            }, Qt::QueuedConnection);
+        }
+    }
+
+    if (!forwardBatches.isEmpty()) {
+        _sendForwardBatches(bytes, forwardBatches);
+    }
+
+    if (!_messages.isEmpty()) {
+        emit messagesReceived(link, _messages);
+    }
+}
+
+void MAVLinkParser::_updateLossStats(const mavlink_message_t& message)
+{
+    uint8_t lastSeq = _lastIndex[message.sysid][message.compid];
+    uint8_t expectedSeq = lastSeq + 1;
+    // Increase receive counter
+    _totalReceiveCounter++;
+    // Determine what the next expected sequence number is, accounting for
+    // never having seen a message for this system/component pair.
+    if (_firstMessage[message.sysid][message.compid]) {
+        _firstMessage[message.sysid][message.compid] = false;
+        lastSeq     = message.seq;
+        expectedSeq = message.seq;
+    }
+    // And if we didn't encounter that sequence number, record the error
+    if (message.seq != expectedSeq) {
+        int lostMessages = 0;
+        //-- Account for overflow during packet loss
+        if (message.seq < expectedSeq) {
+            lostMessages = (message.seq + 255) - expectedSeq;
+        } else {
+            lostMessages = message.seq - expectedSeq;
+        }
+        // Log how many were lost
+        _totalLossCounter += static_cast<uint64_t>(lostMessages);
+    }
+
+    // And update the last sequence number for this system/component pair
+    _lastIndex[message.sysid][message.compid] = message.seq;
+    // Calculate new loss ratio
+    const uint64_t totalSent = _totalReceiveCounter + _totalLossCounter;
+    float receiveLossPercent = static_cast<float>(static_cast<double>(_totalLossCounter) / static_cast<double>(totalSent));
+    receiveLossPercent *= 100.0f;
+    receiveLossPercent = (receiveLossPercent * 0.5f) + (_runningLossPercent * 0.5f);
+    _runningLossPercent = receiveLossPercent;
+
+    // Update MAVLink status on every 32th packet
+    if ((_totalReceiveCounter & 0x1F) == 0) {
+        emit messageStatus(message.sysid, totalSent, _totalReceiveCounter, _totalLossCounter, receiveLossPercent);
+    }
+}
+
+void MAVLinkParser::_forwardMessage(const mavlink_message_t& message, const QByteArray& chunk, qsizetype frameEnd, ForwardBatches& batches)
+{
+    // The parser has already validated the frame, so if all of it is in this chunk the received bytes go out as is.
+    // Frames which started in an earlier chunk are the exception, those are re-encoded.
+    const qsizetype frameLength = MAVLinkForwardRoute::frameLength(message);
+    const qsizetype frameStart = frameEnd - frameLength;
+    const bool frameInChunk = (frameStart >= 0) && (static_cast<uint8_t>(chunk.at(frameStart)) == message.magic);
+
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    int bufLength = 0;
+
+    for (ForwardBatch& batch: batches) {
+        if (!batch.route.accepts(message)) {
+            if (batch.wholeChunk) {
+                batch.bytes.append(chunk.constData(), batch.wholeChunkEnd);
+                batch.wholeChunk = false;
+            }
+            continue;
+        }
+
+        if (frameInChunk) {
+            if (batch.wholeChunk) {
+                if (frameStart == batch.wholeChunkEnd) {
+                    batch.wholeChunkEnd = frameEnd;
+                    continue;
+                }
+                batch.bytes.append(chunk.constData(), batch.wholeChunkEnd);
+                batch.wholeChunk = false;
+            }
+            batch.bytes.append(chunk.constData() + frameStart, frameLength);
+        } else {
+            if (batch.wholeChunk) {
+                batch.bytes.append(chunk.constData(), batch.wholeChunkEnd);
+                batch.wholeChunk = false;
+            }
+            if (bufLength == 0) {
+                bufLength = mavlink_msg_to_send_buffer(buf, &message);
+            }
+            batch.bytes.append(reinterpret_cast<const char*>(buf), bufLength);
+        }
+    }
+}
+
+void MAVLinkParser::_sendForwardBatches(const QByteArray& chunk, ForwardBatches& batches)
+{
+    for (ForwardBatch& batch: batches) {
+        if (batch.wholeChunk) {
+            if (batch.wholeChunkEnd == chunk.size()) {
+                // Every byte of the chunk is a forwarded frame, share the received buffer
+                batch.link->writeBytesThreadSafe(chunk);
+            } else if (batch.wholeChunkEnd > 0) {
+                // Trailing bytes belong to a frame which completes in the next chunk
+                batch.link->writeBytesThreadSafe(chunk.first(batch.wholeChunkEnd));
+            }
+        } else if (!batch.bytes.isEmpty()) {
+            batch.link->writeBytesThreadSafe(batch.bytes);
+        }
+    }
+}
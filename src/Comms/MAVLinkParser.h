@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "MAVLinkForwardRoute.h"
+#include "MAVLinkLib.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QVarLengthArray>
+
+class MAVLinkProtocol;
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkParserLog)
+
+/// Per-link MAVLink framing stage. Every parser runs on a worker thread of its own, whatever thread the link itself
+/// uses, and is fed directly from LinkInterface::bytesReceived. It frames and CRC checks incoming bytes, keeps the
+/// sequence loss statistics for the link and handles forwarding. Complete messages are then handed to MAVLinkProtocol
+/// on the main thread in a single batch per received chunk of bytes.
+///
+/// The main thread owns the channel's mavlink_status_t, it changes the outbound version flags and signs outgoing
+/// packets with it. The parser therefore frames into receive state of its own and verifies signatures against its
+/// own copy of the channel's signing setup, see updateSigning.
+///
+/// Forwarding passes on the frames exactly as they were received rather than re-encoding them, and sends a single
+/// write per destination for each received chunk. When every frame in a chunk goes to a destination the received
+/// buffer itself is shared with that destination, without any copy.
+class MAVLinkParser : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Created by LinkManager on the main thread when the link is set up, then moved to the link's parser thread
+    MAVLinkParser(LinkInterface* link, MAVLinkProtocol* protocol);
+
+    /// Resets the parse state and loss statistics. Can be called from any thread, the reset runs on the parser's thread.
+    void reset();
+
+    /// Hands the parser a copy of the channel's current signing setup. Call on the main thread whenever the signing
+    /// of the link's channel changes.
+    void updateSigning();
+
+public slots:
+    void parseBytes(LinkInterface* link, const QByteArray& bytes);
+
+signals:
+    /// Complete messages decoded from a single chunk of received bytes
+    void messagesReceived(LinkInterface* link, QList<mavlink_message_t> messages);
+
+    /// Loss statistics, emitted for every 32nd received message
+    void messageStatus(int sysid, uint64_t totalSent, uint64_t totalReceived, uint64_t totalLoss, float lossPercent);
+
+private:
+    void _reset();
+    void _setSigning(bool enabled, const mavlink_signing_t& signing);
+    /// mavlink_parse_char on the parser's own receive state rather than the channel's
+    uint8_t _parseChar(uint8_t c);
+
+    /// Frames collected for one forwarding destination while parsing a chunk
+    struct ForwardBatch {
+        MAVLinkForwardRoute     route;
+        SharedLinkInterfacePtr  link;
+        QByteArray              bytes;
+        bool                    wholeChunk = true;  ///< Everything so far was forwarded, bytes not yet copied
+        qsizetype               wholeChunkEnd = 0;  ///< End of the forwarded prefix of the chunk while wholeChunk
+    };
+    typedef QVarLengthArray<ForwardBatch, 2> ForwardBatches;
+
+    void _updateLossStats(const mavlink_message_t& message);
+    void _forwardMessage(const mavlink_message_t& message, const QByteArray& chunk, qsizetype frameEnd, ForwardBatches& batches);
+    void _sendForwardBatches(const QByteArray& chunk, ForwardBatches& batches);
+
+    LinkInterface*      _link;
+    MAVLinkProtocol*    _protocol;
+    const uint8_t       _mavlinkChannel;
+
+    mavlink_message_t   _rxMessage = {};    ///< Message being framed
+    mavlink_status_t    _rxStatus = {};     ///< Framing state, replaces the channel's status for receiving
+    mavlink_signing_t   _rxSigning = {};    ///< Copy of the channel's signing setup, used by _rxStatus while signing
+    mavlink_message_t   _message = {};
+    mavlink_status_t    _status = {};
+    QList<mavlink_message_t> _messages;     ///< Pooled batch buffer
+
+    uint8_t     _lastIndex[256][256];       ///< Last received sequence ID for each system/component pair
+    bool        _firstMessage[256][256];    ///< First message flag for each system/component pair
+    uint64_t    _totalReceiveCounter = 0;   ///< The total number of successfully received messages
+    uint64_t    _totalLossCounter = 0;      ///< Total messages lost during transmission
+    float       _runningLossPercent = 0;    ///< Loss rate
+
+    /// Signature replay protection is shared across all channels
+    static mavlink_signing_streams_t _signingStreams;
+    static QMutex _signingMutex;            ///< Guards _signingStreams
+};
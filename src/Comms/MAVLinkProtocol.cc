@@ -11,6 +11,8 @@
 #include "LinkManager.h"
 #include "QGCApplication.h"
 #include "MultiVehicleManager.h"
+#include "Vehicle.h"
+#include "MAVLinkParser.h"
 #include "SettingsManager.h"
 #include "QGCLoggingCategory.h"
 
@@ -38,8 +40,6 @@ static QObject* mavlinkSingletonFactory(QQmlEngine*, QJSEngine*)
 MAVLinkProtocol::MAVLinkProtocol(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
     , _enable_version_check(true)
-    , _message({})
-    , _status({})
     , versionMismatchIgnore(false)
     , systemId(255)
     , _current_version(100)
@@ -51,12 +51,7 @@ MAVLinkProtocol::MAVLinkProtocol(QGCApplication* app, QGCToolbox* toolbox)
     , _linkMgr(nullptr)
     , _multiVehicleManager(nullptr)
 {
-    memset(totalReceiveCounter, 0, sizeof(totalReceiveCounter));
-    memset(totalLossCounter,    0, sizeof(totalLossCounter));
-    memset(runningLossPercent,  0, sizeof(runningLossPercent));
-    memset(firstMessage,        1, sizeof(firstMessage));
-    memset(&_status,            0, sizeof(_status));
-    memset(&_message,           0, sizeof(_message));
+
 }
 
 MAVLinkProtocol::~MAVLinkProtocol()
@@ -92,6 +87,7 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
 
    qmlRegisterSingletonType<QGCMAVLink>("MAVLink", 1, 0, "MAVLink", mavlinkSingletonFactory);
    qRegisterMetaType<mavlink_message_t>("mavlink_message_t");
+   qRegisterMetaType<QList<mavlink_message_t>>("QList<mavlink_message_t>");
 
    loadSettings();
 
@@ -99,11 +95,15 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
    // on a per-link basis before those links are used. @see resetMetadataForLink().
 
    connect(this, &MAVLinkProtocol::protocolStatusMessage,   _app, &QGCApplication::criticalMessageBoxOnMainThread);
+   connect(&_tlogWriter, &TLogWriter::writeError,            this, &MAVLinkProtocol::_tlogWriteError);
    connect(this, &MAVLinkProtocol::saveTelemetryLog,        _app, &QGCApplication::saveTelemetryLogOnMainThread);
    connect(this, &MAVLinkProtocol::checkTelemetrySavePath,  _app, &QGCApplication::checkTelemetrySavePathOnMainThread);
 
    connect(_multiVehicleManager, &MultiVehicleManager::vehicleAdded, this, &MAVLinkProtocol::_vehicleCountChanged);
    connect(_multiVehicleManager, &MultiVehicleManager::vehicleRemoved, this, &MAVLinkProtocol::_vehicleCountChanged);
+   connect(_app->toolbox()->settingsManager()->appSettings()->forwardMavlink(), &Fact::rawValueChanged, this, &MAVLinkProtocol::updateForwardingLinks);
+   connect(_app->toolbox()->settingsManager()->appSettings()->forwardMavlinkSysIds(), &Fact::rawValueChanged, this, &MAVLinkProtocol::updateForwardingLinks);
+   connect(_app->toolbox()->settingsManager()->appSettings()->forwardMavlinkMsgIds(), &Fact::rawValueChanged, this, &MAVLinkProtocol::updateForwardingLinks);
 
    emit versionCheckChanged(_enable_version_check);
 }
@@ -135,12 +135,8 @@ void MAVLinkProtocol::storeSettings()
 
 void MAVLinkProtocol::resetMetadataForLink(LinkInterface *link)
 {
-    int channel = link->mavlinkChannel();
-    totalReceiveCounter[channel] = 0;
-    totalLossCounter[channel]    = 0;
-    runningLossPercent[channel]  = 0.0f;
-    for(int i = 0; i < 256; i++) {
-        firstMessage[channel][i] =  1;
+    if (link->mavlinkParser()) {
+        link->mavlinkParser()->reset();
     }
     link->setDecodedFirstMavlinkPacket(false);
 }
@@ -151,238 +147,247 @@ void MAVLinkProtocol::resetMetadataForLink(LinkInterface *link)
  * @see LinkInterface
  **/
 
-void MAVLinkProtocol::logSentBytes(LinkInterface* link, QByteArray b){
-
-    uint8_t bytes_time[sizeof(quint64)];
-
+void MAVLinkProtocol::logSentBytes(LinkInterface* link, const QByteArray& b)
+{
     Q_UNUSED(link);
-    if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
 
+    if (!_logSuspendError && !_logSuspendReplay && _tlogWriter.isOpen()) {
         quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
 
-        qToBigEndian(time,bytes_time);
-
-        b.insert(0,QByteArray((const char*)bytes_time,sizeof(bytes_time)));
+        // Links coalesce writes, so a single write can hold several frames. Each frame gets its own log record.
+        const uchar* const data = reinterpret_cast<const uchar*>(b.constData());
+        const int size = static_cast<int>(b.size());
+        int offset = 0;
+        while (offset < size) {
+            int frameLength = _sentFrameLength(data + offset, size - offset);
+            if (frameLength <= 0) {
+                // Not something we sent as MAVLink, log the rest as is
+                frameLength = size - offset;
+            }
+            (void) _tlogWriter.append(time, b.constData() + offset, frameLength);
+            offset += frameLength;
+        }
+    }
+}
 
-        int len = b.length();
+int MAVLinkProtocol::_sentFrameLength(const uchar* frame, int available)
+{
+    if (available < MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1) {
+        return 0;
+    }
 
-        if(_tempLogFile.write(b) != len)
-        {
-            // If there's an error logging data, raise an alert and stop logging.
-            emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
-            _stopLogging();
-            _logSuspendError = true;
+    int frameLength;
+    if (frame[0] == MAVLINK_STX) {
+        if (available < MAVLINK_CORE_HEADER_LEN + 1) {
+            return 0;
+        }
+        frameLength = MAVLINK_CORE_HEADER_LEN + 1 + frame[1] + MAVLINK_NUM_CHECKSUM_BYTES;
+        if (frame[2] & MAVLINK_IFLAG_SIGNED) {
+            frameLength += MAVLINK_SIGNATURE_BLOCK_LEN;
         }
+    } else if (frame[0] == MAVLINK_STX_MAVLINK1) {
+        frameLength = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1 + frame[1] + MAVLINK_NUM_CHECKSUM_BYTES;
+    } else {
+        return 0;
     }
 
+    return (frameLength <= available) ? frameLength : 0;
 }
 
 /**
- * This method parses all incoming bytes and constructs a MAVLink packet.
- * It can handle multiple links in parallel, as each link has it's own buffer/
- * parsing state machine.
- * @param link The interface to read from
- * @see LinkInterface
+ * This method handles a batch of complete messages which were framed, CRC checked and
+ * loss counted by the link's MAVLinkParser on the link thread.
+ * @param link The interface the messages were received on
+ * @see MAVLinkParser
  **/
 
-void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
+void MAVLinkProtocol::receiveMessages(LinkInterface* link, const QList<mavlink_message_t>& messages)
 {
-    // Since receiveBytes signals cross threads we can end up with signals in the queue
+    // Since the message batches cross threads we can end up with signals in the queue
     // that come through after the link is disconnected. For these we just drop the data
     // since the link is closed.
     SharedLinkInterfacePtr linkPtr = _linkMgr->sharedLinkInterfacePointerForLink(link);
     if (!linkPtr) {
-        qCDebug(MAVLinkProtocolLog) << "receiveBytes: link gone!" << b.size() << " bytes arrived too late";
+        qCDebug(MAVLinkProtocolLog) << "receiveMessages: link gone!" << messages.size() << " messages arrived too late";
         return;
     }
 
-    uint8_t mavlinkChannel = link->mavlinkChannel();
-
-    for (int position = 0; position < b.size(); position++) {
-        if (mavlink_parse_char(mavlinkChannel, static_cast<uint8_t>(b[position]), &_message, &_status)) {
-            // Got a valid message
-            if (!link->decodedFirstMavlinkPacket()) {
-                link->setDecodedFirstMavlinkPacket(true);
-                mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-                if (!(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) && (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
-                    qCDebug(MAVLinkProtocolLog) << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
-                    mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-                    // Set all links to v2
-                    setVersion(200);
-                }
-            }
+    _updateDeliveryRate(messages.size());
 
-            //-----------------------------------------------------------------
-            // MAVLink Status
-            uint8_t lastSeq = lastIndex[_message.sysid][_message.compid];
-            uint8_t expectedSeq = lastSeq + 1;
-            // Increase receive counter
-            totalReceiveCounter[mavlinkChannel]++;
-            // Determine what the next expected sequence number is, accounting for
-            // never having seen a message for this system/component pair.
-            if(firstMessage[_message.sysid][_message.compid]) {
-                firstMessage[_message.sysid][_message.compid] = 0;
-                lastSeq     = _message.seq;
-                expectedSeq = _message.seq;
-            }
-            // And if we didn't encounter that sequence number, record the error
-            //int foo = 0;
-            if (_message.seq != expectedSeq)
-            {
-                //foo = 1;
-                int lostMessages = 0;
-                //-- Account for overflow during packet loss
-                if(_message.seq < expectedSeq) {
-                    lostMessages = (_message.seq + 255) - expectedSeq;
-                } else {
-                    lostMessages = _message.seq - expectedSeq;
-                }
-                // Log how many were lost
-                totalLossCounter[mavlinkChannel] += static_cast<uint64_t>(lostMessages);
-            }
+    qsizetype handledCount = 0;
+    for (const mavlink_message_t& message: messages) {
+        handledCount++;
 
-            // And update the last sequence number for this system/component pair
-            lastIndex[_message.sysid][_message.compid] = _message.seq;;
-            // Calculate new loss ratio
-            uint64_t totalSent = totalReceiveCounter[mavlinkChannel] + totalLossCounter[mavlinkChannel];
-            float receiveLossPercent = static_cast<float>(static_cast<double>(totalLossCounter[mavlinkChannel]) / static_cast<double>(totalSent));
-            receiveLossPercent *= 100.0f;
-            receiveLossPercent = (receiveLossPercent * 0.5f) + (runningLossPercent[mavlinkChannel] * 0.5f);
-            runningLossPercent[mavlinkChannel] = receiveLossPercent;
-
-            //qDebug() << foo << _message.seq << expectedSeq << lastSeq << totalLossCounter[mavlinkChannel] << totalReceiveCounter[mavlinkChannel] << totalSentCounter[mavlinkChannel] << "(" << _message.sysid << _message.compid << ")";
-
-            //-----------------------------------------------------------------
-            // MAVLink forwarding
-            bool forwardingEnabled = _app->toolbox()->settingsManager()->appSettings()->forwardMavlink()->rawValue().toBool();
-            if (_message.msgid == MAVLINK_MSG_ID_SETUP_SIGNING) {
-                forwardingEnabled = false;
+        if (!link->decodedFirstMavlinkPacket()) {
+            link->setDecodedFirstMavlinkPacket(true);
+            mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(link->mavlinkChannel());
+            if ((message.magic == MAVLINK_STX) && (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
+                qCDebug(MAVLinkProtocolLog) << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkStatus << link->mavlinkChannel() << mavlinkStatus->flags;
+                mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+                // Set all links to v2
+                setVersion(200);
             }
-            if (forwardingEnabled) {
-                SharedLinkInterfacePtr forwardingLink = _linkMgr->mavlinkForwardingLink();
+        }
 
-                if (forwardingLink) {
-                    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
-                    int len = mavlink_msg_to_send_buffer(buf, &_message);
-                    forwardingLink->writeBytesThreadSafe((const char*)buf, len);
+        //-----------------------------------------------------------------
+        // Log data
+        if (!_logSuspendError && !_logSuspendReplay && _tlogWriter.isOpen()) {
+            // Write the uint64 time in microseconds in big endian format before the message.
+            // This timestamp is saved in UTC time. We are only saving in ms precision because
+            // getting more than this isn't possible with Qt without a ton of extra code.
+            quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
+
+            // The writer buffers the timestamp/message pair and commits it to disk in the background
+            uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+            int len = mavlink_msg_to_send_buffer(buf, &message);
+            (void) _tlogWriter.append(time, reinterpret_cast<const char*>(buf), len);
+
+            // Check for the vehicle arming going by. This is used to trigger log save.
+            if (!_vehicleWasArmed && message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+                mavlink_heartbeat_t state;
+                mavlink_msg_heartbeat_decode(&message, &state);
+                if (state.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
+                    _vehicleWasArmed = true;
                 }
             }
+        }
 
-            // MAVLink forwarding support
-            bool forwardingSupportEnabled = _linkMgr->mavlinkSupportForwardingEnabled();
-            if (_message.msgid == MAVLINK_MSG_ID_SETUP_SIGNING) {
-                forwardingSupportEnabled = false;
-            }
-            if (forwardingSupportEnabled) {
-                SharedLinkInterfacePtr forwardingSupportLink = _linkMgr->mavlinkForwardingSupportLink();
+        if (message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+            _startLogging();
+            mavlink_heartbeat_t heartbeat;
+            mavlink_msg_heartbeat_decode(&message, &heartbeat);
+            emit vehicleHeartbeatInfo(link, message.sysid, message.compid, heartbeat.autopilot, heartbeat.type);
+        } else if (message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY) {
+            _startLogging();
+            mavlink_high_latency_t highLatency;
+            mavlink_msg_high_latency_decode(&message, &highLatency);
+            // HIGH_LATENCY does not provide autopilot or type information, generic is our safest bet
+            emit vehicleHeartbeatInfo(link, message.sysid, message.compid, MAV_AUTOPILOT_GENERIC, MAV_TYPE_GENERIC);
+        } else if (message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY2) {
+            _startLogging();
+            mavlink_high_latency2_t highLatency2;
+            mavlink_msg_high_latency2_decode(&message, &highLatency2);
+            emit vehicleHeartbeatInfo(link, message.sysid, message.compid, highLatency2.autopilot, highLatency2.type);
+        }
 
-                if (forwardingSupportLink) {
-                    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
-                    int len = mavlink_msg_to_send_buffer(buf, &_message);
-                    forwardingSupportLink->writeBytesThreadSafe((const char*)buf, len);
-                }
-            }
+        // Vehicles get their own traffic through the sysid dispatch table, everyone else
+        // (inspector, calibration, AirLink) still sees every message through the signal.
+        _dispatchToVehicles(link, message);
 
-            //-----------------------------------------------------------------
-            // Log data
-            if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
-                uint8_t buf[MAVLINK_MAX_PACKET_LEN+sizeof(quint64)];
-
-                // Write the uint64 time in microseconds in big endian format before the message.
-                // This timestamp is saved in UTC time. We are only saving in ms precision because
-                // getting more than this isn't possible with Qt without a ton of extra code.
-                quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-                qToBigEndian(time, buf);
-
-                // Then write the message to the buffer
-                int len = mavlink_msg_to_send_buffer(buf + sizeof(quint64), &_message);
-
-                // Determine how many bytes were written by adding the timestamp size to the message size
-                len += sizeof(quint64);
-
-                // Now write this timestamp/message pair to the log.
-                QByteArray b(reinterpret_cast<const char*>(buf), len);
-                if(_tempLogFile.write(b) != len)
-                {
-                    // If there's an error logging data, raise an alert and stop logging.
-                    emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
-                    _stopLogging();
-                    _logSuspendError = true;
-                }
+        // The packet is emitted as a whole, as it is only 255 - 261 bytes short
+        // kind of inefficient, but no issue for a groundstation pc.
+        // It buys as reentrancy for the whole code over all threads
+        emit messageReceived(link, message);
 
-                // Check for the vehicle arming going by. This is used to trigger log save.
-                if (!_vehicleWasArmed && _message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                    mavlink_heartbeat_t state;
-                    mavlink_msg_heartbeat_decode(&_message, &state);
-                    if (state.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
-                        _vehicleWasArmed = true;
-                    }
-                }
-            }
+        // Anyone handling the message could close the connection, which deletes the link,
+        // so we check if it's expired
+        if (1 == linkPtr.use_count()) {
+            break;
+        }
+    }
 
-            if (_message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                _startLogging();
-                mavlink_heartbeat_t heartbeat;
-                mavlink_msg_heartbeat_decode(&_message, &heartbeat);
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, heartbeat.autopilot, heartbeat.type);
-            } else if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY) {
-                _startLogging();
-                mavlink_high_latency_t highLatency;
-                mavlink_msg_high_latency_decode(&_message, &highLatency);
-                // HIGH_LATENCY does not provide autopilot or type information, generic is our safest bet
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, MAV_AUTOPILOT_GENERIC, MAV_TYPE_GENERIC);
-            } else if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY2) {
-                _startLogging();
-                mavlink_high_latency2_t highLatency2;
-                mavlink_msg_high_latency2_decode(&_message, &highLatency2);
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, highLatency2.autopilot, highLatency2.type);
-            }
+    if (handledCount == messages.size()) {
+        emit messagesReceived(link, messages);
+    } else {
+        emit messagesReceived(link, messages.first(handledCount));
+    }
+}
 
-#if 0
-            // Given the current state of SiK Radio firmwares there is no way to make the code below work.
-            // The ArduPilot implementation of SiK Radio firmware always sends MAVLINK_MSG_ID_RADIO_STATUS as a mavlink 1
-            // packet even if the vehicle is sending Mavlink 2.
-
-            // Detect if we are talking to an old radio not supporting v2
-            mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-            if (_message.msgid == MAVLINK_MSG_ID_RADIO_STATUS && _radio_version_mismatch_count != -1) {
-                if ((mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)
-                && !(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
-                    _radio_version_mismatch_count++;
-                }
-            }
+void MAVLinkProtocol::_updateDeliveryRate(qsizetype messageCount)
+{
+    if (!_deliveryRateTimer.isValid()) {
+        _deliveryRateTimer.start();
+    }
 
-            if (_radio_version_mismatch_count == 5) {
-                // Warn the user if the radio continues to send v1 while the link uses v2
-                emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Detected radio still using MAVLink v1.0 on a link with MAVLink v2.0 enabled. Please upgrade the radio firmware."));
-                // Set to flag warning already shown
-                _radio_version_mismatch_count = -1;
-                // Flick link back to v1
-                qDebug() << "Switching outbound to mavlink 1.0 due to incoming mavlink 1.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
-                mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-            }
-#endif
+    _deliveryRateMessages += static_cast<uint32_t>(messageCount);
+    _deliveryRateBatches++;
+
+    const qint64 elapsedMSecs = _deliveryRateTimer.elapsed();
+    if (elapsedMSecs >= 1000) {
+        // With per packet delivery every message was its own queued event, now each batch is
+        qCDebug(MAVLinkProtocolLog) << "Main thread delivery: messages/sec" << (_deliveryRateMessages * 1000 / elapsedMSecs)
+                                    << "queued events/sec" << (_deliveryRateBatches * 1000 / elapsedMSecs);
+        _deliveryRateMessages = 0;
+        _deliveryRateBatches = 0;
+        _deliveryRateTimer.restart();
+    }
+}
 
-            // Update MAVLink status on every 32th packet
-            if ((totalReceiveCounter[mavlinkChannel] & 0x1F) == 0) {
-                emit mavlinkMessageStatus(_message.sysid, totalSent, totalReceiveCounter[mavlinkChannel], totalLossCounter[mavlinkChannel], receiveLossPercent);
-            }
+QList<MAVLinkForwardRoute> MAVLinkProtocol::forwardingRoutes()
+{
+    QMutexLocker locker(&_forwardingRoutesMutex);
 
-            // The packet is emitted as a whole, as it is only 255 - 261 bytes short
-            // kind of inefficient, but no issue for a groundstation pc.
-            // It buys as reentrancy for the whole code over all threads
-            emit messageReceived(link, _message);
+    return _forwardingRoutes;
+}
 
-            // Anyone handling the message could close the connection, which deletes the link,
-            // so we check if it's expired
-            if (1 == linkPtr.use_count()) {
-                break;
+void MAVLinkProtocol::updateForwardingLinks()
+{
+    QList<MAVLinkForwardRoute> routes;
+
+    AppSettings* const appSettings = _app->toolbox()->settingsManager()->appSettings();
+    if (appSettings->forwardMavlink()->rawValue().toBool()) {
+        const SharedLinkInterfacePtr forwardingLink = _linkMgr->mavlinkForwardingLink();
+        if (forwardingLink) {
+            MAVLinkForwardRoute route(forwardingLink);
+            if (!route.setSysIdFilter(appSettings->forwardMavlinkSysIds()->rawValue().toString())) {
+                qCWarning(MAVLinkProtocolLog) << "Invalid forwarding system id filter, forwarding all systems";
             }
+            if (!route.setMsgIdFilter(appSettings->forwardMavlinkMsgIds()->rawValue().toString())) {
+                qCWarning(MAVLinkProtocolLog) << "Invalid forwarding message id filter, forwarding all messages";
+            }
+            routes.append(route);
+        }
+    }
+
+    // The support link always gets everything
+    if (_linkMgr->mavlinkSupportForwardingEnabled()) {
+        const SharedLinkInterfacePtr forwardingSupportLink = _linkMgr->mavlinkForwardingSupportLink();
+        if (forwardingSupportLink) {
+            routes.append(MAVLinkForwardRoute(forwardingSupportLink));
+        }
+    }
+
+    QMutexLocker locker(&_forwardingRoutesMutex);
+    _forwardingRoutes = routes;
+}
+
+void MAVLinkProtocol::registerVehicle(Vehicle* vehicle)
+{
+    const int vehicleId = vehicle->id();
+    if (vehicleId <= 0 || vehicleId > 255) {
+        qCWarning(MAVLinkProtocolLog) << "registerVehicle: invalid vehicle id" << vehicleId;
+        return;
+    }
+    if (_sysIdVehicles[vehicleId] && _sysIdVehicles[vehicleId] != vehicle) {
+        qCWarning(MAVLinkProtocolLog) << "registerVehicle: replacing existing vehicle for id" << vehicleId;
+        _registeredVehicles.removeOne(_sysIdVehicles[vehicleId]);
+    }
+
+    _sysIdVehicles[vehicleId] = vehicle;
+    if (!_registeredVehicles.contains(vehicle)) {
+        _registeredVehicles.append(vehicle);
+    }
+}
+
+void MAVLinkProtocol::unregisterVehicle(Vehicle* vehicle)
+{
+    const int vehicleId = vehicle->id();
+    if (vehicleId > 0 && vehicleId <= 255 && _sysIdVehicles[vehicleId] == vehicle) {
+        _sysIdVehicles[vehicleId] = nullptr;
+    }
+    _registeredVehicles.removeOne(vehicle);
+}
 
-            // Reset message parsing
-            memset(&_status,  0, sizeof(_status));
-            memset(&_message, 0, sizeof(_message));
+void MAVLinkProtocol::_dispatchToVehicles(LinkInterface* link, const mavlink_message_t& message)
+{
+    if (message.sysid == 0 || message.msgid == MAVLINK_MSG_ID_RADIO_STATUS) {
+        // Broadcast path. Iterate a copy since a handler may cause vehicles to come or go.
+        const QList<Vehicle*> vehicles = _registeredVehicles;
+        for (Vehicle* vehicle: vehicles) {
+            vehicle->_mavlinkMessageReceived(link, message);
         }
+    } else if (Vehicle* vehicle = _sysIdVehicles[message.sysid]) {
+        vehicle->_mavlinkMessageReceived(link, message);
     }
 }
 
@@ -417,6 +422,14 @@ void MAVLinkProtocol::enableVersionCheck(bool enabled)
     emit versionCheckChanged(enabled);
 }
 
+void MAVLinkProtocol::_tlogWriteError(const QString& fileName)
+{
+    // If there's an error logging data, raise an alert and stop logging.
+    emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(fileName));
+    _stopLogging();
+    _logSuspendError = true;
+}
+
 void MAVLinkProtocol::_vehicleCountChanged(void)
 {
     int count = _multiVehicleManager->vehicles()->count();
@@ -430,14 +443,14 @@ void MAVLinkProtocol::_vehicleCountChanged(void)
 /// @brief Closes the log file if it is open
 bool MAVLinkProtocol::_closeLogFile(void)
 {
-    if (_tempLogFile.isOpen()) {
-        if (_tempLogFile.size() == 0) {
+    if (_tlogWriter.isOpen()) {
+        // Commits whatever is still buffered before closing
+        _tlogWriter.close();
+        if (QFileInfo(_tempLogFile.fileName()).size() == 0) {
             // Don't save zero byte files
-            _tempLogFile.remove();
+            QFile::remove(_tempLogFile.fileName());
             return false;
         } else {
-            _tempLogFile.flush();
-            _tempLogFile.close();
             return true;
         }
     }
@@ -462,9 +475,16 @@ void MAVLinkProtocol::_startLogging(void)
 #endif
     //-- Log is always written to a temp file. If later the user decides they want
     //   it, it's all there for them.
-    if (!_tempLogFile.isOpen()) {
+    if (!_tlogWriter.isOpen()) {
         if (!_logSuspendReplay) {
-            if (!_tempLogFile.open()) {
+            // The temp file only reserves a unique name, the writer owns the file from here on
+            _tlogWriter.setFsyncPolicy(static_cast<TLogWriter::FsyncPolicy>(appSettings->telemetryLogFsync()->rawValue().toInt()));
+            const bool created = _tempLogFile.open();
+            _tempLogFile.close();
+            if (!created || !_tlogWriter.open(_tempLogFile.fileName())) {
+                if (created) {
+                    QFile::remove(_tempLogFile.fileName());
+                }
                 emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Opening Flight Data file for writing failed. "
                                                                       "Unable to write to %1. Please choose a different file location.").arg(_tempLogFile.fileName()));
                 _closeLogFile();
@@ -482,7 +502,7 @@ void MAVLinkProtocol::_startLogging(void)
 
 void MAVLinkProtocol::_stopLogging(void)
 {
-    if (_tempLogFile.isOpen()) {
+    if (_tlogWriter.isOpen()) {
         if (_closeLogFile()) {
             if ((_vehicleWasArmed || _app->toolbox()->settingsManager()->appSettings()->telemetrySaveNotArmed()->rawValue().toBool()) &&
                 _app->toolbox()->settingsManager()->appSettings()->telemetrySave()->rawValue().toBool() &&
@@ -10,17 +10,23 @@
 #pragma once
 
 #include "LinkInterface.h"
+#include "MAVLinkForwardRoute.h"
 #include "QGCMAVLink.h"
 #include "QGCTemporaryFile.h"
 #include "QGCToolbox.h"
+#include "TLogWriter.h"
 
 #include <QtCore/QString>
 #include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
 
 class LinkManager;
 class MultiVehicleManager;
 class QGCApplication;
+class Vehicle;
 
 Q_DECLARE_LOGGING_CATEGORY(MAVLinkProtocolLog)
 
@@ -71,12 +77,24 @@ public:
     // Override from QGCTool
     virtual void setToolbox(QGCToolbox *toolbox);
 
+    /// Routes all messages from @a vehicle's system id directly to it. Broadcast traffic (sysid 0) and RADIO_STATUS
+    /// are delivered to every registered vehicle. Vehicles no longer need to filter the messageReceived firehose.
+    void registerVehicle(Vehicle* vehicle);
+    void unregisterVehicle(Vehicle* vehicle);
+
+    /// Thread safe access to the current forwarding routes. Called by the link parsers from the link threads.
+    QList<MAVLinkForwardRoute> forwardingRoutes();
+
+    /// Refreshes the forwarding routes from the LinkManager and settings. Must be called on the main thread whenever
+    /// links come and go or the forwarding settings change.
+    void updateForwardingLinks();
+
 public slots:
-    /** @brief Receive bytes from a communication interface */
-    void receiveBytes(LinkInterface* link, QByteArray b);
+    /** @brief Receive a batch of complete messages framed by the link's MAVLinkParser */
+    void receiveMessages(LinkInterface* link, const QList<mavlink_message_t>& messages);
 
     /** @brief Log bytes sent from a communication interface */
-    void logSentBytes(LinkInterface* link, QByteArray b);
+    void logSentBytes(LinkInterface* link, const QByteArray& b);
 
     /** @brief Set the system id of this application */
     void setSystemId(int id);
@@ -97,15 +115,6 @@ public slots:
 
 protected:
     bool        _enable_version_check;                         ///< Enable checking of version match of MAV and QGC
-    uint8_t     lastIndex[256][256];                            ///< Store the last received sequence ID for each system/componenet pair
-    uint8_t     firstMessage[256][256];                         ///< First message flag
-    uint64_t    totalReceiveCounter[MAVLINK_COMM_NUM_BUFFERS];  ///< The total number of successfully received messages
-    uint64_t    totalLossCounter[MAVLINK_COMM_NUM_BUFFERS];     ///< Total messages lost during transmission.
-    float       runningLossPercent[MAVLINK_COMM_NUM_BUFFERS];   ///< Loss rate
-
-    mavlink_message_t _message;
-    mavlink_status_t _status;
-
     bool        versionMismatchIgnore;
     int         systemId;
     unsigned    _current_version;
@@ -117,6 +126,8 @@ signals:
 
     /** @brief Message received and directly copied via signal */
     void messageReceived(LinkInterface* link, mavlink_message_t message);
+    /** @brief All messages decoded from one chunk of link bytes. Prefer this over messageReceived for high rate consumers. */
+    void messagesReceived(LinkInterface* link, const QList<mavlink_message_t>& messages);
     /** @brief Emitted if version check is enabled / disabled */
     void versionCheckChanged(bool enabled);
     /** @brief Emitted if a message from the protocol should reach the user */
@@ -148,21 +159,37 @@ signals:
 
 private slots:
     void _vehicleCountChanged(void);
+    void _tlogWriteError(const QString& fileName);
 
 private:
     bool _closeLogFile(void);
+    /// @return Length of the complete MAVLink frame at the start of @a frame, 0 if there isn't one
+    static int _sentFrameLength(const uchar* frame, int available);
     void _startLogging(void);
     void _stopLogging(void);
+    void _dispatchToVehicles(LinkInterface* link, const mavlink_message_t& message);
+    void _updateDeliveryRate(qsizetype messageCount);
 
     bool _logSuspendError;      ///< true: Logging suspended due to error
     bool _logSuspendReplay;     ///< true: Logging suspended due to replay
     bool _vehicleWasArmed;      ///< true: Vehicle was armed during log sequence
 
-    QGCTemporaryFile    _tempLogFile;            ///< File to log to
+    QGCTemporaryFile    _tempLogFile;            ///< Reserves the unique name of the log file
+    TLogWriter          _tlogWriter;             ///< Buffered background writer for the log file
     static constexpr const char* _tempLogFileTemplate   = "FlightDataXXXXXX";   ///< Template for temporary log file
     static constexpr const char* _logFileExtension      = "mavlink";            ///< Extension for log files
 
     LinkManager*            _linkMgr;
     MultiVehicleManager*    _multiVehicleManager;
+
+    QElapsedTimer           _deliveryRateTimer;
+    uint32_t                _deliveryRateMessages = 0;  ///< Messages delivered in the current rate window
+    uint32_t                _deliveryRateBatches = 0;   ///< Queued batch events delivered in the current rate window
+
+    QMutex                      _forwardingRoutesMutex;
+    QList<MAVLinkForwardRoute>  _forwardingRoutes;      ///< Guarded by _forwardingRoutesMutex
+
+    Vehicle*                _sysIdVehicles[256] = {};   ///< Vehicle registered for each system id
+    QList<Vehicle*>         _registeredVehicles;        ///< All registered vehicles, for the broadcast path
 };
 
@@ -527,6 +527,11 @@ void MockLink::_sendVibration(void)
 
 void MockLink::respondWithMavlinkMessage(const mavlink_message_t& msg)
 {
+    if (_paramValueLossPercent && msg.msgid == MAVLINK_MSG_ID_PARAM_VALUE && static_cast<int>(_paramValueLossRandom.bounded(100)) < _paramValueLossPercent) {
+        qCDebug(MockLinkVerboseLog) << "Dropping PARAM_VALUE to simulate link loss";
+        return;
+    }
+
     if (!_commLost) {
         uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
 
@@ -834,6 +839,25 @@ void MockLink::_handleParamRequestList(const mavlink_message_t& msg)
     // Start the worker routine
     _currentParamRequestListComponentIndex = 0;
     _currentParamRequestListParamIndex = 0;
+
+    if (_sendParamHashCheck) {
+        mavlink_message_t       responseMsg;
+        mavlink_param_union_t   valueUnion;
+        char                    paramId[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN] = "_HASH_CHECK";
+
+        valueUnion.type = MAV_PARAM_TYPE_UINT32;
+        valueUnion.param_uint32 = _paramHashCheck;
+        mavlink_msg_param_value_pack_chan(_vehicleSystemId,
+                                          MAV_COMP_ID_AUTOPILOT1,
+                                          mavlinkChannel(),
+                                          &responseMsg,
+                                          paramId,
+                                          valueUnion.param_float,
+                                          MAV_PARAM_TYPE_UINT32,
+                                          0,
+                                          -1);
+        respondWithMavlinkMessage(responseMsg);
+    }
 }
 
 /// Sends the next parameter to the vehicle
@@ -904,6 +928,19 @@ void MockLink::_handleParamSet(const mavlink_message_t& msg)
 
     qCDebug(MockLinkLog) << "_handleParamSet" << componentId << paramId << request.param_type;
 
+    if (strcmp(paramId, "_HASH_CHECK") == 0) {
+        // QGC loaded the parameters from its cache, stop streaming the autopilot parameters like PX4 does
+        _paramHashCheckAcked = true;
+        if ((_currentParamRequestListComponentIndex != -1) &&
+                (_mapParamName2Value.keys()[_currentParamRequestListComponentIndex] == MAV_COMP_ID_AUTOPILOT1)) {
+            _currentParamRequestListParamIndex = 0;
+            if (++_currentParamRequestListComponentIndex >= _mapParamName2Value.keys().count()) {
+                _currentParamRequestListComponentIndex = -1;
+            }
+        }
+        return;
+    }
+
     Q_ASSERT(_mapParamName2Value.contains(componentId));
     Q_ASSERT(_mapParamName2MavParamType.contains(componentId));
     Q_ASSERT(_mapParamName2Value[componentId].contains(paramId));
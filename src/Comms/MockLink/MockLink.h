@@ -20,6 +20,7 @@
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
+#include <QtCore/QRandomGenerator>
 
 Q_DECLARE_LOGGING_CATEGORY(MockLinkLog)
 Q_DECLARE_LOGGING_CATEGORY(MockLinkVerboseLog)
@@ -186,6 +187,16 @@ public:
     } RequestMessageFailureMode_t;
     void setRequestMessageFailureMode(RequestMessageFailureMode_t failureMode) { _requestMessageFailureMode = failureMode; }
 
+    /// Randomly drops the given percentage of PARAM_VALUE messages sent to QGC to simulate a lossy link
+    void setParamValueLossPercent(int lossPercent) { _paramValueLossPercent = lossPercent; }
+
+    /// Reports @a hash in a _HASH_CHECK PARAM_VALUE at the start of PARAM_REQUEST_LIST like PX4 does, so QGC can load the
+    /// autopilot parameters from its cache
+    void setParamHashCheck(quint32 hash) { _paramHashCheck = hash; _sendParamHashCheck = true; }
+
+    /// @return true: QGC acknowledged the _HASH_CHECK, which it only does after loading the parameters from its cache
+    bool paramHashCheckAcked() const { return _paramHashCheckAcked; }
+
 signals:
     void writeBytesQueuedSignal                 (const QByteArray bytes);
     void highLatencyTransmissionEnabledChanged  (bool highLatencyTransmissionEnabled);
@@ -323,6 +334,12 @@ private:
 
     RequestMessageFailureMode_t _requestMessageFailureMode = FailRequestMessageNone;
 
+    int                         _paramValueLossPercent = 0;
+    QRandomGenerator            _paramValueLossRandom{1};       ///< Fixed seed so lossy runs are repeatable
+    bool                        _sendParamHashCheck = false;
+    quint32                     _paramHashCheck = 0;
+    bool                        _paramHashCheckAcked = false;
+
     QMap<MAV_CMD, int>                          _receivedMavCommandCountMap;
     QMap<int, QMap<QString, QVariant>>          _mapParamName2Value;
     QMap<int, QMap<QString, MAV_PARAM_TYPE>>    _mapParamName2MavParamType;
@@ -0,0 +1,327 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TLogIndex.h"
+#include "MAVLinkLib.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(TLogIndexLog, "TLogIndexLog")
+
+namespace {
+    constexpr qint64 kMaxRecordSize = TLogIndex::cbTimestamp + MAVLINK_MAX_PACKET_LEN;
+    constexpr qint64 kMapWindowSize = 256 * 1024 * 1024;
+    constexpr quint64 kMaxChainedGapUSecs = 60ULL * 60 * 1000 * 1000;
+}
+
+bool TLogIndex::load(QFile& file)
+{
+    _entries.clear();
+    _startTimeUSecs = 0;
+    _endTimeUSecs = 0;
+
+    const QFileInfo logFileInfo(file.fileName());
+    const qint64 logSize = logFileInfo.size();
+    const qint64 logModifiedMSecs = logFileInfo.lastModified().toMSecsSinceEpoch();
+    const QString cacheFile = cacheFileName(file.fileName());
+
+    if (_loadCache(cacheFile, logSize, logModifiedMSecs)) {
+        qCDebug(TLogIndexLog) << "Loaded cached index" << cacheFile << _entries.count() << "entries";
+        return true;
+    }
+
+    QElapsedTimer buildTimer;
+    buildTimer.start();
+    if (!_build(file)) {
+        return false;
+    }
+    qCDebug(TLogIndexLog) << "Built index" << file.fileName() << _entries.count() << "entries in" << buildTimer.elapsed() << "msecs";
+
+    _saveCache(cacheFile, logSize, logModifiedMSecs);
+    return true;
+}
+
+bool TLogIndex::_build(QFile& file)
+{
+    const qint64 fileSize = file.size();
+
+    qint64  windowStart = 0;
+    qint64  lastEntryOffset = -indexStrideBytes;
+    bool    chained = false;
+    bool    haveRecord = false;
+    Record  record;
+    Record  lastRecord;
+
+    while (windowStart < fileSize) {
+        const qint64 windowLength = qMin(kMapWindowSize, fileSize - windowStart);
+        const uchar* const window = file.map(windowStart, windowLength);
+        if (!window) {
+            qCWarning(TLogIndexLog) << "Unable to map" << file.fileName() << file.errorString();
+            _entries.clear();
+            return false;
+        }
+
+        // Records which could cross the end of the window are picked up by the next window
+        const bool lastWindow = (windowStart + windowLength) >= fileSize;
+        const qint64 scanEnd = lastWindow ? windowLength : (windowLength - kMaxRecordSize);
+
+        qint64 pos = 0;
+        while (pos < scanEnd) {
+            // Records normally follow each other directly, only fall back to the CRC checked scan to resynchronize.
+            // Garbage can look like a well formed record, so a chained record must also have a sane timestamp.
+            bool found = chained && readRecord(window, windowLength, pos, false /* checkCrc */, record) &&
+                         (qMax(record.timeUSecs, lastRecord.timeUSecs) - qMin(record.timeUSecs, lastRecord.timeUSecs) <= kMaxChainedGapUSecs);
+            if (!found) {
+                found = nextRecord(window, windowLength, pos, record);
+            }
+            if (!found) {
+                pos = scanEnd;
+                chained = false;
+                break;
+            }
+            chained = true;
+
+            const qint64 recordOffset = windowStart + record.offset;
+            if (!haveRecord) {
+                _startTimeUSecs = record.timeUSecs;
+            }
+            // Keep entry times monotonic so binary search works even with small timestamp hiccups in the log
+            const quint64 entryTimeUSecs = _entries.isEmpty() ? record.timeUSecs : qMax(record.timeUSecs, _entries.last().timeUSecs);
+            if (recordOffset - lastEntryOffset >= indexStrideBytes) {
+                _entries.append({ entryTimeUSecs, recordOffset });
+                lastEntryOffset = recordOffset;
+            }
+
+            lastRecord = record;
+            lastRecord.offset = recordOffset;
+            lastRecord.frameOffset += windowStart;
+            haveRecord = true;
+
+            pos = record.endOffset();
+        }
+
+        file.unmap(const_cast<uchar*>(window));
+        windowStart += pos;
+        if (lastWindow) {
+            break;
+        }
+    }
+
+    if (!haveRecord) {
+        return false;
+    }
+
+    // Always index the final record so the end of the log can be reached directly
+    if (_entries.last().offset != lastRecord.offset) {
+        _entries.append({ qMax(lastRecord.timeUSecs, _entries.last().timeUSecs), lastRecord.offset });
+    }
+    _endTimeUSecs = lastRecord.timeUSecs;
+
+    return true;
+}
+
+qint64 TLogIndex::offsetForTime(quint64 timeUSecs) const
+{
+    if (_entries.isEmpty()) {
+        return 0;
+    }
+
+    auto it = std::upper_bound(_entries.cbegin(), _entries.cend(), timeUSecs, [](quint64 time, const Entry& entry) {
+        return time < entry.timeUSecs;
+    });
+    if (it != _entries.cbegin()) {
+        --it;
+    }
+
+    return it->offset;
+}
+
+bool TLogIndex::findRecord(QFile& file, quint64 timeUSecs, Record& record) const
+{
+    qint64 bufferOffset = offsetForTime(timeUSecs);
+
+    while (bufferOffset < file.size()) {
+        if (!file.seek(bufferOffset)) {
+            return false;
+        }
+        const QByteArray buffer = file.read(indexStrideBytes + (2 * kMaxRecordSize));
+        if (buffer.isEmpty()) {
+            return false;
+        }
+        const uchar* const data = reinterpret_cast<const uchar*>(buffer.constData());
+        const bool atEnd = (bufferOffset + buffer.size()) >= file.size();
+        const qint64 scanEnd = atEnd ? buffer.size() : (buffer.size() - kMaxRecordSize);
+
+        qint64 pos = 0;
+        while (pos < scanEnd && nextRecord(data, buffer.size(), pos, record)) {
+            if (record.timeUSecs >= timeUSecs) {
+                record.offset += bufferOffset;
+                record.frameOffset += bufferOffset;
+                return true;
+            }
+            pos = record.endOffset();
+        }
+
+        if (atEnd) {
+            break;
+        }
+        bufferOffset += qMax(pos, scanEnd);
+    }
+
+    return false;
+}
+
+quint64 TLogIndex::parseTimestamp(const uchar* bytes)
+{
+    quint64 timestamp = qFromBigEndian<quint64>(bytes);
+    const quint64 currentTimestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
+
+    // Now if the parsed timestamp is in the future, it must be an old file where the timestamp was stored as
+    // little endian, so switch it.
+    if (timestamp > currentTimestamp) {
+        timestamp = qbswap(timestamp);
+    }
+
+    return timestamp;
+}
+
+bool TLogIndex::readRecord(const uchar* data, qint64 size, qint64 offset, bool checkCrc, Record& record)
+{
+    if ((offset < 0) || ((offset + cbTimestamp + MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1) > size)) {
+        return false;
+    }
+
+    const uchar* const frame = data + offset + cbTimestamp;
+    const qint64 available = size - offset - cbTimestamp;
+
+    int headerLength;
+    int signatureLength = 0;
+    uint32_t msgid;
+    if (frame[0] == MAVLINK_STX) {
+        headerLength = MAVLINK_CORE_HEADER_LEN + 1;
+        if (available < headerLength) {
+            return false;
+        }
+        if (frame[2] & MAVLINK_IFLAG_SIGNED) {
+            signatureLength = MAVLINK_SIGNATURE_BLOCK_LEN;
+        }
+        msgid = frame[7] | (frame[8] << 8) | (static_cast<uint32_t>(frame[9]) << 16);
+    } else if (frame[0] == MAVLINK_STX_MAVLINK1) {
+        headerLength = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1;
+        msgid = frame[5];
+    } else {
+        return false;
+    }
+
+    const int payloadLength = frame[1];
+    const int frameLength = headerLength + payloadLength + MAVLINK_NUM_CHECKSUM_BYTES + signatureLength;
+    if (frameLength > available) {
+        return false;
+    }
+
+    if (checkCrc) {
+        // Same validation mavlink_parse_char does, unknown messages use a zero crc extra
+        uint16_t crc = crc_calculate(frame + 1, static_cast<uint16_t>(headerLength - 1 + payloadLength));
+        const mavlink_msg_entry_t* const msgEntry = mavlink_get_msg_entry(msgid);
+        crc_accumulate(msgEntry ? msgEntry->crc_extra : 0, &crc);
+        const uint16_t frameCrc = frame[headerLength + payloadLength] | (frame[headerLength + payloadLength + 1] << 8);
+        if (crc != frameCrc) {
+            return false;
+        }
+    }
+
+    record.timeUSecs    = parseTimestamp(data + offset);
+    record.offset       = offset;
+    record.frameOffset  = offset + cbTimestamp;
+    record.frameLength  = frameLength;
+
+    return true;
+}
+
+bool TLogIndex::nextRecord(const uchar* data, qint64 size, qint64 offset, Record& record)
+{
+    for (qint64 candidate = offset; (candidate + cbTimestamp) < size; candidate++) {
+        const uchar magic = data[candidate + cbTimestamp];
+        if (((magic == MAVLINK_STX) || (magic == MAVLINK_STX_MAVLINK1)) && readRecord(data, size, candidate, true /* checkCrc */, record)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TLogIndex::_loadCache(const QString& cacheFileName, qint64 logSize, qint64 logModifiedMSecs)
+{
+    QFile cacheFile(cacheFileName);
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&cacheFile);
+    quint32 magic, version;
+    qint64 cachedLogSize, cachedLogModifiedMSecs;
+    quint64 startTimeUSecs, endTimeUSecs;
+    quint32 entryCount;
+    stream >> magic >> version >> cachedLogSize >> cachedLogModifiedMSecs >> startTimeUSecs >> endTimeUSecs >> entryCount;
+    if ((stream.status() != QDataStream::Ok) || (magic != _cacheMagic) || (version != _cacheVersion) ||
+            (cachedLogSize != logSize) || (cachedLogModifiedMSecs != logModifiedMSecs) || (entryCount == 0)) {
+        qCDebug(TLogIndexLog) << "Ignoring stale or invalid index cache" << cacheFileName;
+        return false;
+    }
+
+    // Don't trust the count for the allocation, it can't exceed what is left in the cache file or one entry per stride
+    const qint64 maxEntriesInFile = (cacheFile.size() - cacheFile.pos()) / _cacheEntrySize;
+    const qint64 maxEntriesForLog = (logSize / indexStrideBytes) + 1;
+    if ((entryCount > maxEntriesInFile) || (entryCount > maxEntriesForLog)) {
+        qCDebug(TLogIndexLog) << "Ignoring corrupt index cache" << cacheFileName << entryCount << "entries";
+        return false;
+    }
+
+    QList<Entry> entries(entryCount);
+    for (Entry& entry: entries) {
+        stream >> entry.timeUSecs >> entry.offset;
+    }
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    _entries = entries;
+    _startTimeUSecs = startTimeUSecs;
+    _endTimeUSecs = endTimeUSecs;
+    return true;
+}
+
+void TLogIndex::_saveCache(const QString& cacheFileName, qint64 logSize, qint64 logModifiedMSecs) const
+{
+    QSaveFile cacheFile(cacheFileName);
+    if (!cacheFile.open(QIODevice::WriteOnly)) {
+        // Read only media is fine, we just rebuild next time
+        qCDebug(TLogIndexLog) << "Unable to write index cache" << cacheFileName << cacheFile.errorString();
+        return;
+    }
+
+    QDataStream stream(&cacheFile);
+    stream << _cacheMagic << _cacheVersion << logSize << logModifiedMSecs << _startTimeUSecs << _endTimeUSecs << static_cast<quint32>(_entries.count());
+    for (const Entry& entry: _entries) {
+        stream << entry.timeUSecs << entry.offset;
+    }
+
+    if (!cacheFile.commit()) {
+        qCDebug(TLogIndexLog) << "Unable to write index cache" << cacheFileName << cacheFile.errorString();
+    }
+}
@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+
+class QFile;
+
+Q_DECLARE_LOGGING_CATEGORY(TLogIndexLog)
+
+/// Sparse timestamp to file offset index for a telemetry log. A telemetry log is a sequence of records, each one a big
+/// endian microsecond timestamp followed by a complete MAVLink frame. The index is built with a memory mapped scan of
+/// the log and cached next to it, so reopening a log only needs to read the small cache file.
+class TLogIndex
+{
+public:
+    struct Entry {
+        quint64 timeUSecs;
+        qint64  offset;             ///< File offset of the record's timestamp
+    };
+
+    struct Record {
+        quint64 timeUSecs = 0;
+        qint64  offset = 0;         ///< File offset of the record's timestamp
+        qint64  frameOffset = 0;    ///< File offset of the MAVLink frame
+        int     frameLength = 0;
+        qint64  endOffset() const { return frameOffset + frameLength; }
+    };
+
+    /// Loads the cached index for @a file or builds and caches it if missing or stale. @a file must be open.
+    bool load(QFile& file);
+
+    bool    isValid         () const { return !_entries.isEmpty(); }
+    quint64 startTimeUSecs  () const { return _startTimeUSecs; }
+    quint64 endTimeUSecs    () const { return _endTimeUSecs; }
+    const QList<Entry>& entries() const { return _entries; }
+
+    /// @return Offset of the last indexed record at or before @a timeUSecs
+    qint64 offsetForTime(quint64 timeUSecs) const;
+
+    /// Finds the first record with a timestamp at or after @a timeUSecs by reading forward from the closest index entry
+    bool findRecord(QFile& file, quint64 timeUSecs, Record& record) const;
+
+    /// Parses a BigEndian quint64 timestamp. Old logs stored little endian timestamps, those are detected and swapped.
+    /// @return A Unix timestamp in microseconds UTC
+    static quint64 parseTimestamp(const uchar* bytes);
+
+    /// Reads the record starting exactly at @a offset of @a data.
+    /// @param checkCrc Validate the frame CRC. Needed when resynchronizing, chained records are trusted by structure.
+    /// @return false if there isn't a complete, valid record at @a offset
+    static bool readRecord(const uchar* data, qint64 size, qint64 offset, bool checkCrc, Record& record);
+
+    /// Finds the next valid record at or after @a offset, skipping over garbage
+    static bool nextRecord(const uchar* data, qint64 size, qint64 offset, Record& record);
+
+    static QString cacheFileName(const QString& logFileName) { return logFileName + QStringLiteral(".qgcidx"); }
+
+    static constexpr int    cbTimestamp = sizeof(quint64);
+    static constexpr qint64 indexStrideBytes = 32 * 1024;   ///< Maximum file distance between index entries
+
+private:
+    bool _build     (QFile& file);
+    bool _loadCache (const QString& cacheFileName, qint64 logSize, qint64 logModifiedMSecs);
+    void _saveCache (const QString& cacheFileName, qint64 logSize, qint64 logModifiedMSecs) const;
+
+    QList<Entry>    _entries;
+    quint64         _startTimeUSecs = 0;
+    quint64         _endTimeUSecs = 0;
+
+    static constexpr quint32 _cacheMagic = 0x51494458;  // "QIDX"
+    static constexpr quint32 _cacheVersion = 1;
+    static constexpr qint64  _cacheEntrySize = sizeof(quint64) + sizeof(qint64);   ///< Serialized size of an Entry
+};
@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TLogWriter.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QtEndian>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+QGC_LOGGING_CATEGORY(TLogWriterLog, "TLogWriterLog")
+
+TLogWriter::TLogWriter(QObject* parent)
+    : QThread(parent)
+{
+    _buffer.resize(defaultBufferSize);
+}
+
+TLogWriter::~TLogWriter()
+{
+    close();
+}
+
+bool TLogWriter::open(const QString& fileName)
+{
+    if (_open) {
+        close();
+    }
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(TLogWriterLog) << "Unable to open" << fileName << _file.errorString();
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&_mutex);
+        _head = 0;
+        _used = 0;
+        _stop = false;
+        _error = false;
+        _droppedFrames = 0;
+    }
+
+    _fileName = fileName;
+    _open = true;
+    start(LowPriority);
+
+    qCDebug(TLogWriterLog) << "Opened" << fileName;
+    return true;
+}
+
+void TLogWriter::close()
+{
+    if (!_open) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&_mutex);
+        _stop = true;
+        _dataAvailable.wakeOne();
+    }
+    wait();
+
+    _file.flush();
+    if (_fsyncPolicy != FsyncNever) {
+        _fsync();
+    }
+    _file.close();
+    _open = false;
+
+    if (_droppedFrames) {
+        qCWarning(TLogWriterLog) << "Dropped" << _droppedFrames << "frames, disk could not keep up" << _fileName;
+    }
+    qCDebug(TLogWriterLog) << "Closed" << _fileName;
+}
+
+bool TLogWriter::append(quint64 timeUsecs, const char* frame, int length)
+{
+    uchar timestamp[sizeof(quint64)];
+    qToBigEndian(timeUsecs, timestamp);
+
+    const qsizetype capacity = _buffer.size();
+    const qsizetype total = static_cast<qsizetype>(sizeof(timestamp)) + length;
+
+    QMutexLocker locker(&_mutex);
+
+    if (_stop || _error) {
+        return false;
+    }
+    if (capacity - _used < total) {
+        _droppedFrames++;
+        return false;
+    }
+
+    // The writer thread only reads the used region, so copying into the free region is safe while it commits
+    char* const data = _buffer.data();
+    auto copyIn = [this, data, capacity](const char* src, qsizetype count) {
+        const qsizetype firstPart = qMin(count, capacity - _head);
+        memcpy(data + _head, src, static_cast<size_t>(firstPart));
+        memcpy(data, src + firstPart, static_cast<size_t>(count - firstPart));
+        _head = (_head + count) % capacity;
+    };
+    copyIn(reinterpret_cast<const char*>(timestamp), sizeof(timestamp));
+    copyIn(frame, length);
+    _used += total;
+
+    if (_used >= _commitThreshold) {
+        _dataAvailable.wakeOne();
+    }
+
+    return true;
+}
+
+void TLogWriter::setBufferSize(int bytes)
+{
+    if (_open) {
+        qCWarning(TLogWriterLog) << "Buffer size can't change while the log is open" << _fileName;
+        return;
+    }
+
+    _buffer.resize(qMax(bytes, 1));
+}
+
+quint64 TLogWriter::droppedFrames() const
+{
+    QMutexLocker locker(&_mutex);
+    return _droppedFrames;
+}
+
+void TLogWriter::run()
+{
+    QMutexLocker locker(&_mutex);
+
+    while (true) {
+        if (!_stop && _used < _commitThreshold) {
+            (void) _dataAvailable.wait(&_mutex, QDeadlineTimer(_commitIntervalMSecs));
+        }
+
+        const qsizetype count = _used;
+        const bool stop = _stop;
+        if (count > 0 && !_error) {
+            // Commit without holding the lock so append never waits on the disk
+            locker.unlock();
+            const bool success = _commit(count);
+            locker.relock();
+
+            _used -= count;
+            if (!success) {
+                _error = true;
+                _used = 0;
+                emit writeError(_fileName);
+            }
+        }
+
+        if (stop) {
+            break;
+        }
+    }
+}
+
+bool TLogWriter::_commit(qsizetype count)
+{
+    const qsizetype capacity = _buffer.size();
+    // _head and _used are only moved forward by append while we commit, the region we read stays put
+    qsizetype tail;
+    {
+        QMutexLocker locker(&_mutex);
+        tail = (_head - _used + capacity) % capacity;
+    }
+
+    const char* const data = _buffer.constData();
+    const qsizetype firstPart = qMin(count, capacity - tail);
+    if (_file.write(data + tail, firstPart) != firstPart) {
+        qCWarning(TLogWriterLog) << "Write failed" << _fileName << _file.errorString();
+        return false;
+    }
+    if ((count > firstPart) && (_file.write(data, count - firstPart) != count - firstPart)) {
+        qCWarning(TLogWriterLog) << "Write failed" << _fileName << _file.errorString();
+        return false;
+    }
+
+    if (!_file.flush()) {
+        qCWarning(TLogWriterLog) << "Flush failed" << _fileName << _file.errorString();
+        return false;
+    }
+    if (_fsyncPolicy == FsyncOnCommit) {
+        _fsync();
+    }
+
+    return true;
+}
+
+void TLogWriter::_fsync()
+{
+    const int handle = _file.handle();
+    if (handle < 0) {
+        return;
+    }
+#ifdef Q_OS_WIN
+    (void) ::_commit(handle);
+#else
+    (void) ::fsync(handle);
+#endif
+}
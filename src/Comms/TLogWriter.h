@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+Q_DECLARE_LOGGING_CATEGORY(TLogWriterLog)
+
+/// Asynchronous telemetry log writer. Timestamped frames are appended to a preallocated ring buffer on the caller's
+/// thread and committed to disk from a background thread in large blocks. append() never waits on the disk. If the
+/// disk falls so far behind that the ring fills up, frames are dropped and counted instead.
+class TLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    /// Values match the AppSettings telemetryLogFsync setting
+    enum FsyncPolicy {
+        FsyncNever = 0,     ///< Leave it to the OS when data reaches the disk
+        FsyncOnCommit = 1,  ///< fsync after every group commit
+        FsyncOnClose = 2,   ///< fsync once when the log is closed
+    };
+
+    TLogWriter(QObject* parent = nullptr);
+    ~TLogWriter();
+
+    /// Opens @a fileName for appending and starts the writer thread
+    bool open(const QString& fileName);
+
+    /// Commits everything still buffered, stops the writer thread and closes the file
+    void close();
+
+    bool isOpen() const { return _open; }
+    QString fileName() const { return _fileName; }
+
+    /// Appends the big endian @a timeUsecs timestamp followed by @a length bytes of @a frame. Thread safe.
+    /// @return false if the frame was dropped because the ring buffer is full
+    bool append(quint64 timeUsecs, const char* frame, int length);
+
+    /// Takes effect with the next open()
+    void setFsyncPolicy(FsyncPolicy policy) { _fsyncPolicy = policy; }
+    FsyncPolicy fsyncPolicy() const { return _fsyncPolicy; }
+
+    /// Size of the ring buffer, only while the log is not open
+    void setBufferSize(int bytes);
+
+    /// Buffered byte count which triggers a commit before the commit interval expires
+    void setCommitThreshold(int bytes) { _commitThreshold = bytes; }
+    /// Maximum time frames sit in the buffer before being committed
+    void setCommitIntervalMSecs(int msecs) { _commitIntervalMSecs = msecs; }
+
+    quint64 droppedFrames() const;
+
+    static constexpr int defaultBufferSize = 4 * 1024 * 1024;
+
+signals:
+    /// Emitted from the writer thread if a write to the file fails. The writer stops committing after an error.
+    void writeError(const QString& fileName);
+
+protected:
+    // QThread overrides
+    void run() override;
+
+private:
+    friend class TLogWriterTest; // Unit test
+
+    bool _commit(qsizetype count);
+    void _fsync();
+
+    QFile           _file;
+    QString         _fileName;
+    bool            _open = false;
+
+    QByteArray      _buffer;                ///< Preallocated ring buffer
+    qsizetype       _head = 0;              ///< Next write position, guarded by _mutex
+    qsizetype       _used = 0;              ///< Bytes waiting for commit, guarded by _mutex
+    bool            _stop = false;          ///< Guarded by _mutex
+    bool            _error = false;         ///< Guarded by _mutex
+    quint64         _droppedFrames = 0;     ///< Guarded by _mutex
+
+    FsyncPolicy     _fsyncPolicy = FsyncOnClose;
+    int             _commitThreshold = 256 * 1024;
+    int             _commitIntervalMSecs = 1000;
+
+    mutable QMutex  _mutex;
+    QWaitCondition  _dataAvailable;
+};
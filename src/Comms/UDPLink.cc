@@ -12,6 +12,7 @@
 #include "SettingsManager.h"
 #include "AutoConnectSettings.h"
 #include "DeviceInfo.h"
+#include "QGCLoggingCategory.h"
 
 #include <QtCore/QList>
 #include <QtCore/QMutexLocker>
@@ -20,6 +21,8 @@
 #include <QtNetwork/QHostInfo>
 #include <QtNetwork/QUdpSocket>
 
+QGC_LOGGING_CATEGORY(UDPLinkLog, "UDPLinkLog")
+
 static bool is_ip(const QString& address)
 {
     int a,b,c,d;
@@ -76,7 +79,15 @@ UDPLink::UDPLink(SharedLinkConfigurationPtr& config)
     auto allAddresses = QNetworkInterface::allAddresses();
     for (int i=0; i<allAddresses.count(); i++) {
         QHostAddress &address = allAddresses[i];
-        _localAddresses.append(QHostAddress(address));
+        _localAddresses.insert(QHostAddress(address));
+    }
+    _sessionClock.start();
+    if (_udpConfig) {
+        (void) connect(_udpConfig, &UDPConfiguration::hostListChanged, this, [this]() {
+            QMutexLocker locker(&_sessionTargetsMutex);
+            _updateWriteTargets();
+        });
+        _updateWriteTargets();
     }
     moveToThread(this);
 }
@@ -87,8 +98,8 @@ UDPLink::~UDPLink()
     // Tell the thread to exit
     _running = false;
     // Clear client list
-    qDeleteAll(_sessionTargets);
     _sessionTargets.clear();
+    _writeTargets.clear();
     quit();
     // Wait for it to exit
     wait();
@@ -120,16 +131,9 @@ bool UDPLink::_isIpLocal(const QHostAddress& add)
     // IP address in string representation matches the source IP address
     //
     // On Windows, this is a very expensive call only Redmond would know
-    // why. As such, we make it once and keep the list locally. If a new
-    // interface shows up after we start, it won't be on this list.
-    for (int i=0; i<_localAddresses.count(); i++) {
-        QHostAddress &address = _localAddresses[i];
-        if (address == add) {
-            // This is a local address of the same host
-            return true;
-        }
-    }
-    return false;
+    // why. As such, we make it once and keep the set locally. If a new
+    // interface shows up after we start, it won't be in this set.
+    return _localAddresses.contains(add);
 }
 
 void UDPLink::_writeBytes(const QByteArray &data)
@@ -141,25 +145,59 @@ void UDPLink::_writeBytes(const QByteArray &data)
 
     QMutexLocker locker(&_sessionTargetsMutex);
 
-    // Send to all manually targeted systems
-    for (int i=0; i<_udpConfig->targetHosts().count(); i++) {
-        UDPCLient* target = _udpConfig->targetHosts()[i];
-        // Skip it if it's part of the session clients below
-        if(!contains_target(_sessionTargets, target->address, target->port)) {
-            _writeDataGram(data, target);
-        }
+    const qint64 nowMSecs = _sessionClock.elapsed();
+    if (nowMSecs >= _nextSessionExpiryMSecs) {
+        _expireSessionTargets(nowMSecs);
     }
-    // Send to all connected systems
-    for(UDPCLient* target: _sessionTargets) {
+
+    // Manually targeted systems and connected systems, duplicates were removed when the list was built
+    for (const UDPEndpoint& target: _writeTargets) {
         _writeDataGram(data, target);
     }
 }
 
-void UDPLink::_writeDataGram(const QByteArray data, const UDPCLient* target)
+void UDPLink::_writeDataGram(const QByteArray& data, const UDPEndpoint& target)
+{
+    //qDebug() << "UDP Out" << target.address << target.port;
+    if(_socket->writeDatagram(data, target.address, target.port) < 0) {
+        qWarning() << "Error writing to" << target.address << target.port;
+    }
+}
+
+void UDPLink::_expireSessionTargets(qint64 nowMSecs)
 {
-    //qDebug() << "UDP Out" << target->address << target->port;
-    if(_socket->writeDatagram(data, target->address, target->port) < 0) {
-        qWarning() << "Error writing to" << target->address << target->port;
+    _nextSessionExpiryMSecs = nowMSecs + _sessionExpiryIntervalMSecs;
+
+    bool removed = false;
+    for (auto it = _sessionTargets.begin(); it != _sessionTargets.end();) {
+        if ((nowMSecs - it.value()) > _sessionTargetTimeoutMSecs) {
+            qCDebug(UDPLinkLog) << "Removing stale target" << it.key().address << it.key().port;
+            it = _sessionTargets.erase(it);
+            removed = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (removed) {
+        _updateWriteTargets();
+    }
+}
+
+void UDPLink::_updateWriteTargets()
+{
+    _writeTargets.clear();
+    _writeTargets.reserve(_sessionTargets.count() + _udpConfig->targetHosts().count());
+
+    // Skip configured hosts which are also session peers, so they only get each datagram once
+    for (const UDPCLient* target: _udpConfig->targetHosts()) {
+        const UDPEndpoint endpoint{ target->address, target->port };
+        if (!_sessionTargets.contains(endpoint)) {
+            _writeTargets.append(endpoint);
+        }
+    }
+    for (auto it = _sessionTargets.cbegin(); it != _sessionTargets.cend(); ++it) {
+        _writeTargets.append(it.key());
     }
 }
 
@@ -169,6 +207,7 @@ void UDPLink::readBytes()
         return;
     }
     QByteArray databuffer;
+    const qint64 nowMSecs = _sessionClock.elapsed();
     while (_socket->hasPendingDatagrams())
     {
         QByteArray datagram;
@@ -191,17 +230,23 @@ void UDPLink::readBytes()
         // added to the list and will start receiving datagrams from here. Even a port scanner
         // would trigger this.
         // Add host to broadcast list if not yet present, or update its port
-        QHostAddress asender = sender;
+        UDPEndpoint endpoint{ sender, senderPort };
         if(_isIpLocal(sender)) {
-            asender = QHostAddress(QString("127.0.0.1"));
+            endpoint.address = QHostAddress(QHostAddress::LocalHost);
         }
         QMutexLocker locker(&_sessionTargetsMutex);
-        if (!contains_target(_sessionTargets, asender, senderPort)) {
-            qDebug() << "Adding target" << asender << senderPort;
-            UDPCLient* target = new UDPCLient(asender, senderPort);
-            _sessionTargets.append(target);
+        auto it = _sessionTargets.find(endpoint);
+        if (it != _sessionTargets.end()) {
+            it.value() = nowMSecs;
+        } else {
+            qCDebug(UDPLinkLog) << "Adding target" << endpoint.address << endpoint.port;
+            _sessionTargets.insert(endpoint, nowMSecs);
+            _updateWriteTargets();
         }
-        locker.unlock();
+    }
+    if (nowMSecs >= _nextSessionExpiryMSecs) {
+        QMutexLocker locker(&_sessionTargetsMutex);
+        _expireSessionTargets(nowMSecs);
     }
     //-- Send whatever is left
     if (databuffer.size()) {
@@ -350,9 +395,10 @@ void UDPConfiguration::_copyFrom(const LinkConfiguration *source)
             if(!contains_target(_targetHosts, target->address, target->port)) {
                 UDPCLient* newTarget = new UDPCLient(target);
                 _targetHosts.append(newTarget);
-                _updateHostList();
             }
         }
+        // Also when there are no hosts, so links using this configuration drop the ones they had
+        _updateHostList();
     } else {
         qWarning() << "Internal error";
     }
@@ -14,8 +14,12 @@
 
 #include <QtCore/QString>
 #include <QtCore/QList>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QMutex>
 #include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QLoggingCategory>
 #include <QtNetwork/QHostAddress>
 
 #if defined(QGC_ZEROCONF_ENABLED)
@@ -25,6 +29,8 @@
 class LinkManager;
 class QUdpSocket;
 
+Q_DECLARE_LOGGING_CATEGORY(UDPLinkLog)
+
 class UDPCLient {
 public:
     UDPCLient(const QHostAddress& address_, quint16 port_)
@@ -39,6 +45,19 @@ public:
     quint16         port;
 };
 
+/// Address and port of a UDP peer, used as the session table key
+struct UDPEndpoint {
+    QHostAddress    address;
+    quint16         port = 0;
+
+    bool operator==(const UDPEndpoint& other) const { return (port == other.port) && (address == other.address); }
+};
+
+inline size_t qHash(const UDPEndpoint& endpoint, size_t seed = 0)
+{
+    return qHashMulti(seed, endpoint.address, endpoint.port);
+}
+
 class UDPConfiguration : public LinkConfiguration
 {
     Q_OBJECT
@@ -113,26 +132,38 @@ private slots:
     void _writeBytes(const QByteArray &data) override;
 
 private:
+    friend class UDPLinkTest; // Unit test
 
     // LinkInterface overrides
     bool _connect(void) override;
+    /// Keep coalesced writes within a single unfragmented datagram on typical paths
+    qsizetype _maxCoalescedWriteSize(void) const override { return 1200; }
 
     bool _isIpLocal         (const QHostAddress& add);
     bool _hardwareConnect   (void);
     void _registerZeroconf  (uint16_t port, const std::string& regType);
     void _deregisterZeroconf(void);
-    void _writeDataGram     (const QByteArray data, const UDPCLient* target);
+    void _writeDataGram     (const QByteArray& data, const UDPEndpoint& target);
+    /// Drops session peers which have gone quiet. Must be called with _sessionTargetsMutex held.
+    void _expireSessionTargets(qint64 nowMSecs);
+    /// Rebuilds _writeTargets from the configured hosts and the session peers. Must be called with _sessionTargetsMutex held.
+    void _updateWriteTargets(void);
 
     bool                _running;
     QUdpSocket*         _socket;
     const UDPConfiguration*   _udpConfig;
     bool                _connectState;
-    QList<UDPCLient*>   _sessionTargets;
+    QHash<UDPEndpoint, qint64> _sessionTargets;     ///< Peers we received from, mapped to when they were last heard
+    QList<UDPEndpoint>  _writeTargets;              ///< Configured hosts and session peers, each once
     QMutex              _sessionTargetsMutex;
-    QList<QHostAddress> _localAddresses;
+    QElapsedTimer       _sessionClock;
+    qint64              _nextSessionExpiryMSecs = 0;
+    QSet<QHostAddress>  _localAddresses;
 #if defined(QGC_ZEROCONF_ENABLED)
     DNSServiceRef       _dnssServiceRef;
 #endif
 
     static constexpr const char* kZeroconfRegistration = "_qgroundcontrol._udp";
+    static constexpr qint64 _sessionTargetTimeoutMSecs = 60 * 1000;    ///< Peers not heard from for this long are dropped
+    static constexpr qint64 _sessionExpiryIntervalMSecs = 5 * 1000;
 };
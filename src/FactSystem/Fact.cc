@@ -8,12 +8,16 @@
  ****************************************************************************/
 
 #include "Fact.h"
+#include "FactGroup.h"
 #include "FactValueSliderListModel.h"
 #include "QGCApplication.h"
 #include "QGCCorePlugin.h"
 
 #include <QtQml/QQmlEngine>
 
+#include <limits>
+#include <type_traits>
+
 Fact::Fact(QObject* parent)
     : QObject                   (parent)
     , _componentId              (-1)
@@ -88,11 +92,16 @@ const Fact& Fact::operator=(const Fact& other)
     _rawValue                   = other._rawValue;
     _type                       = other._type;
     _sendValueChangedSignals    = other._sendValueChangedSignals;
+    if (other._deferredValueChangeSignal && !_deferredValueChangeSignal && _updateGroup) {
+        _updateGroup->_factValueDeferred(this);
+    }
     _deferredValueChangeSignal  = other._deferredValueChangeSignal;
     _valueSliderModel           = nullptr;
     _ignoreQGCRebootRequired    = other._ignoreQGCRebootRequired;
-    if (_metaData && other._metaData) {
-        *_metaData = *other._metaData;
+    if (_metaData && other._metaData && other._metaData->isShared()) {
+        _metaData = other._metaData;
+    } else if (_metaData && other._metaData) {
+        *_writableMetaData() = *other._metaData;
     } else {
         _metaData = nullptr;
     }
@@ -138,6 +147,98 @@ void Fact::setRawValue(const QVariant& value)
     }
 }
 
+template<typename T>
+void Fact::_setRawNative(T value)
+{
+    if (_rawValue.metaType() == QMetaType::fromType<T>()) {
+        const T currentValue = *static_cast<const T*>(_rawValue.constData());
+        if (currentValue == value) {
+            return;
+        }
+        if constexpr (std::is_floating_point_v<T>) {
+            // Unset telemetry is NaN, don't signal it over and over
+            if (qIsNaN(currentValue) && qIsNaN(value)) {
+                return;
+            }
+        }
+    }
+
+    _rawValue.setValue(value);
+    _sendValueChangedSignal();
+    //-- Must be in this order
+    emit _containerRawValueChanged(_rawValue);
+    emit rawValueChanged(_rawValue);
+}
+
+void Fact::setRawDouble(double value)
+{
+    if (!_metaData) {
+        setRawValue(value);
+        return;
+    }
+
+    switch (_metaData->type()) {
+    case FactMetaData::valueTypeDouble:
+    case FactMetaData::valueTypeElapsedTimeInSeconds:
+        _setRawNative<double>(value);
+        break;
+    case FactMetaData::valueTypeFloat:
+        _setRawNative<float>(static_cast<float>(value));
+        break;
+    default:
+        setRawValue(value);
+        break;
+    }
+}
+
+void Fact::setRawInt(qint64 value)
+{
+    if (!_metaData) {
+        setRawValue(value);
+        return;
+    }
+
+    // Out of range values take the regular path so they are converted exactly like setRawValue would
+    switch (_metaData->type()) {
+    case FactMetaData::valueTypeInt8:
+    case FactMetaData::valueTypeInt16:
+    case FactMetaData::valueTypeInt32:
+        if ((value >= std::numeric_limits<int>::min()) && (value <= std::numeric_limits<int>::max())) {
+            _setRawNative<int>(static_cast<int>(value));
+            return;
+        }
+        break;
+    case FactMetaData::valueTypeInt64:
+        _setRawNative<qlonglong>(value);
+        return;
+    case FactMetaData::valueTypeUint8:
+    case FactMetaData::valueTypeUint16:
+    case FactMetaData::valueTypeUint32:
+        if ((value >= 0) && (value <= std::numeric_limits<uint>::max())) {
+            _setRawNative<uint>(static_cast<uint>(value));
+            return;
+        }
+        break;
+    case FactMetaData::valueTypeUint64:
+        if (value >= 0) {
+            _setRawNative<qulonglong>(static_cast<qulonglong>(value));
+            return;
+        }
+        break;
+    case FactMetaData::valueTypeFloat:
+        _setRawNative<float>(static_cast<float>(value));
+        return;
+    case FactMetaData::valueTypeDouble:
+    case FactMetaData::valueTypeElapsedTimeInSeconds:
+        _setRawNative<double>(static_cast<double>(value));
+        return;
+    default:
+        break;
+    }
+
+    setRawValue(value);
+}
+
 void Fact::setCookedValue(const QVariant& value)
 {
     if (_metaData) {
@@ -240,7 +341,7 @@ int Fact::enumIndex(void)
                 index ++;
             }
             // Current value is not in list, add it manually
-            _metaData->addEnumInfo(tr("Unknown: %1").arg(rawValue().toString()), rawValue());
+            _writableMetaData()->addEnumInfo(tr("Unknown: %1").arg(rawValue().toString()), rawValue());
             emit enumsChanged();
             return index;
         }
@@ -273,7 +374,7 @@ QVariantList Fact::enumValues(void) const
 void Fact::setEnumInfo(const QStringList& strings, const QVariantList& values)
 {
     if (_metaData) {
-        _metaData->setEnumInfo(strings, values);
+        _writableMetaData()->setEnumInfo(strings, values);
         emit enumsChanged();
     } else {
         qWarning() << kMissingMetadata << name();
@@ -582,6 +683,15 @@ void Fact::setMetaData(FactMetaData* metaData, bool setDefaultFromMetaData)
     emit valueChanged(cookedValue());
 }
 
+FactMetaData* Fact::_writableMetaData(void)
+{
+    // Shared meta data is copied on first write so the change stays local to this fact
+    if (_metaData && _metaData->isShared()) {
+        _metaData = new FactMetaData(*_metaData, this);
+    }
+    return _metaData;
+}
+
 bool Fact::valueEqualsDefault(void) const
 {
     if (_metaData) {
@@ -673,6 +783,23 @@ void Fact::_sendValueChangedSignal(QVariant value)
         emit valueChanged(value);
         _deferredValueChangeSignal = false;
     } else {
+        if (!_deferredValueChangeSignal && _updateGroup) {
+            _updateGroup->_factValueDeferred(this);
+        }
+        _deferredValueChangeSignal = true;
+    }
+}
+
+void Fact::_sendValueChangedSignal(void)
+{
+    if (_sendValueChangedSignals) {
+        emit valueChanged(cookedValue());
+        _deferredValueChangeSignal = false;
+    } else {
+        // The cooked value is translated by sendDeferredValueChangedSignal once the update goes out
+        if (!_deferredValueChangeSignal && _updateGroup) {
+            _updateGroup->_factValueDeferred(this);
+        }
         _deferredValueChangeSignal = true;
     }
 }
@@ -16,12 +16,15 @@
 #include "FactMetaData.h"
 
 class FactValueSliderListModel;
+class FactGroup;
 
 /// @brief A Fact is used to hold a single value within the system.
 class Fact : public QObject
 {
     Q_OBJECT
-    
+
+    friend class FactGroup; // Sets _updateGroup
+
 public:
     Fact(QObject* parent = nullptr);
     Fact(int componentId, QString name, FactMetaData::ValueType_t type, QObject* parent = nullptr);
@@ -136,6 +139,13 @@ public:
 
     void setRawValue        (const QVariant& value);
     void setCookedValue     (const QVariant& value);
+
+    /// Typed setters for high rate telemetry. A value which already matches the fact's storage type is compared and
+    /// stored natively without going through meta data conversion. The cooked value is only translated when the
+    /// valueChanged signal is actually sent, so rate limited facts translate once per update instead of per sample.
+    /// Anything else falls back to setRawValue.
+    void setRawDouble       (double value);
+    void setRawInt          (qint64 value);
     void setEnumIndex       (int index);
     void setEnumStringValue (const QString& value);
     int  valueIndex         (const QString& value);
@@ -159,6 +169,7 @@ public:
     ///     @param setDefaultFromMetaData true: set the fact value to the default specified in the meta data
     void setMetaData(FactMetaData* metaData, bool setDefaultFromMetaData = false);
     
+    /// Meta data can be shared between facts, see FactMetaData::isShared. Shared meta data must not be modified.
     FactMetaData* metaData() { return _metaData; }
 
     //-- Value coming from Vehicle. This does NOT send a _containerRawValueChanged signal.
@@ -195,6 +206,9 @@ private slots:
 
 private:
     void _init(void);
+    template<typename T> void _setRawNative(T value);
+    FactMetaData* _writableMetaData(void);
+    void _sendValueChangedSignal(void);
     
 protected:
     QString _variantToString(const QVariant& variant, int decimalPlaces) const;
@@ -209,6 +223,7 @@ protected:
     bool                        _deferredValueChangeSignal;
     FactValueSliderListModel*   _valueSliderModel;
     bool                        _ignoreQGCRebootRequired;
+    FactGroup*                  _updateGroup = nullptr;     ///< Rate limited group which sends our deferred value changes
 
     static constexpr const char* kMissingMetadata = "Meta data pointer missing";
 };
@@ -9,6 +9,7 @@
 
 
 #include "FactGroup.h"
+#include "FactUpdateScheduler.h"
 
 #include <QtQml/QQmlEngine>
 
@@ -17,8 +18,7 @@ FactGroup::FactGroup(int updateRateMsecs, const QString& metaDataFile, QObject*
     , _updateRateMSecs(updateRateMsecs)
     , _ignoreCamelCase(ignoreCamelCase)
 {
-    _setupTimer();
-    _nameToFactMetaDataMap = FactMetaData::createMapFromJsonFile(metaDataFile, this);
+    _nameToFactMetaDataMap = FactMetaData::sharedMapFromJsonFile(metaDataFile);
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
 }
 
@@ -27,24 +27,20 @@ FactGroup::FactGroup(int updateRateMsecs, QObject* parent, bool ignoreCamelCase)
     , _updateRateMSecs(updateRateMsecs)
     , _ignoreCamelCase(ignoreCamelCase)
 {
-    _setupTimer();
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
 }
 
-void FactGroup::_loadFromJsonArray(const QJsonArray jsonArray)
+FactGroup::~FactGroup()
 {
-    QMap<QString, QString> defineMap;
-    _nameToFactMetaDataMap = FactMetaData::createMapFromJsonArray(jsonArray, defineMap, this);
+    if (_updateRateMSecs > 0) {
+        FactUpdateScheduler::instance()->cancelUpdate(this);
+    }
 }
 
-void FactGroup::_setupTimer()
+void FactGroup::_loadFromJsonArray(const QJsonArray jsonArray)
 {
-    if (_updateRateMSecs > 0) {
-        connect(&_updateTimer, &QTimer::timeout, this, &FactGroup::_updateAllValues);
-        _updateTimer.setSingleShot(false);
-        _updateTimer.setInterval(_updateRateMSecs);
-        _updateTimer.start();
-    }
+    QMap<QString, QString> defineMap;
+    _nameToFactMetaDataMap = FactMetaData::createMapFromJsonArray(jsonArray, defineMap, this);
 }
 
 bool FactGroup::factExists(const QString& name)
@@ -124,6 +120,7 @@ void FactGroup::_addFact(Fact* fact, const QString& name)
     }
 
     fact->setSendValueChangedSignals(_updateRateMSecs == 0);
+    fact->_updateGroup = this;
     if (_nameToFactMetaDataMap.contains(name)) {
         fact->setMetaData(_nameToFactMetaDataMap[name], true /* setDefaultFromMetaData */);
     }
@@ -147,21 +144,49 @@ void FactGroup::_addFactGroup(FactGroup* factGroup, const QString& name)
 
 void FactGroup::_updateAllValues(void)
 {
-    for(Fact* fact: _nameToFactMap) {
+    // Only the facts which changed since the last update
+    QList<Fact*> deferredFacts;
+    deferredFacts.swap(_deferredFacts);
+    for(Fact* fact: deferredFacts) {
         fact->sendDeferredValueChangedSignal();
     }
 }
 
+void FactGroup::_factValueDeferred(Fact* fact)
+{
+    _deferredFacts.append(fact);
+    if (!_liveUpdates) {
+        FactUpdateScheduler::instance()->scheduleUpdate(this, _updateRateMSecs);
+    }
+}
+
+void FactGroup::_scheduledUpdate(void)
+{
+    _updateAllValues();
+    if (_periodicUpdates && !_liveUpdates) {
+        FactUpdateScheduler::instance()->scheduleUpdate(this, _updateRateMSecs);
+    }
+}
+
+void FactGroup::_setPeriodicUpdates(bool periodicUpdates)
+{
+    _periodicUpdates = periodicUpdates;
+    if (_periodicUpdates && !_liveUpdates && (_updateRateMSecs > 0)) {
+        FactUpdateScheduler::instance()->scheduleUpdate(this, _updateRateMSecs);
+    }
+}
+
 void FactGroup::setLiveUpdates(bool liveUpdates)
 {
-    if (_updateTimer.interval() == 0) {
+    if (_updateRateMSecs == 0) {
         return;
     }
 
+    _liveUpdates = liveUpdates;
     if (liveUpdates) {
-        _updateTimer.stop();
-    } else {
-        _updateTimer.start();
+        FactUpdateScheduler::instance()->cancelUpdate(this);
+    } else if (_periodicUpdates || !_deferredFacts.isEmpty()) {
+        FactUpdateScheduler::instance()->scheduleUpdate(this, _updateRateMSecs);
     }
     for(Fact* fact: _nameToFactMap) {
         fact->setSendValueChangedSignals(liveUpdates);
@@ -23,10 +23,14 @@ class Vehicle;
 class FactGroup : public QObject
 {
     Q_OBJECT
-    
+
+    friend class Fact;                  // Reports deferred value changes through _factValueDeferred
+    friend class FactUpdateScheduler;   // Calls _scheduledUpdate
+
 public:
     FactGroup(int updateRateMsecs, const QString& metaDataFile, QObject* parent = nullptr, bool ignoreCamelCase = false);
     FactGroup(int updateRateMsecs, QObject* parent = nullptr, bool ignoreCamelCase = false);
+    ~FactGroup();
 
     Q_PROPERTY(QStringList  factNames           READ factNames          NOTIFY factNamesChanged)
     Q_PROPERTY(QStringList  factGroupNames      READ factGroupNames     NOTIFY factGroupNamesChanged)
@@ -54,6 +58,12 @@ public:
     /// Allows a FactGroup to parse incoming messages and fill in values
     virtual void handleMessage(Vehicle* vehicle, mavlink_message_t& message);
 
+    /// @return Message ids handleMessage consumes, Vehicle only dispatches those to the group. The default of
+    ///         allMessageIds keeps groups which don't declare their ids seeing all traffic.
+    virtual QList<uint32_t> handledMessageIds() const { return { allMessageIds }; }
+
+    static constexpr uint32_t allMessageIds = UINT32_MAX;
+
 signals:
     void factNamesChanged           (void);
     void factGroupNamesChanged      (void);
@@ -67,6 +77,8 @@ protected:
     void _addFactGroup          (FactGroup* factGroup, const QString& name);
     void _loadFromJsonArray     (const QJsonArray jsonArray);
     void _setTelemetryAvailable (bool telemetryAvailable);
+    /// Update the group at its update rate even without changed values, for groups which produce values in _updateAllValues
+    void _setPeriodicUpdates    (bool periodicUpdates);
 
     int  _updateRateMSecs;   ///< Update rate for Fact::valueChanged signals, 0: immediate update
 
@@ -76,10 +88,13 @@ protected:
     QStringList                     _factNames;
 
 private:
-    void    _setupTimer (void);
-    QString _camelCase  (const QString& text);
-
-    bool    _ignoreCamelCase    = false;
-    QTimer  _updateTimer;
-    bool    _telemetryAvailable = false;
+    QString _camelCase          (const QString& text);
+    void    _factValueDeferred  (Fact* fact);
+    void    _scheduledUpdate    (void);
+
+    bool        _ignoreCamelCase    = false;
+    bool        _liveUpdates        = false;
+    bool        _periodicUpdates    = false;
+    bool        _telemetryAvailable = false;
+    QList<Fact*> _deferredFacts;            ///< Facts with a value change waiting for the next update
 };
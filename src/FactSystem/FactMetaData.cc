@@ -8,12 +8,28 @@
  ****************************************************************************/
 
 #include "FactMetaData.h"
+#include "Fact.h"
 #include "SettingsManager.h"
 #include "JsonHelper.h"
 #include "QGCApplication.h"
 #include <MAVLinkLib.h>
 
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
 #include <QtCore/QtMath>
+#include <QtCore/qapplicationstatic.h>
+
+namespace {
+    /// Meta data shared through FactMetaData::sharedMapFromJsonFile. Only used from the main thread.
+    struct SharedMetaDataCache {
+        QObject                                                         owner;          ///< Parent of all shared meta data
+        QHash<QString, QMap<QString, FactMetaData*>>                    fileMaps;
+        QHash<QPair<const FactMetaData*, QString>, FactMetaData*>       variants;
+        QPointer<UnitsSettings>                                         unitsSettings;  ///< Settings the cache watches for unit changes
+    };
+}
+
+Q_APPLICATION_STATIC(SharedMetaDataCache, _sharedMetaDataCache);
 
 // Built in translations for all Facts
 const FactMetaData::BuiltInTranslation_s FactMetaData::_rgBuiltInTranslations[] = {
@@ -1410,6 +1426,62 @@ QMap<QString, FactMetaData*> FactMetaData::createMapFromJsonFile(const QString&
     return createMapFromJsonArray(factArray, defineMap, metaDataParent);
 }
 
+QMap<QString, FactMetaData*> FactMetaData::sharedMapFromJsonFile(const QString& jsonFilename)
+{
+    SharedMetaDataCache* const cache = _sharedMetaDataCache();
+
+    UnitsSettings* const unitsSettings = qgcApp()->toolbox()->settingsManager()->unitsSettings();
+    if (cache->unitsSettings != unitsSettings) {
+        cache->unitsSettings = unitsSettings;
+        const QList<Fact*> unitsFacts = {
+            unitsSettings->horizontalDistanceUnits(),
+            unitsSettings->verticalDistanceUnits(),
+            unitsSettings->areaUnits(),
+            unitsSettings->speedUnits(),
+            unitsSettings->temperatureUnits(),
+            unitsSettings->weightUnits(),
+        };
+        for (Fact* fact: unitsFacts) {
+            // Facts already using the old meta data keep it, it stays owned by the cache
+            (void) connect(fact, &Fact::rawValueChanged, &cache->owner, [cache]() {
+                cache->fileMaps.clear();
+                cache->variants.clear();
+            });
+        }
+    }
+
+    const auto it = cache->fileMaps.constFind(jsonFilename);
+    if (it != cache->fileMaps.constEnd()) {
+        return it.value();
+    }
+
+    const QMap<QString, FactMetaData*> metaDataMap = createMapFromJsonFile(jsonFilename, &cache->owner);
+    for (FactMetaData* metaData: metaDataMap) {
+        metaData->_shared = true;
+    }
+    cache->fileMaps.insert(jsonFilename, metaDataMap);
+
+    return metaDataMap;
+}
+
+FactMetaData* FactMetaData::sharedVariant(FactMetaData* metaData, const QString& variant, const std::function<void(FactMetaData*)>& adjust)
+{
+    if (!metaData->_shared) {
+        adjust(metaData);
+        return metaData;
+    }
+
+    SharedMetaDataCache* const cache = _sharedMetaDataCache();
+    FactMetaData*& variantMetaData = cache->variants[qMakePair(static_cast<const FactMetaData*>(metaData), variant)];
+    if (!variantMetaData) {
+        variantMetaData = new FactMetaData(*metaData, &cache->owner);
+        adjust(variantMetaData);
+        variantMetaData->_shared = true;
+    }
+
+    return variantMetaData;
+}
+
 QMap<QString, FactMetaData*> FactMetaData::createMapFromJsonArray(const QJsonArray jsonArray, QMap<QString, QString>& defineMap, QObject* metaDataParent)
 {
     QMap<QString, FactMetaData*> metaDataMap;
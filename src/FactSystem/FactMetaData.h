@@ -15,6 +15,8 @@
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonObject>
 
+#include <functional>
+
 /// Holds the meta data associated with a Fact.
 ///
 /// Holds the meta data associated with a Fact. This is kept in a separate object from the Fact itself
@@ -62,6 +64,16 @@ public:
 
     static FactMetaData* createFromJsonObject(const QJsonObject& json, QMap<QString, QString>& defineMap, QObject* metaDataParent);
 
+    /// Same as createMapFromJsonFile, but each json file is only parsed once and the meta data is shared by all callers
+    /// for the rest of the session. Shared meta data is read only, Fact makes a private copy before modifying it. The
+    /// cache is dropped when a units setting changes since unit translators are picked while parsing.
+    static QMap<QString, FactMetaData*> sharedMapFromJsonFile(const QString& jsonFilename);
+
+    /// Applies @a adjust to a shared copy of @a metaData which is only created once for each @a variant. Meta data which
+    /// isn't shared is adjusted in place.
+    /// @return Adjusted meta data
+    static FactMetaData* sharedVariant(FactMetaData* metaData, const QString& variant, const std::function<void(FactMetaData*)>& adjust);
+
     const FactMetaData& operator=(const FactMetaData& other);
 
     /// Converts from meters to the user specified horizontal distance unit
@@ -140,6 +152,7 @@ public:
     bool            readOnly                (void) const { return _readOnly; }
     bool            writeOnly               (void) const { return _writeOnly; }
     bool            volatileValue           (void) const { return _volatile; }
+    bool            isShared                (void) const { return _shared; }    ///< true: read only, shared by multiple facts
 
     /// Amount to increment value when used in controls such as spin button or slider with detents.
     /// NaN for no increment available.
@@ -338,6 +351,7 @@ private:
     bool            _readOnly;
     bool            _writeOnly;
     bool            _volatile;
+    bool            _shared = false;
     CustomCookedValidator _customCookedValidator = nullptr;
 
     // Exact conversion constants
@@ -0,0 +1,110 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactUpdateScheduler.h"
+#include "FactGroup.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/qapplicationstatic.h>
+#include <QtCore/QPointer>
+
+QGC_LOGGING_CATEGORY(FactUpdateSchedulerLog, "FactUpdateSchedulerLog")
+
+Q_APPLICATION_STATIC(FactUpdateScheduler, _factUpdateSchedulerInstance);
+
+FactUpdateScheduler::FactUpdateScheduler(QObject* parent)
+    : QObject(parent)
+{
+    _clock.start();
+    _timer.setSingleShot(true);
+    _timer.setTimerType(Qt::PreciseTimer);
+    (void) connect(&_timer, &QTimer::timeout, this, &FactUpdateScheduler::_tick);
+}
+
+FactUpdateScheduler::~FactUpdateScheduler()
+{
+
+}
+
+FactUpdateScheduler* FactUpdateScheduler::instance()
+{
+    return _factUpdateSchedulerInstance();
+}
+
+void FactUpdateScheduler::scheduleUpdate(FactGroup* factGroup, int updateRateMSecs)
+{
+    if ((updateRateMSecs <= 0) || _dueMSecs.contains(factGroup)) {
+        return;
+    }
+
+    // Next point on the group's rate grid, rounded up to a tick
+    const qint64 nowMSecs = _clock.elapsed();
+    qint64 dueMSecs = ((nowMSecs / updateRateMSecs) + 1) * updateRateMSecs;
+    dueMSecs = ((dueMSecs + _tickMSecs - 1) / _tickMSecs) * _tickMSecs;
+    _dueMSecs.insert(factGroup, dueMSecs);
+
+    if ((_timerDueMSecs < 0) || (dueMSecs < _timerDueMSecs)) {
+        _timerDueMSecs = dueMSecs;
+        _timer.start(static_cast<int>(dueMSecs - nowMSecs));
+    }
+}
+
+void FactUpdateScheduler::cancelUpdate(FactGroup* factGroup)
+{
+    (void) _dueMSecs.remove(factGroup);
+    if (_dueMSecs.isEmpty()) {
+        _timer.stop();
+        _timerDueMSecs = -1;
+    }
+}
+
+void FactUpdateScheduler::_tick()
+{
+    const qint64 nowMSecs = _clock.elapsed();
+    _timerDueMSecs = -1;
+
+    QList<QPointer<FactGroup>> dueGroups;
+    for (auto it = _dueMSecs.begin(); it != _dueMSecs.end();) {
+        if (it.value() <= nowMSecs) {
+            dueGroups.append(it.key());
+            it = _dueMSecs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    qCDebug(FactUpdateSchedulerLog) << "Updating" << dueGroups.count() << "groups," << _dueMSecs.count() << "still scheduled";
+
+    // Value changes can end up deleting other groups in this pass
+    for (const QPointer<FactGroup>& factGroup : dueGroups) {
+        if (factGroup) {
+            factGroup->_scheduledUpdate();
+        }
+    }
+
+    _startTimer(_clock.elapsed());
+}
+
+void FactUpdateScheduler::_startTimer(qint64 nowMSecs)
+{
+    qint64 nextDueMSecs = -1;
+    for (const qint64 dueMSecs : _dueMSecs) {
+        if ((nextDueMSecs < 0) || (dueMSecs < nextDueMSecs)) {
+            nextDueMSecs = dueMSecs;
+        }
+    }
+    if (nextDueMSecs < 0) {
+        _timer.stop();
+        _timerDueMSecs = -1;
+        return;
+    }
+
+    _timerDueMSecs = nextDueMSecs;
+    _timer.start(static_cast<int>(qMax<qint64>(0, nextDueMSecs - nowMSecs)));
+}
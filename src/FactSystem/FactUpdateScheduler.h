@@ -0,0 +1,60 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+class FactGroup;
+
+Q_DECLARE_LOGGING_CATEGORY(FactUpdateSchedulerLog)
+
+/// Sends the deferred value changes of all rate limited FactGroups from a single timer. A FactGroup is only scheduled
+/// while it has changed values waiting. Update times are aligned to a grid of the group's update rate, rounded up to
+/// the scheduler tick, so groups with the same rate flush together in one pass no matter how many vehicles there are.
+class FactUpdateScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FactUpdateScheduler(QObject* parent = nullptr);
+    ~FactUpdateScheduler();
+
+    static FactUpdateScheduler* instance();
+
+    /// Schedules the next update of @a factGroup at its update rate. Does nothing if it is already scheduled.
+    void scheduleUpdate(FactGroup* factGroup, int updateRateMSecs);
+
+    /// Removes @a factGroup from the schedule
+    void cancelUpdate(FactGroup* factGroup);
+
+    /// Granularity of update times, defaults to one 60Hz display frame
+    void setTickMSecs(int tickMSecs) { _tickMSecs = qMax(tickMSecs, 1); }
+    int tickMSecs() const { return _tickMSecs; }
+
+    int scheduledCount() const { return _dueMSecs.count(); }
+
+    static constexpr int defaultTickMSecs = 16;
+
+private slots:
+    void _tick();
+
+private:
+    void _startTimer(qint64 nowMSecs);
+
+    QTimer                      _timer;
+    QElapsedTimer               _clock;
+    QHash<FactGroup*, qint64>   _dueMSecs;          ///< Scheduled groups and when they are due
+    qint64                      _timerDueMSecs = -1;
+    int                         _tickMSecs = defaultTickMSecs;
+};
@@ -0,0 +1,274 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterCacheFile.h"
+#include "QGC.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(ParameterCacheFileLog, "ParameterCacheFileLog")
+
+ParameterCacheFile::~ParameterCacheFile()
+{
+    _close();
+}
+
+void ParameterCacheFile::_close()
+{
+    if (_file.isOpen()) {
+        if (_data) {
+            (void) _file.unmap(const_cast<uchar*>(_data));
+        }
+        _file.close();
+    }
+    _data = nullptr;
+    _parameterCount = 0;
+    _hash = 0;
+}
+
+bool ParameterCacheFile::load(const QString& fileName)
+{
+    _close();
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = _file.size();
+    const uchar* const data = (size >= static_cast<qint64>(sizeof(Header))) ? _file.map(0, size) : nullptr;
+    if (!data) {
+        _file.close();
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, data, sizeof(header));
+    const quint64 recordsEnd = static_cast<quint64>(header.recordsOffset) + (static_cast<quint64>(header.parameterCount) * sizeof(Record));
+    const quint64 stringsEnd = static_cast<quint64>(header.stringsOffset) + header.stringsSize;
+    if ((header.magic != _magic) || (header.formatVersion != _formatVersion) ||
+            (recordsEnd > static_cast<quint64>(size)) || (stringsEnd > static_cast<quint64>(size))) {
+        qCDebug(ParameterCacheFileLog) << "Ignoring cache from another version or corrupt cache" << fileName;
+        (void) _file.unmap(const_cast<uchar*>(data));
+        _file.close();
+        return false;
+    }
+
+    _data           = data;
+    _parameterCount = header.parameterCount;
+    _hash           = header.hash;
+    _recordsOffset  = header.recordsOffset;
+    _stringsOffset  = header.stringsOffset;
+    _stringsSize    = header.stringsSize;
+
+    qCDebug(ParameterCacheFileLog) << "Mapped" << _parameterCount << "parameters from" << fileName << "hash" << _hash;
+    return true;
+}
+
+ParameterCacheFile::Entry ParameterCacheFile::entry(int index) const
+{
+    Entry entry;
+    if (!_data || (index < 0) || (index >= count())) {
+        return entry;
+    }
+
+    // Mapped data has no alignment guarantees for the structure, copy it out
+    Record record;
+    memcpy(&record, _data + _recordsOffset + (static_cast<quint32>(index) * sizeof(Record)), sizeof(record));
+
+    if ((static_cast<quint64>(record.nameOffset) + record.nameLength) <= _stringsSize) {
+        entry.name = QString::fromUtf8(reinterpret_cast<const char*>(_data + _stringsOffset + record.nameOffset), record.nameLength);
+    }
+    entry.type          = static_cast<FactMetaData::ValueType_t>(record.type);
+    entry.value         = _decodeValue(entry.type, record.value);
+    entry.volatileValue = record.flags & FlagVolatile;
+
+    return entry;
+}
+
+bool ParameterCacheFile::save(const QString& fileName, const QList<Entry>& entries)
+{
+    // The firmware hashes the parameters in name order
+    QList<Entry> sorted;
+    sorted.reserve(entries.count());
+    for (const Entry& entry: entries) {
+        if (isCacheableType(entry.type)) {
+            sorted.append(entry);
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Entry& left, const Entry& right) {
+        return left.name < right.name;
+    });
+
+    QByteArray      strings;
+    QList<Record>   records;
+    records.reserve(sorted.count());
+    quint32 hash = 0;
+
+    for (const Entry& entry: sorted) {
+        const QByteArray name8 = entry.name.toUtf8();
+        const QByteArray valueBytes = _encodeValue(entry.type, entry.value);
+
+        Record record;
+        memset(&record, 0, sizeof(record));
+        record.nameOffset   = static_cast<quint32>(strings.size());
+        record.nameLength   = static_cast<quint32>(name8.size());
+        record.type         = entry.type;
+        record.flags        = entry.volatileValue ? FlagVolatile : 0;
+        memcpy(record.value, valueBytes.constData(), valueBytes.size());
+        records.append(record);
+        strings.append(name8);
+
+        if (!entry.volatileValue) {
+            hash = _accumulateHash(hash, entry.name, valueBytes);
+        }
+    }
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    header.magic            = _magic;
+    header.formatVersion    = _formatVersion;
+    header.parameterCount   = static_cast<quint32>(records.count());
+    header.hash             = hash;
+    header.recordsOffset    = sizeof(Header);
+    header.stringsOffset    = header.recordsOffset + static_cast<quint32>(records.count() * sizeof(Record));
+    header.stringsSize      = static_cast<quint32>(strings.size());
+
+    if (!QDir().mkpath(QFileInfo(fileName).absolutePath())) {
+        qCWarning(ParameterCacheFileLog) << "Unable to create cache directory for" << fileName;
+        return false;
+    }
+
+    // Written to a temporary file and renamed so a mapped cache is never modified in place
+    QSaveFile saveFile(fileName);
+    if (!saveFile.open(QIODevice::WriteOnly)) {
+        qCWarning(ParameterCacheFileLog) << "Unable to write cache" << fileName << saveFile.errorString();
+        return false;
+    }
+    (void) saveFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    (void) saveFile.write(reinterpret_cast<const char*>(records.constData()), records.count() * sizeof(Record));
+    (void) saveFile.write(strings);
+    if (!saveFile.commit()) {
+        qCWarning(ParameterCacheFileLog) << "Unable to write cache" << fileName << saveFile.errorString();
+        return false;
+    }
+
+    qCDebug(ParameterCacheFileLog) << "Saved" << records.count() << "parameters to" << fileName << "hash" << hash;
+    return true;
+}
+
+quint32 ParameterCacheFile::computeHash(const QList<Entry>& entries)
+{
+    quint32 hash = 0;
+    for (const Entry& entry: entries) {
+        if (!entry.volatileValue && isCacheableType(entry.type)) {
+            hash = _accumulateHash(hash, entry.name, _encodeValue(entry.type, entry.value));
+        }
+    }
+    return hash;
+}
+
+quint32 ParameterCacheFile::_accumulateHash(quint32 hash, const QString& name, const QByteArray& valueBytes)
+{
+    const QByteArray name8 = name.toLocal8Bit();
+    hash = QGC::crc32(reinterpret_cast<const quint8*>(name8.constData()), static_cast<unsigned>(name8.size()), hash);
+    return QGC::crc32(reinterpret_cast<const quint8*>(valueBytes.constData()), static_cast<unsigned>(valueBytes.size()), hash);
+}
+
+bool ParameterCacheFile::isCacheableType(FactMetaData::ValueType_t type)
+{
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+    case FactMetaData::valueTypeInt8:
+    case FactMetaData::valueTypeUint16:
+    case FactMetaData::valueTypeInt16:
+    case FactMetaData::valueTypeUint32:
+    case FactMetaData::valueTypeInt32:
+    case FactMetaData::valueTypeUint64:
+    case FactMetaData::valueTypeInt64:
+    case FactMetaData::valueTypeFloat:
+    case FactMetaData::valueTypeDouble:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// @return The value as the firmware stores it, FactMetaData::typeToSize bytes
+QByteArray ParameterCacheFile::_encodeValue(FactMetaData::ValueType_t type, const QVariant& value)
+{
+    auto bytes = [](const auto& typedValue) {
+        return QByteArray(reinterpret_cast<const char*>(&typedValue), sizeof(typedValue));
+    };
+
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+        return bytes(static_cast<quint8>(value.toUInt()));
+    case FactMetaData::valueTypeInt8:
+        return bytes(static_cast<qint8>(value.toInt()));
+    case FactMetaData::valueTypeUint16:
+        return bytes(static_cast<quint16>(value.toUInt()));
+    case FactMetaData::valueTypeInt16:
+        return bytes(static_cast<qint16>(value.toInt()));
+    case FactMetaData::valueTypeUint32:
+        return bytes(static_cast<quint32>(value.toUInt()));
+    case FactMetaData::valueTypeInt32:
+        return bytes(static_cast<qint32>(value.toInt()));
+    case FactMetaData::valueTypeUint64:
+        return bytes(static_cast<quint64>(value.toULongLong()));
+    case FactMetaData::valueTypeInt64:
+        return bytes(static_cast<qint64>(value.toLongLong()));
+    case FactMetaData::valueTypeFloat:
+        return bytes(value.toFloat());
+    case FactMetaData::valueTypeDouble:
+        return bytes(value.toDouble());
+    default:
+        return QByteArray();
+    }
+}
+
+/// @return The value with the same variant type as when it is received from the vehicle
+QVariant ParameterCacheFile::_decodeValue(FactMetaData::ValueType_t type, const uchar* bytes)
+{
+    auto decode = [bytes](auto typedValue) {
+        memcpy(&typedValue, bytes, sizeof(typedValue));
+        return QVariant(typedValue);
+    };
+
+    switch (type) {
+    case FactMetaData::valueTypeUint8:
+        return decode(quint8(0));
+    case FactMetaData::valueTypeInt8:
+        return decode(qint8(0));
+    case FactMetaData::valueTypeUint16:
+        return decode(quint16(0));
+    case FactMetaData::valueTypeInt16:
+        return decode(qint16(0));
+    case FactMetaData::valueTypeUint32:
+        return decode(quint32(0));
+    case FactMetaData::valueTypeInt32:
+        return decode(qint32(0));
+    case FactMetaData::valueTypeUint64:
+        return decode(quint64(0));
+    case FactMetaData::valueTypeInt64:
+        return decode(qint64(0));
+    case FactMetaData::valueTypeFloat:
+        return decode(0.0f);
+    case FactMetaData::valueTypeDouble:
+        return decode(0.0);
+    default:
+        return QVariant();
+    }
+}
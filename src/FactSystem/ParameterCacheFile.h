@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "FactMetaData.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+Q_DECLARE_LOGGING_CATEGORY(ParameterCacheFileLog)
+
+/// Parameter values of a single vehicle component cached on disk. The file holds the parameters sorted by name along
+/// with the parameter set hash the firmware reports in _HASH_CHECK, computed once when the cache is written. Loading
+/// memory maps the file and only checks its header, so a hash match against the vehicle costs no parsing at all.
+class ParameterCacheFile
+{
+public:
+    struct Entry {
+        QString                     name;
+        FactMetaData::ValueType_t   type            = FactMetaData::valueTypeUint8;
+        QVariant                    value;          ///< Fact::rawValue
+        bool                        volatileValue   = false;    ///< Volatile parameters don't take part in the hash
+    };
+
+    ParameterCacheFile() = default;
+    ~ParameterCacheFile();
+
+    /// Maps @a fileName
+    /// @return false: Cache doesn't exist, is from another format version or is corrupt
+    bool load(const QString& fileName);
+
+    bool    isValid () const { return _data != nullptr; }
+    int     count   () const { return static_cast<int>(_parameterCount); }
+    quint32 hash    () const { return _hash; }
+
+    /// Decodes the parameter at @a index, parameters are sorted by name
+    Entry entry(int index) const;
+
+    /// Writes @a entries to @a fileName. The entries don't need to be sorted.
+    /// @return false: Unable to write the file
+    static bool save(const QString& fileName, const QList<Entry>& entries);
+
+    /// @return Hash of @a entries as the firmware computes it, @a entries must be sorted by name
+    static quint32 computeHash(const QList<Entry>& entries);
+
+    /// @return true: Parameters of @a type can be cached
+    static bool isCacheableType(FactMetaData::ValueType_t type);
+
+private:
+    struct Header {
+        quint32 magic;
+        quint32 formatVersion;
+        quint32 parameterCount;
+        quint32 hash;
+        quint32 recordsOffset;
+        quint32 stringsOffset;
+        quint32 stringsSize;
+    };
+
+    struct Record {
+        quint32 nameOffset;
+        quint32 nameLength;
+        qint32  type;               ///< FactMetaData::ValueType_t
+        quint32 flags;
+        uchar   value[8];           ///< Raw value, FactMetaData::typeToSize bytes are used
+    };
+
+    enum RecordFlags {
+        FlagVolatile = 1 << 0,
+    };
+
+    void _close();
+
+    static QByteArray   _encodeValue(FactMetaData::ValueType_t type, const QVariant& value);
+    static QVariant     _decodeValue(FactMetaData::ValueType_t type, const uchar* bytes);
+    static quint32      _accumulateHash(quint32 hash, const QString& name, const QByteArray& valueBytes);
+
+    QFile           _file;
+    const uchar*    _data = nullptr;
+    quint32         _parameterCount = 0;
+    quint32         _hash = 0;
+    quint32         _recordsOffset = 0;
+    quint32         _stringsOffset = 0;
+    quint32         _stringsSize = 0;
+
+    static constexpr quint32 _magic = 0x51505243;   // "QPRC"
+    static constexpr quint32 _formatVersion = 1;
+};
@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "ParameterManager.h"
+#include "ParameterCacheFile.h"
 #include "QGCApplication.h"
 #include "FirmwarePlugin.h"
 #include "CompInfoParam.h"
@@ -23,6 +24,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QVariantAnimation>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QtMath>
 
 QGC_LOGGING_CATEGORY(ParameterManagerVerbose1Log,           "ParameterManagerVerbose1Log")
 QGC_LOGGING_CATEGORY(ParameterManagerVerbose2Log,           "ParameterManagerVerbose2Log")
@@ -98,28 +100,25 @@ ParameterManager::ParameterManager(Vehicle* vehicle)
     connect(&_initialRequestTimeoutTimer, &QTimer::timeout, this, &ParameterManager::_initialRequestTimeout);
 
     _waitingParamTimeoutTimer.setSingleShot(true);
-    _waitingParamTimeoutTimer.setInterval(3000);
+    _waitingParamTimeoutTimer.setInterval(_waitingParamTimeoutMSecs);
     connect(&_waitingParamTimeoutTimer, &QTimer::timeout, this, &ParameterManager::_waitingParamTimeout);
 
+    _indexRequestTimer.start();
+
+    _bulkWriteRetryTimer.setInterval(100);
+    connect(&_bulkWriteRetryTimer, &QTimer::timeout, this, &ParameterManager::_bulkWriteRetryTimeout);
+
     // Ensure the cache directory exists
     QFileInfo(QSettings().fileName()).dir().mkdir("ParamCache");
 }
 
 void ParameterManager::_updateProgressBar(void)
 {
-    int waitingReadParamIndexCount = 0;
-    int waitingReadParamNameCount = 0;
-    int waitingWriteParamCount = 0;
+    int waitingReadParamIndexCount;
+    int waitingReadParamNameCount;
+    int waitingWriteParamCount;
 
-    for (int compId: _waitingReadParamIndexMap.keys()) {
-        waitingReadParamIndexCount += _waitingReadParamIndexMap[compId].count();
-    }
-    for(int compId: _waitingReadParamNameMap.keys()) {
-        waitingReadParamNameCount += _waitingReadParamNameMap[compId].count();
-    }
-    for(int compId: _waitingWriteParamNameMap.keys()) {
-        waitingWriteParamCount += _waitingWriteParamNameMap[compId].count();
-    }
+    _waitingParamCounts(waitingReadParamIndexCount, waitingReadParamNameCount, waitingWriteParamCount);
 
     if (waitingReadParamIndexCount == 0) {
         if (_readParamIndexProgressActive) {
@@ -282,74 +281,59 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
     _initialRequestTimeoutTimer.stop();
     _waitingParamTimeoutTimer.stop();
 
-    // Update our total parameter counts
-    if (!_paramCountMap.contains(componentId)) {
-        _paramCountMap[componentId] = parameterCount;
+    ComponentParameters& component = _components[componentId];
+
+    // If we've never seen this component id before, setup the wait lists
+    if (!component.countKnown) {
+        component.countKnown = true;
+        component.paramCount = parameterCount;
         _totalParamCount += parameterCount;
-    }
 
-    // If we've never seen this component id before, setup the index wait lists.
-    if (!_waitingReadParamIndexMap.contains(componentId)) {
         // Add all indices to the wait list, parameter index is 0-based
-        for (int waitingIndex=0; waitingIndex<parameterCount; waitingIndex++) {
-            // This will add the new component id, as well as the the new waiting index and set the retry count for that index to 0
-            _waitingReadParamIndexMap[componentId][waitingIndex] = 0;
-        }
-
-        // The read and write waiting lists for this component are initialized the empty
-        _waitingReadParamNameMap[componentId] = QMap<QString, int>();
-        _waitingWriteParamNameMap[componentId] = QMap<QString, int>();
+        component.waitingReadIndexRetries.fill(0, parameterCount);
+        component.waitingReadIndexCount = parameterCount;
 
         qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Seeing component for first time - paramcount:" << parameterCount;
     }
 
-    if (!_waitingReadParamIndexMap[componentId].contains(parameterIndex) &&
-            !_waitingReadParamNameMap[componentId].contains(parameterName) &&
-            !_waitingWriteParamNameMap[componentId].contains(parameterName)) {
+    const bool waitingForIndex = component.isWaitingForIndex(parameterIndex);
+    if (!waitingForIndex &&
+            !component.waitingReadNames.contains(parameterName) &&
+            !component.waitingWriteNames.contains(parameterName)) {
         qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Unrequested param update" << parameterName;
     }
 
     // Remove this parameter from the waiting lists
-    if (_waitingReadParamIndexMap[componentId].contains(parameterIndex)) {
-        _waitingReadParamIndexMap[componentId].remove(parameterIndex);
-        _indexBatchQueue.removeOne(parameterIndex);
+    if (waitingForIndex) {
+        component.setWaitingForIndex(parameterIndex, false);
+        _indexRequestAnswered(parameterIndex);
         _fillIndexBatchQueue(false /* waitingParamTimeout */);
     }
-    _waitingReadParamNameMap[componentId].remove(parameterName);
-    _waitingWriteParamNameMap[componentId].remove(parameterName);
-    if (_waitingReadParamIndexMap[componentId].count()) {
-        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap:" << _waitingReadParamIndexMap[componentId];
+    component.waitingReadNames.remove(parameterName);
+    component.waitingWriteNames.remove(parameterName);
+    if (component.waitingReadIndexCount) {
+        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "waitingReadIndexCount:" << component.waitingReadIndexCount;
     }
-    if (_waitingReadParamNameMap[componentId].count()) {
-        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "_waitingReadParamNameMap" << _waitingReadParamNameMap[componentId];
+    if (component.waitingReadNames.count()) {
+        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "waitingReadNames" << component.waitingReadNames;
     }
-    if (_waitingWriteParamNameMap[componentId].count()) {
-        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "_waitingWriteParamNameMap" << _waitingWriteParamNameMap[componentId];
+    if (component.waitingWriteNames.count()) {
+        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "waitingWriteNames" << component.waitingWriteNames;
     }
 
     // Track how many parameters we are still waiting for
 
-    int waitingReadParamIndexCount = 0;
-    int waitingReadParamNameCount = 0;
-    int waitingWriteParamNameCount = 0;
+    int waitingReadParamIndexCount;
+    int waitingReadParamNameCount;
+    int waitingWriteParamNameCount;
 
-    for(int waitingComponentId: _waitingReadParamIndexMap.keys()) {
-        waitingReadParamIndexCount += _waitingReadParamIndexMap[waitingComponentId].count();
-    }
+    _waitingParamCounts(waitingReadParamIndexCount, waitingReadParamNameCount, waitingWriteParamNameCount);
     if (waitingReadParamIndexCount) {
         qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "waitingReadParamIndexCount:" << waitingReadParamIndexCount;
     }
-
-    for(int waitingComponentId: _waitingReadParamNameMap.keys()) {
-        waitingReadParamNameCount += _waitingReadParamNameMap[waitingComponentId].count();
-    }
     if (waitingReadParamNameCount) {
         qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "waitingReadParamNameCount:" << waitingReadParamNameCount;
     }
-
-    for(int waitingComponentId: _waitingWriteParamNameMap.keys()) {
-        waitingWriteParamNameCount += _waitingWriteParamNameMap[waitingComponentId].count();
-    }
     if (waitingWriteParamNameCount) {
         qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "waitingWriteParamNameCount:" << waitingWriteParamNameCount;
     }
@@ -361,7 +345,7 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
         _waitingParamTimeoutTimer.start();
         qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer: totalWaitingParamCount:" << totalWaitingParamCount;
     } else {
-        if (!_mapCompId2FactMap.contains(_vehicle->defaultComponentId())) {
+        if (!_hasFacts(_vehicle->defaultComponentId())) {
             // Still waiting for parameters from default component
             qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer (still waiting for default component params)";
             _waitingParamTimeoutTimer.start();
@@ -372,17 +356,15 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
 
     _updateProgressBar();
 
-    Fact* fact = nullptr;
-    if (_mapCompId2FactMap.contains(componentId) && _mapCompId2FactMap[componentId].contains(parameterName)) {
-        fact = _mapCompId2FactMap[componentId][parameterName];
-    } else {
+    Fact* fact = component.facts.value(parameterName);
+    if (!fact) {
         qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Adding new fact" << parameterName;
 
         fact = new Fact(componentId, parameterName, mavTypeToFactType(mavParamType), this);
         FactMetaData* factMetaData = _vehicle->compInfoManager()->compInfoParam(componentId)->factMetaDataForName(parameterName, fact->type());
         fact->setMetaData(factMetaData);
 
-        _mapCompId2FactMap[componentId][parameterName] = fact;
+        component.facts.insert(parameterName, fact);
 
         // We need to know when the fact value changes so we can update the vehicle
         connect(fact, &Fact::_containerRawValueChanged, this, &ParameterManager::_factRawValueUpdated);
@@ -392,6 +374,10 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
 
     fact->_containerSetRawValue(parameterValue);
 
+    if (_bulkWrite.active) {
+        _bulkWriteAck(fact);
+    }
+
     // Update param cache. The param cache is only used on PX4 Firmware since ArduPilot and Solo have volatile params
     // which invalidate the cache. The Solo also streams param updates in flight for things like gimbal values
     // which in turn causes a perf problem with all the param cache updates.
@@ -414,13 +400,12 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
 /// Writes the parameter update to mavlink, sets up for write wait
 void ParameterManager::_factRawValueUpdateWorker(int componentId, const QString& name, FactMetaData::ValueType_t valueType, const QVariant& rawValue)
 {
-    if (_waitingWriteParamNameMap.contains(componentId)) {
-        if (_waitingWriteParamNameMap[componentId].contains(name)) {
-            _waitingWriteParamNameMap[componentId].remove(name);
-        } else {
+    auto componentIt = _components.find(componentId);
+    if (componentIt != _components.end() && componentIt->countKnown) {
+        if (!componentIt->waitingWriteNames.contains(name)) {
             _waitingWriteParamBatchCount++;
         }
-        _waitingWriteParamNameMap[componentId][name] = 0; // Add new entry and set retry count
+        componentIt->waitingWriteNames[name] = 0; // Add new entry and set retry count
         _updateProgressBar();
         _waitingParamTimeoutTimer.start();
         _saveRequired = true;
@@ -535,14 +520,13 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
         }
     } else {
         // Reset index wait lists
-        for (int cid: _paramCountMap.keys()) {
+        for (auto it = _components.begin(); it != _components.end(); it++) {
             // Add/Update all indices to the wait list, parameter index is 0-based
-            if(componentId != MAV_COMP_ID_ALL && componentId != cid)
+            if (!it->countKnown || (componentId != MAV_COMP_ID_ALL && componentId != it.key()))
                 continue;
-            for (int waitingIndex = 0; waitingIndex < _paramCountMap[cid]; waitingIndex++) {
-                // This will add a new waiting index if needed and set the retry count for that index to 0
-                _waitingReadParamIndexMap[cid][waitingIndex] = 0;
-            }
+            // This will add a new waiting index if needed and set the retry count for that index to 0
+            it->waitingReadIndexRetries.fill(0, it->paramCount);
+            it->waitingReadIndexCount = it->paramCount;
         }
         MAVLinkProtocol*        mavlink = qgcApp()->toolbox()->mavlinkProtocol();
         mavlink_message_t       msg;
@@ -578,15 +562,14 @@ void ParameterManager::refreshParameter(int componentId, const QString& paramNam
     componentId = _actualComponentId(componentId);
     qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "refreshParameter - name:" << paramName << ")";
 
-    if (_waitingReadParamNameMap.contains(componentId)) {
+    auto componentIt = _components.find(componentId);
+    if (componentIt != _components.end() && componentIt->countKnown) {
         QString mappedParamName = _remapParamNameToVersion(paramName);
 
-        if (_waitingReadParamNameMap[componentId].contains(mappedParamName)) {
-            _waitingReadParamNameMap[componentId].remove(mappedParamName);
-        } else {
+        if (!componentIt->waitingReadNames.contains(mappedParamName)) {
             _waitingReadParamNameBatchCount++;
         }
-        _waitingReadParamNameMap[componentId][mappedParamName] = 0;     // Add new wait entry and update retry count
+        componentIt->waitingReadNames[mappedParamName] = 0;     // Add new wait entry and update retry count
         _updateProgressBar();
         qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "restarting _waitingParamTimeout";
         _waitingParamTimeoutTimer.start();
@@ -602,7 +585,7 @@ void ParameterManager::refreshParametersPrefix(int componentId, const QString& n
     componentId = _actualComponentId(componentId);
     qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "refreshParametersPrefix - name:" << namePrefix << ")";
 
-    for (const QString &paramName: _mapCompId2FactMap[componentId].keys()) {
+    for (const QString &paramName: parameterNames(componentId)) {
         if (paramName.startsWith(namePrefix)) {
             refreshParameter(componentId, paramName);
         }
@@ -611,14 +594,8 @@ void ParameterManager::refreshParametersPrefix(int componentId, const QString& n
 
 bool ParameterManager::parameterExists(int componentId, const QString& paramName)
 {
-    bool ret = false;
-
     componentId = _actualComponentId(componentId);
-    if (_mapCompId2FactMap.contains(componentId)) {
-        ret = _mapCompId2FactMap[componentId].contains(_remapParamNameToVersion(paramName));
-    }
-
-    return ret;
+    return _findFact(componentId, _remapParamNameToVersion(paramName)) != nullptr;
 }
 
 Fact* ParameterManager::getParameter(int componentId, const QString& paramName)
@@ -626,20 +603,67 @@ Fact* ParameterManager::getParameter(int componentId, const QString& paramName)
     componentId = _actualComponentId(componentId);
 
     QString mappedParamName = _remapParamNameToVersion(paramName);
-    if (!_mapCompId2FactMap.contains(componentId) || !_mapCompId2FactMap[componentId].contains(mappedParamName)) {
+    Fact* fact = _findFact(componentId, mappedParamName);
+    if (!fact) {
         qgcApp()->reportMissingParameter(componentId, mappedParamName);
         return &_defaultFact;
     }
 
-    return _mapCompId2FactMap[componentId][mappedParamName];
+    return fact;
+}
+
+Fact* ParameterManager::_findFact(int componentId, const QString& paramName) const
+{
+    const auto componentIt = _components.constFind(componentId);
+    if (componentIt == _components.constEnd()) {
+        return nullptr;
+    }
+    return componentIt->facts.value(paramName);
+}
+
+bool ParameterManager::_hasFacts(int componentId) const
+{
+    const auto componentIt = _components.constFind(componentId);
+    return componentIt != _components.constEnd() && !componentIt->facts.isEmpty();
+}
+
+void ParameterManager::_waitingParamCounts(int& waitingReadParamIndexCount, int& waitingReadParamNameCount, int& waitingWriteParamNameCount) const
+{
+    waitingReadParamIndexCount = 0;
+    waitingReadParamNameCount = 0;
+    waitingWriteParamNameCount = 0;
+
+    for (const ComponentParameters& component: _components) {
+        waitingReadParamIndexCount += component.waitingReadIndexCount;
+        waitingReadParamNameCount += component.waitingReadNames.count();
+        waitingWriteParamNameCount += component.waitingWriteNames.count();
+    }
+}
+
+void ParameterManager::ComponentParameters::setWaitingForIndex(int index, bool waiting)
+{
+    if (index < 0 || index >= waitingReadIndexRetries.count()) {
+        return;
+    }
+    if (waiting) {
+        if (waitingReadIndexRetries[index] < 0) {
+            waitingReadIndexCount++;
+        }
+        waitingReadIndexRetries[index] = 0;
+    } else if (waitingReadIndexRetries[index] >= 0) {
+        waitingReadIndexRetries[index] = -1;
+        waitingReadIndexCount--;
+    }
 }
 
 QStringList ParameterManager::parameterNames(int componentId)
 {
     QStringList names;
 
-    for(const QString &paramName: _mapCompId2FactMap[_actualComponentId(componentId)].keys()) {
-        names << paramName;
+    const auto componentIt = _components.constFind(_actualComponentId(componentId));
+    if (componentIt != _components.constEnd()) {
+        names = componentIt->facts.keys();
+        names.sort();
     }
 
     return names;
@@ -654,50 +678,157 @@ bool ParameterManager::_fillIndexBatchQueue(bool waitingParamTimeout)
         return false;
     }
 
-    const int maxBatchSize = 10;
-
     if (waitingParamTimeout) {
-        // We timed out, clear the queue and try again
+        // We timed out, everything still in flight is lost. Clear the queue and try again.
         qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to timeout";
+        quint32 newestLostSequence = 0;
+        for (const IndexRequest& request: _indexBatchQueue) {
+            newestLostSequence = qMax(newestLostSequence, request.sequence);
+        }
+        _indexRequestsLost(_indexBatchQueue.count(), newestLostSequence);
         _indexBatchQueue.clear();
     } else {
         qCDebug(ParameterManagerLog) << "Refilling index based batch queue due to received parameter";
     }
 
-    for(int componentId: _waitingReadParamIndexMap.keys()) {
-        if (_waitingReadParamIndexMap[componentId].count()) {
-            qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap count" << _waitingReadParamIndexMap[componentId].count();
-            qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap" << _waitingReadParamIndexMap[componentId];
+    for (auto it = _components.begin(); it != _components.end(); it++) {
+        const int componentId = it.key();
+        ComponentParameters& component = it.value();
+
+        if (component.waitingReadIndexCount == 0) {
+            continue;
         }
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "waitingReadIndexCount" << component.waitingReadIndexCount;
 
-        for(int paramIndex: _waitingReadParamIndexMap[componentId].keys()) {
-            if (_indexBatchQueue.contains(paramIndex)) {
+        for (int paramIndex = 0; paramIndex < component.waitingReadIndexRetries.count(); paramIndex++) {
+            if (!component.isWaitingForIndex(paramIndex) || _indexBatchQueue.contains(paramIndex)) {
                 // Don't add more than once
                 continue;
             }
 
-            if (_indexBatchQueue.count() > maxBatchSize) {
+            if (_indexBatchQueue.count() >= _indexBatchWindow) {
                 break;
             }
 
-            _waitingReadParamIndexMap[componentId][paramIndex]++;   // Bump retry count
-            if (_disableAllRetries || _waitingReadParamIndexMap[componentId][paramIndex] > _maxInitialLoadRetrySingleParam) {
+            const int retryCount = ++component.waitingReadIndexRetries[paramIndex];  // Bump retry count
+            if (_disableAllRetries || retryCount > _maxInitialLoadRetrySingleParam) {
                 // Give up on this index
-                _failedReadParamIndexMap[componentId] << paramIndex;
-                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Giving up on (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
-                _waitingReadParamIndexMap[componentId].remove(paramIndex);
+                component.failedReadIndices << paramIndex;
+                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Giving up on (paramIndex:" << paramIndex << "retryCount:" << retryCount << ")";
+                component.setWaitingForIndex(paramIndex, false);
             } else {
-                // Retry again
-                _indexBatchQueue.append(paramIndex);
+                // Retry again. Only the first request for an index gives an unambiguous round trip time.
+                _indexBatchQueue.insert(paramIndex, { ++_indexRequestSequence, retryCount == 1 ? _indexRequestTimer.elapsed() : -1 });
                 _readParameterRaw(componentId, "", paramIndex);
-                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
+                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "retryCount:" << retryCount << ")";
             }
         }
     }
 
+    _updateWaitingParamTimeout();
+
     return _indexBatchQueue.count() != 0;
 }
 
+/// Updates the index re-request window and round trip time for an answered index
+void ParameterManager::_indexRequestAnswered(int paramIndex)
+{
+    const auto answeredIt = _indexBatchQueue.constFind(paramIndex);
+    if (answeredIt == _indexBatchQueue.constEnd()) {
+        // Answered from the initial request list
+        return;
+    }
+    const IndexRequest answered = answeredIt.value();
+    _indexBatchQueue.erase(answeredIt);
+
+    if (answered.sentMSecs >= 0) {
+        _addRttSample(static_cast<double>(_indexRequestTimer.elapsed() - answered.sentMSecs));
+    }
+    _indexRequestLossPercent *= 15.0 / 16.0;
+
+    // Requests are answered in the order they are sent. Requests sent well before this one which are still unanswered
+    // were lost, don't let them hold a slot in the window until the timeout.
+    int lostCount = 0;
+    quint32 newestLostSequence = 0;
+    for (auto it = _indexBatchQueue.begin(); it != _indexBatchQueue.end();) {
+        if (answered.sequence > it->sequence + _indexReorderTolerance) {
+            qCDebug(ParameterManagerVerbose1Log) << "Index request lost (paramIndex:" << it.key() << ")";
+            newestLostSequence = qMax(newestLostSequence, it->sequence);
+            lostCount++;
+            it = _indexBatchQueue.erase(it);
+        } else {
+            it++;
+        }
+    }
+    _indexRequestsLost(lostCount, newestLostSequence);
+
+    // Grow the window by one for each window's worth of answered requests
+    if (++_indexBatchWindowAnswered >= _indexBatchWindow) {
+        _indexBatchWindowAnswered = 0;
+        _indexBatchWindow = qMin(_indexBatchWindow + 1, _maxIndexBatchWindow);
+    }
+}
+
+void ParameterManager::_indexRequestsLost(int lostCount, quint32 newestLostSequence)
+{
+    if (lostCount == 0) {
+        return;
+    }
+
+    for (int i = 0; i < lostCount; i++) {
+        _indexRequestLossPercent = ((15.0 / 16.0) * _indexRequestLossPercent) + (100.0 / 16.0);
+    }
+
+    // Losing requests at the rate the link loses messages anyway is no sign of the window being too large, shrinking it
+    // would only slow down recovery. Losing noticeably more means the requests are overrunning the link.
+    const double linkLossPercent = static_cast<double>(_vehicle->mavlinkLossPercent());
+    if ((_indexRequestLossPercent > (2 * linkLossPercent) + 10) && (newestLostSequence > _indexBatchWindowReducedSequence)) {
+        _indexBatchWindow = qMax(_indexBatchWindow / 2, _minIndexBatchWindow);
+        _indexBatchWindowAnswered = 0;
+        // Only once for the requests which were in flight together
+        _indexBatchWindowReducedSequence = _indexRequestSequence;
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Index request window reduced:" << _indexBatchWindow << "requestLoss:" << _indexRequestLossPercent << "linkLoss:" << linkLossPercent;
+    }
+}
+
+/// Adds a round trip time sample of a request which was answered on its first attempt
+void ParameterManager::_addRttSample(double rttMSecs)
+{
+    // Same smoothing as TCP uses for its retransmit timeout (RFC 6298)
+    if (_indexRequestRttMSecs == 0) {
+        _indexRequestRttMSecs = qMax(rttMSecs, 1.0);
+        _indexRequestRttVarMSecs = rttMSecs / 2;
+    } else {
+        _indexRequestRttVarMSecs = (0.75 * _indexRequestRttVarMSecs) + (0.25 * qAbs(_indexRequestRttMSecs - rttMSecs));
+        _indexRequestRttMSecs = qMax((0.875 * _indexRequestRttMSecs) + (0.125 * rttMSecs), 1.0);
+    }
+}
+
+/// @return Time to wait for an answer before retrying a request, based on the measured round trip time
+int ParameterManager::_retryTimeoutMSecs(void) const
+{
+    if (_indexRequestRttMSecs == 0) {
+        return _waitingParamTimeoutMSecs;
+    }
+
+    const double retryTimeoutMSecs = _indexRequestRttMSecs + qMax(4 * _indexRequestRttVarMSecs, 50.0);
+    return qBound(_minIndexRetryTimeoutMSecs, qRound(retryTimeoutMSecs), _waitingParamTimeoutMSecs);
+}
+
+/// Index re-requests time out based on their round trip time, everything else uses the fixed timeout
+void ParameterManager::_updateWaitingParamTimeout(void)
+{
+    int timeoutMSecs = _waitingParamTimeoutMSecs;
+
+    if (_indexBatchQueueActive && !_indexBatchQueue.isEmpty()) {
+        timeoutMSecs = _retryTimeoutMSecs();
+    }
+
+    if (_waitingParamTimeoutTimer.interval() != timeoutMSecs) {
+        _waitingParamTimeoutTimer.setInterval(timeoutMSecs);
+    }
+}
+
 void ParameterManager::_waitingParamTimeout(void)
 {
     if (_logReplay) {
@@ -716,7 +847,7 @@ void ParameterManager::_waitingParamTimeout(void)
     // First check for any missing parameters from the initial index based load
     paramsRequested = _fillIndexBatchQueue(true /* waitingParamTimeout */);
 
-    if (!paramsRequested && !_waitingForDefaultComponent && !_mapCompId2FactMap.contains(_vehicle->defaultComponentId())) {
+    if (!paramsRequested && !_waitingForDefaultComponent && !_hasFacts(_vehicle->defaultComponentId())) {
         // Initial load is complete but we still don't have any default component params. Wait one more cycle to see if the
         // any show up.
         qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Restarting _waitingParamTimeoutTimer - still don't have default component params" << _vehicle->defaultComponentId();
@@ -729,20 +860,22 @@ void ParameterManager::_waitingParamTimeout(void)
     _checkInitialLoadComplete();
 
     if (!paramsRequested) {
-        for(int componentId: _waitingWriteParamNameMap.keys()) {
-            for(const QString &paramName: _waitingWriteParamNameMap[componentId].keys()) {
+        for (auto componentIt = _components.begin(); componentIt != _components.end(); componentIt++) {
+            const int componentId = componentIt.key();
+            QHash<QString, int>& waitingWriteNames = componentIt->waitingWriteNames;
+            for (const QString &paramName: waitingWriteNames.keys()) {
                 paramsRequested = true;
-                _waitingWriteParamNameMap[componentId][paramName]++;   // Bump retry count
-                if (_waitingWriteParamNameMap[componentId][paramName] <= _maxReadWriteRetry) {
+                const int retryCount = ++waitingWriteNames[paramName];   // Bump retry count
+                if (retryCount <= _maxReadWriteRetry) {
                     Fact* fact = getParameter(componentId, paramName);
                     _sendParamSetToVehicle(componentId, paramName, fact->type(), fact->rawValue());
-                    qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Write resend for (paramName:" << paramName << "retryCount:" << _waitingWriteParamNameMap[componentId][paramName] << ")";
+                    qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Write resend for (paramName:" << paramName << "retryCount:" << retryCount << ")";
                     if (++batchCount > maxBatchSize) {
                         goto Out;
                     }
                 } else {
                     // Exceeded max retry count, notify user
-                    _waitingWriteParamNameMap[componentId].remove(paramName);
+                    waitingWriteNames.remove(paramName);
                     QString errorMsg = tr("Parameter write failed: veh:%1 comp:%2 param:%3").arg(_vehicle->id()).arg(componentId).arg(paramName);
                     qCDebug(ParameterManagerLog) << errorMsg;
                     qgcApp()->showAppMessage(errorMsg);
@@ -752,19 +885,21 @@ void ParameterManager::_waitingParamTimeout(void)
     }
 
     if (!paramsRequested) {
-        for(int componentId: _waitingReadParamNameMap.keys()) {
-            for(const QString &paramName: _waitingReadParamNameMap[componentId].keys()) {
+        for (auto componentIt = _components.begin(); componentIt != _components.end(); componentIt++) {
+            const int componentId = componentIt.key();
+            QHash<QString, int>& waitingReadNames = componentIt->waitingReadNames;
+            for (const QString &paramName: waitingReadNames.keys()) {
                 paramsRequested = true;
-                _waitingReadParamNameMap[componentId][paramName]++;   // Bump retry count
-                if (_waitingReadParamNameMap[componentId][paramName] <= _maxReadWriteRetry) {
+                const int retryCount = ++waitingReadNames[paramName];   // Bump retry count
+                if (retryCount <= _maxReadWriteRetry) {
                     _readParameterRaw(componentId, paramName, -1);
-                    qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramName:" << paramName << "retryCount:" << _waitingReadParamNameMap[componentId][paramName] << ")";
+                    qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramName:" << paramName << "retryCount:" << retryCount << ")";
                     if (++batchCount > maxBatchSize) {
                         goto Out;
                     }
                 } else {
                     // Exceeded max retry count, notify user
-                    _waitingReadParamNameMap[componentId].remove(paramName);
+                    waitingReadNames.remove(paramName);
                     QString errorMsg = tr("Parameter read failed: veh:%1 comp:%2 param:%3").arg(_vehicle->id()).arg(componentId).arg(paramName);
                     qCDebug(ParameterManagerLog) << errorMsg;
                     qgcApp()->showAppMessage(errorMsg);
@@ -864,18 +999,22 @@ void ParameterManager::_sendParamSetToVehicle(int componentId, const QString& pa
 
 void ParameterManager::_writeLocalParamCache(int vehicleId, int componentId)
 {
-    CacheMapName2ParamTypeVal cacheMap;
-
-    for (const QString& paramName: _mapCompId2FactMap[componentId].keys()) {
-        const Fact *fact = _mapCompId2FactMap[componentId][paramName];
-        cacheMap[paramName] = ParamTypeVal(fact->type(), fact->rawValue());
+    const auto componentIt = _components.constFind(componentId);
+    if (componentIt == _components.constEnd()) {
+        return;
     }
 
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    QList<ParameterCacheFile::Entry> entries;
+    entries.reserve(componentIt->facts.count());
+    for (auto it = componentIt->facts.constBegin(); it != componentIt->facts.constEnd(); it++) {
+        const Fact* fact = it.value();
+        entries.append({ it.key(), fact->type(), fact->rawValue(), fact->metaData() && fact->metaData()->volatileValue() });
+    }
 
-    QDataStream ds(&cacheFile);
-    ds << cacheMap;
+    if (ParameterCacheFile::save(parameterCacheFile(vehicleId, componentId), entries)) {
+        // The cache in the previous QDataStream format is never read again
+        (void) QFile::remove(parameterCacheDir().filePath(QString("%1_%2.v2").arg(vehicleId).arg(componentId)));
+    }
 }
 
 QDir ParameterManager::parameterCacheDir()
@@ -886,56 +1025,27 @@ QDir ParameterManager::parameterCacheDir()
 
 QString ParameterManager::parameterCacheFile(int vehicleId, int componentId)
 {
-    return parameterCacheDir().filePath(QString("%1_%2.v2").arg(vehicleId).arg(componentId));
+    return parameterCacheDir().filePath(QString("%1_%2.v3").arg(vehicleId).arg(componentId));
 }
 
 void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVariant hash_value)
 {
     qCInfo(ParameterManagerLog) << "Attemping load from cache";
 
-    uint32_t crc32_value = 0;
-    /* The datastructure of the cache table */
-    CacheMapName2ParamTypeVal cacheMap;
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    if (!cacheFile.exists()) {
-        /* no local cache, just wait for them to come in*/
+    // The hash of the cached parameters is computed when the cache is written, so checking it against the vehicle only
+    // needs the header of the mapped file
+    ParameterCacheFile cache;
+    if (!cache.load(parameterCacheFile(vehicleId, componentId))) {
+        /* no usable local cache, just wait for them to come in*/
         return;
     }
-    cacheFile.open(QIODevice::ReadOnly);
-
-    /* Deserialize the parameter cache table */
-    QDataStream ds(&cacheFile);
-    ds >> cacheMap;
-
-    /* compute the crc of the local cache to check against the remote */
-
-    for (const QString& name: cacheMap.keys()) {
-        const ParamTypeVal&             paramTypeVal    = cacheMap[name];
-        const FactMetaData::ValueType_t fact_type       = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-
-        if (_vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->factMetaDataForName(name, fact_type)->volatileValue()) {
-            // Does not take part in CRC
-            qCDebug(ParameterManagerLog) << "Volatile parameter" << name;
-        } else {
-            const void *vdat = paramTypeVal.second.constData();
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            crc32_value = QGC::crc32((const uint8_t *)qPrintable(name), name.length(),  crc32_value);
-            crc32_value = QGC::crc32((const uint8_t *)vdat, FactMetaData::typeToSize(fact_type), crc32_value);
-        }
-    }
+    const uint32_t crc32_value = cache.hash();
 
     /* if the two param set hashes match, just load from the disk */
     if (crc32_value == hash_value.toUInt()) {
-        qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
-
-        int count = cacheMap.count();
-        int index = 0;
-        for (const QString& name: cacheMap.keys()) {
-            const ParamTypeVal& paramTypeVal = cacheMap[name];
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            const MAV_PARAM_TYPE mavParamType = factTypeToMavType(fact_type);
-            _handleParamValue(componentId, name, count, index++, mavParamType, paramTypeVal.second);
-        }
+        qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(parameterCacheFile(vehicleId, componentId));
+
+        _applyParameterCache(componentId, cache);
 
         SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
         if (sharedLink) {
@@ -979,22 +1089,74 @@ void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVarian
 
         ani->start(QAbstractAnimation::DeleteWhenStopped);
     } else {
-        qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
+        qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(parameterCacheFile(vehicleId, componentId));
         if (ParameterManagerDebugCacheFailureLog().isDebugEnabled()) {
             _debugCacheCRC[componentId] = true;
-            _debugCacheMap[componentId] = cacheMap;
-            for (const QString& name: cacheMap.keys()) {
-                _debugCacheParamSeen[componentId][name] = false;
+            CacheMapName2ParamTypeVal& cacheMap = _debugCacheMap[componentId];
+            cacheMap.clear();
+            for (int index = 0; index < cache.count(); index++) {
+                const ParameterCacheFile::Entry entry = cache.entry(index);
+                cacheMap[entry.name] = ParamTypeVal(entry.type, entry.value);
+                _debugCacheParamSeen[componentId][entry.name] = false;
             }
             qgcApp()->showAppMessage(tr("Parameter cache CRC match failed"));
         }
     }
 }
 
+/// Sets all parameters of a component from the cache in one pass. Unlike going through _handleParamValue for each
+/// parameter there is no per parameter wait list, timer, progress or cache write work and new facts have their value
+/// before anyone is told about them.
+void ParameterManager::_applyParameterCache(int componentId, const ParameterCacheFile& cache)
+{
+    _initialRequestTimeoutTimer.stop();
+    _waitingParamTimeoutTimer.stop();
+
+    const int parameterCount = cache.count();
+    ComponentParameters& component = _components[componentId];
+    if (!component.countKnown) {
+        component.countKnown = true;
+        component.paramCount = parameterCount;
+        _totalParamCount += parameterCount;
+    }
+    // Nothing left to wait for from the index based load
+    component.waitingReadIndexRetries.fill(-1, component.paramCount);
+    component.waitingReadIndexCount = 0;
+    component.facts.reserve(parameterCount);
+
+    CompInfoParam* compInfoParam = _vehicle->compInfoManager()->compInfoParam(componentId);
+    for (int index = 0; index < parameterCount; index++) {
+        const ParameterCacheFile::Entry entry = cache.entry(index);
+
+        Fact* fact = component.facts.value(entry.name);
+        if (fact) {
+            fact->_containerSetRawValue(entry.value);
+            continue;
+        }
+
+        fact = new Fact(componentId, entry.name, entry.type, this);
+        fact->setMetaData(compInfoParam->factMetaDataForName(entry.name, fact->type()));
+        fact->_containerSetRawValue(entry.value);
+        component.facts.insert(entry.name, fact);
+
+        // We need to know when the fact value changes so we can update the vehicle
+        connect(fact, &Fact::_containerRawValueChanged, this, &ParameterManager::_factRawValueUpdated);
+
+        emit factAdded(componentId, fact);
+    }
+
+    _waitingParamCounts(_prevWaitingReadParamIndexCount, _prevWaitingReadParamNameCount, _prevWaitingWriteParamNameCount);
+
+    qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Applied" << parameterCount << "parameters from cache";
+
+    _checkInitialLoadComplete();
+}
+
 QString ParameterManager::readParametersFromStream(QTextStream& stream)
 {
     QString missingErrors;
     QString typeErrors;
+    QList<QPair<Fact*, QVariant>> writes;
 
     while (!stream.atEnd()) {
         QString line = stream.readLine();
@@ -1028,12 +1190,25 @@ QString ParameterManager::readParametersFromStream(QTextStream& stream)
                     continue;
                 }
 
-                qCDebug(ParameterManagerLog) << "Updating parameter" << componentId << paramName << valStr;
-                fact->setRawValue(valStr);
+                QVariant typedValue;
+                QString  convertError;
+                if (!fact->metaData()->convertAndValidateRaw(valStr, true /* convertOnly */, typedValue, convertError)) {
+                    typeErrors += QStringLiteral("%1:%2 ").arg(componentId).arg(paramName);
+                    qCDebug(ParameterManagerLog) << "Skipped due to invalid value" << componentId << paramName << valStr << convertError;
+                    continue;
+                }
+                if (typedValue != fact->rawValue()) {
+                    qCDebug(ParameterManagerLog) << "Updating parameter" << componentId << paramName << valStr;
+                    writes.append({ fact, typedValue });
+                }
             }
         }
     }
 
+    if (!writes.isEmpty() && !writeParameters(writes)) {
+        return tr("Parameters not loaded, a previous parameter load is still being written to the vehicle.");
+    }
+
     QString errors;
 
     if (!missingErrors.isEmpty()) {
@@ -1064,9 +1239,9 @@ void ParameterManager::writeParametersToStream(QTextStream& stream)
     stream << "#\n";
     stream << "# Vehicle-Id Component-Id Name Value Type\n";
 
-    for (int componentId: _mapCompId2FactMap.keys()) {
-        for (const QString &paramName: _mapCompId2FactMap[componentId].keys()) {
-            Fact* fact = _mapCompId2FactMap[componentId][paramName];
+    for (int componentId: _components.keys()) {
+        for (const QString &paramName: parameterNames(componentId)) {
+            Fact* fact = _findFact(componentId, paramName);
             if (fact) {
                 stream << _vehicle->id() << "\t" << componentId << "\t" << paramName << "\t" << fact->rawValueStringFullPrecision() << "\t" << QString("%1").arg(factTypeToMavType(fact->type())) << "\n";
             } else {
@@ -1078,6 +1253,261 @@ void ParameterManager::writeParametersToStream(QTextStream& stream)
     stream.flush();
 }
 
+ParameterSnapshot ParameterManager::snapshot(void) const
+{
+    QList<ParameterSnapshot::Entry> entries;
+    for (auto componentIt = _components.constBegin(); componentIt != _components.constEnd(); componentIt++) {
+        for (const Fact* fact: componentIt->facts) {
+            entries.append({ componentIt.key(), fact->name(), fact->type(), fact->rawValue() });
+        }
+    }
+
+    return ParameterSnapshot(_vehicle->id(), entries);
+}
+
+QVariantList ParameterManager::compareToFile(const QString& fileName) const
+{
+    QVariantList differences;
+
+    QString errorString;
+    const ParameterSnapshot fileSnapshot = ParameterSnapshot::fromFile(fileName, errorString);
+    if (!errorString.isEmpty()) {
+        qgcApp()->showAppMessage(errorString);
+        return differences;
+    }
+
+    for (const ParameterSnapshot::Difference& difference: snapshot().diff(fileSnapshot)) {
+        QVariantMap map;
+        map[QStringLiteral("componentId")]      = difference.componentId;
+        map[QStringLiteral("name")]             = difference.name;
+        map[QStringLiteral("vehicleValue")]     = difference.value;
+        map[QStringLiteral("fileValue")]        = difference.otherValue;
+        map[QStringLiteral("missingOnVehicle")] = difference.kind == ParameterSnapshot::Difference::OnlyInOther;
+        map[QStringLiteral("missingInFile")]    = difference.kind == ParameterSnapshot::Difference::OnlyInThis;
+        differences.append(map);
+    }
+
+    return differences;
+}
+
+bool ParameterManager::writeParameters(const QList<QPair<Fact*, QVariant>>& values, bool rollbackOnFailure)
+{
+    if (_bulkWrite.active) {
+        qCWarning(ParameterManagerLog) << _logVehiclePrefix(-1) << "writeParameters: Write already in progress";
+        return false;
+    }
+
+    // Values are converted to the fact's type up front, so what is sent and what the vehicle's answer is compared
+    // against are the same. Values which can't be converted fail without being sent.
+    QList<QPair<Fact*, QVariant>> typedValues;
+    QStringList invalidParams;
+    typedValues.reserve(values.count());
+    for (const QPair<Fact*, QVariant>& value: values) {
+        Fact* const fact = value.first;
+        QVariant typedValue;
+        QString errorString;
+        if (!fact->metaData()->convertAndValidateRaw(value.second, true /* convertOnly */, typedValue, errorString)) {
+            qCWarning(ParameterManagerLog) << _logVehiclePrefix(fact->componentId()) << "writeParameters: Invalid value" << fact->name() << value.second << errorString;
+            invalidParams.append(QStringLiteral("%1:%2").arg(fact->componentId()).arg(fact->name()));
+            continue;
+        }
+        typedValues.append({ fact, typedValue });
+    }
+
+    if (_vehicle->isOfflineEditingVehicle() || (rollbackOnFailure && !invalidParams.isEmpty())) {
+        // Offline there is nothing to acknowledge the writes, just set the values. A transaction which would have to
+        // be rolled back anyway isn't started at all.
+        if (!rollbackOnFailure || invalidParams.isEmpty()) {
+            for (const QPair<Fact*, QVariant>& value: typedValues) {
+                value.first->setRawValue(value.second);
+            }
+        }
+        emit bulkWriteComplete(invalidParams.isEmpty(), invalidParams);
+        return true;
+    }
+
+    _bulkWrite = BulkWrite();
+    _bulkWrite.rollbackOnFailure = rollbackOnFailure;
+    _bulkWrite.failedParams = invalidParams;
+    _bulkWrite.items.reserve(typedValues.count());
+    for (const QPair<Fact*, QVariant>& value: typedValues) {
+        const auto existingIt = _bulkWrite.itemIndex.constFind(value.first);
+        if (existingIt != _bulkWrite.itemIndex.constEnd()) {
+            // Last value for a parameter wins
+            _bulkWrite.items[existingIt.value()].value = value.second;
+            continue;
+        }
+        _bulkWrite.itemIndex.insert(value.first, _bulkWrite.items.count());
+        _bulkWrite.items.append({ value.first, value.second, value.first->rawValue() });
+    }
+
+    qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "writeParameters: count" << _bulkWrite.items.count() << "rollbackOnFailure" << rollbackOnFailure;
+
+    _saveRequired = true;
+    _bulkWriteStart();
+
+    return true;
+}
+
+void ParameterManager::_bulkWriteStart(void)
+{
+    _bulkWrite.active = true;
+    _bulkWrite.elapsed.start();
+    _bulkWriteRetryTimer.start();
+    emit pendingWritesChanged(true);
+    emit bulkWriteProgressChanged();
+
+    _bulkWriteSendNext();
+}
+
+/// Keeps the window of PARAM_SETs waiting for an ack full
+void ParameterManager::_bulkWriteSendNext(void)
+{
+    while ((_bulkWrite.inFlight.count() < _maxBulkWritesInFlight) && (_bulkWrite.nextItem < _bulkWrite.items.count())) {
+        _bulkWriteSend(_bulkWrite.nextItem++);
+    }
+
+    if (_bulkWrite.inFlight.isEmpty() && (_bulkWrite.nextItem >= _bulkWrite.items.count())) {
+        _bulkWriteFinished();
+    }
+}
+
+void ParameterManager::_bulkWriteSend(int itemIndex)
+{
+    BulkWriteItem& item = _bulkWrite.items[itemIndex];
+
+    if (item.sentMSecs < 0) {
+        _bulkWrite.inFlight.append(itemIndex);
+    }
+    item.sentMSecs = _indexRequestTimer.elapsed();
+
+    _sendParamSetToVehicle(item.fact->componentId(), item.fact->name(), item.fact->type(), item.value);
+}
+
+/// Called when the vehicle sends a value for a fact while a bulk write is active
+void ParameterManager::_bulkWriteAck(Fact* fact)
+{
+    const auto indexIt = _bulkWrite.itemIndex.constFind(fact);
+    if (indexIt == _bulkWrite.itemIndex.constEnd()) {
+        return;
+    }
+    const int itemIndex = indexIt.value();
+    BulkWriteItem& item = _bulkWrite.items[itemIndex];
+    if (item.done || (item.sentMSecs < 0)) {
+        // Not written yet, this is some other update
+        return;
+    }
+
+    // Both sides have the fact's type, item.value was converted when the write was queued
+    const bool accepted = (fact->rawValue() == item.value);
+    if (!accepted) {
+        // The value may have been streamed or requested before the vehicle processed the PARAM_SET, so it isn't an
+        // answer yet. A vehicle which rejects the value keeps answering with the value it kept after a resend as well.
+        const bool rejected = (item.mismatchRetryCount >= 0) && (item.retryCount > item.mismatchRetryCount);
+        item.mismatchRetryCount = item.retryCount;
+        if (!rejected) {
+            qCDebug(ParameterManagerLog) << _logVehiclePrefix(fact->componentId()) << "Bulk write ignoring other value" << fact->name() << "requested" << item.value << "vehicle" << fact->rawValue();
+            return;
+        }
+        qCDebug(ParameterManagerLog) << _logVehiclePrefix(fact->componentId()) << "Bulk write rejected" << fact->name() << "requested" << item.value << "vehicle" << fact->rawValue();
+    } else if (item.retryCount == 0) {
+        _addRttSample(static_cast<double>(_indexRequestTimer.elapsed() - item.sentMSecs));
+    }
+    _bulkWrite.inFlight.removeOne(itemIndex);
+    item.sentMSecs = -1;
+
+    _bulkWriteItemDone(itemIndex, accepted);
+
+    _bulkWriteSendNext();
+}
+
+void ParameterManager::_bulkWriteItemDone(int itemIndex, bool accepted)
+{
+    BulkWriteItem& item = _bulkWrite.items[itemIndex];
+    item.done = true;
+    item.accepted = accepted;
+    _bulkWrite.doneCount++;
+
+    if (!accepted) {
+        _bulkWrite.failedParams.append(QStringLiteral("%1:%2").arg(item.fact->componentId()).arg(item.fact->name()));
+        if (_bulkWrite.rollbackOnFailure && !_bulkWrite.rollingBack) {
+            // Stop writing, what is still in flight finishes and is then rolled back along with the rest
+            _bulkWrite.nextItem = _bulkWrite.items.count();
+        }
+    }
+
+    const int totalCount = _bulkWrite.items.count();
+    const double elapsedSecs = qMax(_bulkWrite.elapsed.elapsed(), static_cast<qint64>(1)) / 1000.0;
+    _bulkWrite.paramsPerSecond = _bulkWrite.doneCount / elapsedSecs;
+    _bulkWrite.etaSecs = qCeil((totalCount - _bulkWrite.doneCount) / qMax(_bulkWrite.paramsPerSecond, 0.001));
+
+    _setLoadProgress(static_cast<double>(_bulkWrite.doneCount) / totalCount);
+    emit bulkWriteProgressChanged();
+}
+
+void ParameterManager::_bulkWriteRetryTimeout(void)
+{
+    const qint64 nowMSecs = _indexRequestTimer.elapsed();
+    const int retryTimeoutMSecs = _retryTimeoutMSecs();
+
+    const QList<int> inFlight = _bulkWrite.inFlight;
+    for (int itemIndex: inFlight) {
+        BulkWriteItem& item = _bulkWrite.items[itemIndex];
+        if ((nowMSecs - item.sentMSecs) < retryTimeoutMSecs) {
+            continue;
+        }
+
+        if (++item.retryCount > _maxReadWriteRetry) {
+            qCDebug(ParameterManagerLog) << _logVehiclePrefix(item.fact->componentId()) << "Bulk write failed" << item.fact->name();
+            _bulkWrite.inFlight.removeOne(itemIndex);
+            item.sentMSecs = -1;
+            _bulkWriteItemDone(itemIndex, false);
+        } else {
+            qCDebug(ParameterManagerLog) << _logVehiclePrefix(item.fact->componentId()) << "Bulk write resend" << item.fact->name() << "retryCount" << item.retryCount;
+            _bulkWriteSend(itemIndex);
+        }
+    }
+
+    _bulkWriteSendNext();
+}
+
+void ParameterManager::_bulkWriteFinished(void)
+{
+    if (!_bulkWrite.failedParams.isEmpty() && _bulkWrite.rollbackOnFailure && !_bulkWrite.rollingBack) {
+        // Put back everything the vehicle took. Failures are kept so the transaction still reports them.
+        BulkWrite rollback;
+        rollback.rollingBack = true;
+        rollback.failedParams = _bulkWrite.failedParams;
+        for (const BulkWriteItem& item: _bulkWrite.items) {
+            if (item.accepted) {
+                rollback.itemIndex.insert(item.fact, rollback.items.count());
+                rollback.items.append({ item.fact, item.previousValue, item.value });
+            }
+        }
+
+        if (!rollback.items.isEmpty()) {
+            qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Bulk write failed, rolling back" << rollback.items.count() << "parameters";
+            _bulkWrite = rollback;
+            _bulkWriteStart();
+            return;
+        }
+    }
+
+    qCDebug(ParameterManagerLog) << _logVehiclePrefix(-1) << "Bulk write complete: count" << _bulkWrite.items.count() << "failed" << _bulkWrite.failedParams.count() << "msecs" << _bulkWrite.elapsed.elapsed();
+
+    const QStringList failedParams = _bulkWrite.failedParams;
+    _bulkWrite = BulkWrite();
+    _bulkWriteRetryTimer.stop();
+    _setLoadProgress(0);
+    emit pendingWritesChanged(pendingWrites());
+    emit bulkWriteProgressChanged();
+
+    if (!failedParams.isEmpty()) {
+        qgcApp()->showAppMessage(tr("Parameter write failed: veh:%1 params:%2").arg(_vehicle->id()).arg(failedParams.join(QStringLiteral(", "))));
+    }
+    emit bulkWriteComplete(failedParams.isEmpty(), failedParams);
+}
+
 MAV_PARAM_TYPE ParameterManager::factTypeToMavType(FactMetaData::ValueType_t factType)
 {
     switch (factType) {
@@ -1163,14 +1593,14 @@ void ParameterManager::_checkInitialLoadComplete(void)
         return;
     }
 
-    for (int componentId: _waitingReadParamIndexMap.keys()) {
-        if (_waitingReadParamIndexMap[componentId].count()) {
+    for (const ComponentParameters& component: _components) {
+        if (component.waitingReadIndexCount) {
             // We are still waiting on some parameters, not done yet
             return;
         }
     }
 
-    if (!_mapCompId2FactMap.contains(_vehicle->defaultComponentId())) {
+    if (!_hasFacts(_vehicle->defaultComponentId())) {
         // No default component params yet, not done yet
         return;
     }
@@ -1195,8 +1625,9 @@ void ParameterManager::_checkInitialLoadComplete(void)
     // Check for index based load failures
     QString indexList;
     bool initialLoadFailures = false;
-    for (int componentId: _failedReadParamIndexMap.keys()) {
-        for (int paramIndex: _failedReadParamIndexMap[componentId]) {
+    for (auto componentIt = _components.constBegin(); componentIt != _components.constEnd(); componentIt++) {
+        const int componentId = componentIt.key();
+        for (int paramIndex: componentIt->failedReadIndices) {
             if (initialLoadFailures) {
                 indexList += ", ";
             }
@@ -1357,7 +1788,7 @@ void ParameterManager::_loadOfflineEditingParams(void)
         FactMetaData* factMetaData = _vehicle->compInfoManager()->compInfoParam(defaultComponentId)->factMetaDataForName(paramName, fact->type());
         fact->setMetaData(factMetaData);
 
-        _mapCompId2FactMap[defaultComponentId][paramName] = fact;
+        _components[defaultComponentId].facts.insert(paramName, fact);
     }
 
     _parametersReady = true;
@@ -1402,13 +1833,24 @@ void ParameterManager::_setLoadProgress(double loadProgress)
 
 QList<int> ParameterManager::componentIds(void)
 {
-    return _paramCountMap.keys();
+    QList<int> ids;
+
+    for (auto it = _components.constBegin(); it != _components.constEnd(); it++) {
+        if (it->countKnown) {
+            ids.append(it.key());
+        }
+    }
+
+    return ids;
 }
 
 bool ParameterManager::pendingWrites(void)
 {
-    for (int compId: _waitingWriteParamNameMap.keys()) {
-        if (_waitingWriteParamNameMap[compId].count()) {
+    if (_bulkWrite.active) {
+        return true;
+    }
+    for (const ComponentParameters& component: _components) {
+        if (component.waitingWriteNames.count()) {
             return true;
         }
     }
@@ -1582,17 +2024,15 @@ bool ParameterManager::_parseParamFile(const QString& filename)
                                               ptype == AP_PARAM_INT32 ? FactMetaData::valueTypeInt32 :
                                               FactMetaData::valueTypeFloat);
 
-        Fact* fact = nullptr;
-        if (_mapCompId2FactMap.contains(componentId) && _mapCompId2FactMap[componentId].contains(parameterName)) {
-            fact = _mapCompId2FactMap[componentId][parameterName];
-        } else {
+        Fact* fact = _findFact(componentId, parameterName);
+        if (!fact) {
             qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Adding new fact" << parameterName;
 
             fact = new Fact(componentId, parameterName, factType, this);
             FactMetaData* factMetaData = _vehicle->compInfoManager()->compInfoParam(componentId)->factMetaDataForName(parameterName, fact->type());
             fact->setMetaData(factMetaData);
 
-            _mapCompId2FactMap[componentId][parameterName] = fact;
+            _components[componentId].facts.insert(parameterName, fact);
 
             // We need to know when the fact value changes so we can update the vehicle
             connect(fact, &Fact::_containerRawValueChanged, this, &ParameterManager::_factRawValueUpdated);
@@ -1604,11 +2044,16 @@ bool ParameterManager::_parseParamFile(const QString& filename)
 Success:
     file.close();
     /* Create empty waiting lists as we have all parameters */
-    _paramCountMap[componentId] = num_params;
+    {
+        ComponentParameters& component = _components[componentId];
+        component.countKnown = true;
+        component.paramCount = num_params;
+        component.waitingReadIndexRetries.fill(-1, num_params);
+        component.waitingReadIndexCount = 0;
+        component.waitingReadNames.clear();
+        component.waitingWriteNames.clear();
+    }
     _totalParamCount += num_params;
-    _waitingReadParamIndexMap[componentId] = QMap<int, int>();
-    _waitingReadParamNameMap[componentId] = QMap<QString, int>();
-    _waitingWriteParamNameMap[componentId] = QMap<QString, int>();
     _checkInitialLoadComplete();
     _setLoadProgress(0.0);
     return true;
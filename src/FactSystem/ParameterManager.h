@@ -10,14 +10,17 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QHash>
 #include <QtCore/QMap>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QTimer>
 #include <QtCore/QString>
 #include <QtCore/QLoggingCategory>
 
 #include "Fact.h"
 #include "FactMetaData.h"
+#include "ParameterSnapshot.h"
 #include "MAVLinkLib.h"
 
 Q_DECLARE_LOGGING_CATEGORY(ParameterManagerVerbose1Log)
@@ -27,12 +30,14 @@ Q_DECLARE_LOGGING_CATEGORY(ParameterManagerDebugCacheFailureLog)
 class ParameterEditorController;
 class Vehicle;
 class MAVLinkProtocol;
+class ParameterCacheFile;
 
 class ParameterManager : public QObject
 {
     Q_OBJECT
 
     friend class ParameterEditorController;
+    friend class ParameterManagerTest;      // Unit test
 
 public:
     /// @param uas Uas which this set of facts is associated with
@@ -43,6 +48,13 @@ public:
     Q_PROPERTY(double   loadProgress        READ loadProgress       NOTIFY loadProgressChanged)
     Q_PROPERTY(bool     pendingWrites       READ pendingWrites      NOTIFY pendingWritesChanged)        ///< true: There are still pending write updates against the vehicle
 
+    // Progress of the current writeParameters transaction
+    Q_PROPERTY(bool     bulkWriteInProgress         READ bulkWriteInProgress        NOTIFY bulkWriteProgressChanged)
+    Q_PROPERTY(int      bulkWriteWrittenCount       READ bulkWriteWrittenCount      NOTIFY bulkWriteProgressChanged)    ///< Parameters acknowledged or failed so far
+    Q_PROPERTY(int      bulkWriteTotalCount         READ bulkWriteTotalCount        NOTIFY bulkWriteProgressChanged)
+    Q_PROPERTY(double   bulkWriteParamsPerSecond    READ bulkWriteParamsPerSecond   NOTIFY bulkWriteProgressChanged)
+    Q_PROPERTY(int      bulkWriteEtaSecs            READ bulkWriteEtaSecs           NOTIFY bulkWriteProgressChanged)
+
     bool parametersReady    (void) const { return _parametersReady; }
     bool missingParameters  (void) const { return _missingParameters; }
     double loadProgress     (void) const { return _loadProgress; }
@@ -88,6 +100,28 @@ public:
 
     void writeParametersToStream(QTextStream& stream);
 
+    /// @return The current values of all parameters of all components
+    ParameterSnapshot snapshot(void) const;
+
+    /// Compares the vehicle's parameters against a parameter file, for example a golden set for the airframe
+    /// @return One map per difference with: componentId, name, vehicleValue, fileValue, missingOnVehicle, missingInFile.
+    ///         Empty if the file can't be read or all parameters match.
+    Q_INVOKABLE QVariantList compareToFile(const QString& fileName) const;
+
+    /// Writes a set of parameters to the vehicle as a single transaction. The PARAM_SETs are streamed with a limited
+    /// number in flight and each fact is updated as the vehicle acknowledges its new value. Progress is reported through
+    /// the bulkWrite properties and the end of the transaction through bulkWriteComplete.
+    ///     @param values Facts with their new raw values. Values which can't be converted to the fact's type fail without being sent.
+    ///     @param rollbackOnFailure true: If a write fails, the parameters already written are set back to their previous values.
+    ///                              Nothing is written if one of the values is invalid.
+    /// @return false: Another transaction is still in progress
+    bool writeParameters(const QList<QPair<Fact*, QVariant>>& values, bool rollbackOnFailure = false);
+    bool    bulkWriteInProgress         (void) const { return _bulkWrite.active; }
+    int     bulkWriteWrittenCount       (void) const { return _bulkWrite.doneCount; }
+    int     bulkWriteTotalCount         (void) const { return static_cast<int>(_bulkWrite.items.count()); }
+    double  bulkWriteParamsPerSecond    (void) const { return _bulkWrite.paramsPerSecond; }
+    int     bulkWriteEtaSecs            (void) const { return _bulkWrite.etaSecs; }
+
     bool pendingWrites(void);
 
     Vehicle* vehicle(void);
@@ -103,6 +137,8 @@ signals:
     void loadProgressChanged        (float value);
     void pendingWritesChanged       (bool pendingWrites);
     void factAdded                  (int componentId, Fact* fact);
+    void bulkWriteProgressChanged   (void);
+    void bulkWriteComplete          (bool success, const QStringList& failedParams);    ///< failedParams: "componentId:name" of writes which failed
 
 private slots:
     void    _factRawValueUpdated                (const QVariant& rawValue);
@@ -111,6 +147,7 @@ private:
     void    _handleParamValue                   (int componentId, QString parameterName, int parameterCount, int parameterIndex, MAV_PARAM_TYPE mavParamType, QVariant parameterValue);
     void    _factRawValueUpdateWorker           (int componentId, const QString& name, FactMetaData::ValueType_t valueType, const QVariant& rawValue);
     void    _waitingParamTimeout                (void);
+    void    _bulkWriteRetryTimeout              (void);
     void    _tryCacheLookup                     (void);
     void    _initialRequestTimeout              (void);
     int     _actualComponentId                  (int componentId);
@@ -118,6 +155,7 @@ private:
     void    _sendParamSetToVehicle              (int componentId, const QString& paramName, FactMetaData::ValueType_t valueType, const QVariant& value);
     void    _writeLocalParamCache               (int vehicleId, int componentId);
     void    _tryCacheHashLoad                   (int vehicleId, int componentId, QVariant hash_value);
+    void    _applyParameterCache                (int componentId, const ParameterCacheFile& cache);
     void    _loadMetaData                       (void);
     void    _clearMetaData                      (void);
     QString _remapParamNameToVersion            (const QString& paramName);
@@ -130,13 +168,43 @@ private:
     void    _ftpDownloadComplete                (const QString& fileName, const QString& errorMsg);
     void    _ftpDownloadProgress                (float progress);
     bool    _parseParamFile                     (const QString& filename);
+    Fact*   _findFact                           (int componentId, const QString& paramName) const;
+    bool    _hasFacts                           (int componentId) const;
+    void    _waitingParamCounts                 (int& waitingReadParamIndexCount, int& waitingReadParamNameCount, int& waitingWriteParamNameCount) const;
+    void    _indexRequestAnswered               (int paramIndex);
+    void    _indexRequestsLost                  (int lostCount, quint32 newestLostSequence);
+    void    _updateWaitingParamTimeout          (void);
+    void    _addRttSample                       (double rttMSecs);
+    int     _retryTimeoutMSecs                  (void) const;
+    void    _bulkWriteStart                     (void);
+    void    _bulkWriteSendNext                  (void);
+    void    _bulkWriteSend                      (int itemIndex);
+    void    _bulkWriteAck                       (Fact* fact);
+    void    _bulkWriteItemDone                  (int itemIndex, bool accepted);
+    void    _bulkWriteFinished                  (void);
 
     static QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool failOk = false);
 
     Vehicle*            _vehicle;
     MAVLinkProtocol*    _mavlink;
 
-    QMap<int /* comp id */, QMap<QString /* parameter name */, Fact*>> _mapCompId2FactMap;
+    /// Parameters and request bookkeeping for a single component. Names are hashed and the index based load state is
+    /// an array addressed by parameter index, so handling a PARAM_VALUE doesn't need any ordered string lookups.
+    struct ComponentParameters {
+        QHash<QString, Fact*>   facts;                          ///< Parameter name to Fact
+        bool                    countKnown              = false;///< true: Component has reported its parameter count, wait lists are set up
+        int                     paramCount              = 0;    ///< Count of parameters in this component
+        QList<int>              waitingReadIndexRetries;        ///< Retry count for each parameter index, -1: not waiting for the index
+        int                     waitingReadIndexCount   = 0;    ///< Number of indices in waitingReadIndexRetries still waiting
+        QHash<QString, int>     waitingReadNames;               ///< Parameter name still waiting for, retry count
+        QHash<QString, int>     waitingWriteNames;              ///< Parameter name still waiting for, retry count
+        QList<int>              failedReadIndices;              ///< Indices given up on during initial load
+
+        bool isWaitingForIndex  (int index) const { return index >= 0 && index < waitingReadIndexRetries.count() && waitingReadIndexRetries[index] >= 0; }
+        void setWaitingForIndex (int index, bool waiting);
+    };
+
+    QMap<int /* comp id */, ComponentParameters> _components;
 
     double      _loadProgress;                  ///< Parameter load progess, [0.0,1.0]
     bool        _parametersReady;               ///< true: parameter load complete
@@ -169,19 +237,68 @@ private:
     static const int    _maxReadWriteRetry = 5;                 ///< Maximum retries read/write
     bool                _disableAllRetries;                     ///< true: Don't retry any requests (used for testing)
 
-    bool        _indexBatchQueueActive; ///< true: we are actively batching re-requests for missing index base params, false: index based re-request has not yet started
-    QList<int>  _indexBatchQueue;       ///< The current queue of index re-requests
-
-    QMap<int, int>                  _paramCountMap;             ///< Key: Component id, Value: count of parameters in this component
-    QMap<int, QMap<int, int> >      _waitingReadParamIndexMap;  ///< Key: Component id, Value: Map { Key: parameter index still waiting for, Value: retry count }
-    QMap<int, QMap<QString, int> >  _waitingReadParamNameMap;   ///< Key: Component id, Value: Map { Key: parameter name still waiting for, Value: retry count }
-    QMap<int, QMap<QString, int> >  _waitingWriteParamNameMap;  ///< Key: Component id, Value: Map { Key: parameter name still waiting for, Value: retry count }
-    QMap<int, QList<int> >          _failedReadParamIndexMap;   ///< Key: Component id, Value: failed parameter index
+    struct IndexRequest {
+        quint32 sequence;   ///< Order the request was sent in
+        qint64  sentMSecs;  ///< Time the request was sent, -1 for a retry since its answer can't be matched to a single request
+    };
+
+    bool                            _indexBatchQueueActive; ///< true: we are actively batching re-requests for missing index base params, false: index based re-request has not yet started
+    QHash<int, IndexRequest>        _indexBatchQueue;       ///< Index re-requests in flight, Key: parameter index
+
+    // The index re-requests are a sliding window. The window grows as requests are answered and is halved when requests
+    // are lost at a higher rate than the link as a whole is losing messages. The retry timeout follows the measured round
+    // trip time of the requests.
+    QElapsedTimer   _indexRequestTimer;
+    quint32         _indexRequestSequence           = 0;
+    int             _indexBatchWindow               = _initialIndexBatchWindow;
+    int             _indexBatchWindowAnswered       = 0;    ///< Requests answered since the window last grew
+    quint32         _indexBatchWindowReducedSequence = 0;   ///< Losses of requests sent up to this sequence don't reduce the window again
+    double          _indexRequestLossPercent        = 0;    ///< Smoothed loss rate of index requests
+    double          _indexRequestRttMSecs           = 0;    ///< Smoothed round trip time of index requests, 0: no samples yet
+    double          _indexRequestRttVarMSecs        = 0;    ///< Round trip time variation
+
+    static const int _initialIndexBatchWindow   = 10;
+    static const int _minIndexBatchWindow       = 2;
+    static const int _maxIndexBatchWindow       = 64;
+    static const int _indexReorderTolerance     = 3;        ///< Answers which can overtake a request before it is considered lost
+    static const int _waitingParamTimeoutMSecs  = 3000;
+    static const int _minIndexRetryTimeoutMSecs = 250;
 
     int _totalParamCount;                       ///< Number of parameters across all components
     int _waitingWriteParamBatchCount = 0;       ///< Number of parameters which are batched up waiting on write responses
     int _waitingReadParamNameBatchCount = 0;    ///< Number of parameters which are batched up waiting on read responses
 
+    struct BulkWriteItem {
+        Fact*       fact;
+        QVariant    value;
+        QVariant    previousValue;
+        int         retryCount  = 0;
+        qint64      sentMSecs   = -1;       ///< Time the last PARAM_SET was sent, -1: not in flight
+        bool        done        = false;
+        bool        accepted    = false;    ///< Vehicle acknowledged the new value
+        int         mismatchRetryCount = -1;    ///< retryCount when the vehicle last answered with another value, -1: never
+    };
+
+    struct BulkWrite {
+        bool                    active              = false;
+        bool                    rollbackOnFailure   = false;
+        bool                    rollingBack         = false;
+        QList<BulkWriteItem>    items;
+        QHash<Fact*, int>       itemIndex;          ///< Acks are matched by fact, Value: index into items
+        QList<int>              inFlight;           ///< Items with a PARAM_SET waiting for its ack
+        int                     nextItem            = 0;
+        int                     doneCount           = 0;
+        QStringList             failedParams;
+        QElapsedTimer           elapsed;
+        double                  paramsPerSecond     = 0;
+        int                     etaSecs             = 0;
+    };
+
+    BulkWrite   _bulkWrite;
+    QTimer      _bulkWriteRetryTimer;
+
+    static const int _maxBulkWritesInFlight = 10;
+
     QTimer _initialRequestTimeoutTimer;
     QTimer _waitingParamTimeoutTimer;
 
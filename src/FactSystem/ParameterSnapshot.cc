@@ -0,0 +1,232 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterSnapshot.h"
+#include "ParameterManager.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QTextStream>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(ParameterSnapshotLog, "ParameterSnapshotLog")
+
+ParameterSnapshot::ParameterSnapshot(int vehicleId, const QList<Entry>& entries)
+    : _vehicleId(vehicleId)
+    , _entries  (entries)
+{
+    std::sort(_entries.begin(), _entries.end(), [](const Entry& left, const Entry& right) {
+        return _lessThan(left, right.componentId, right.name);
+    });
+}
+
+bool ParameterSnapshot::_lessThan(const Entry& entry, int componentId, const QString& name)
+{
+    if (entry.componentId != componentId) {
+        return entry.componentId < componentId;
+    }
+    return entry.name < name;
+}
+
+ParameterSnapshot ParameterSnapshot::fromStream(QTextStream& stream, QString& errorString)
+{
+    errorString.clear();
+
+    int             vehicleId = 0;
+    QList<Entry>    entries;
+    QHash<QPair<int, QString>, int> entryIndex;
+
+    int lineNumber = 0;
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine();
+        lineNumber++;
+        if (line.startsWith(QLatin1Char('#')) || line.trimmed().isEmpty()) {
+            continue;
+        }
+
+        const QStringList fields = line.split(QLatin1Char('\t'));
+        if (fields.size() != 5) {
+            errorString = QObject::tr("Invalid parameter file line %1: %2").arg(lineNumber).arg(line);
+            return ParameterSnapshot();
+        }
+
+        Entry entry;
+        vehicleId           = fields.at(0).toInt();
+        entry.componentId   = fields.at(1).toInt();
+        entry.name          = fields.at(2);
+        entry.type          = ParameterManager::mavTypeToFactType(static_cast<MAV_PARAM_TYPE>(fields.at(4).toUInt()));
+
+        // Same variant types as values received from the vehicle
+        const QString& valueString = fields.at(3);
+        bool ok = false;
+        switch (entry.type) {
+        case FactMetaData::valueTypeUint8:
+        case FactMetaData::valueTypeUint16:
+        case FactMetaData::valueTypeUint32:
+            entry.value = valueString.toUInt(&ok);
+            break;
+        case FactMetaData::valueTypeInt8:
+        case FactMetaData::valueTypeInt16:
+        case FactMetaData::valueTypeInt32:
+            entry.value = valueString.toInt(&ok);
+            break;
+        case FactMetaData::valueTypeUint64:
+            entry.value = valueString.toULongLong(&ok);
+            break;
+        case FactMetaData::valueTypeInt64:
+            entry.value = valueString.toLongLong(&ok);
+            break;
+        case FactMetaData::valueTypeFloat:
+            entry.value = valueString.toFloat(&ok);
+            break;
+        default:
+            entry.value = valueString.toDouble(&ok);
+            break;
+        }
+        if (!ok) {
+            errorString = QObject::tr("Invalid value for %1 on parameter file line %2: %3").arg(entry.name).arg(lineNumber).arg(valueString);
+            return ParameterSnapshot();
+        }
+
+        // Last value wins for a parameter listed more than once
+        const auto existingIt = entryIndex.constFind({ entry.componentId, entry.name });
+        if (existingIt != entryIndex.constEnd()) {
+            entries[existingIt.value()] = entry;
+            continue;
+        }
+        entryIndex.insert({ entry.componentId, entry.name }, static_cast<int>(entries.count()));
+        entries.append(entry);
+    }
+
+    return ParameterSnapshot(vehicleId, entries);
+}
+
+ParameterSnapshot ParameterSnapshot::fromFile(const QString& fileName, QString& errorString)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        errorString = QObject::tr("Unable to open file: %1").arg(fileName);
+        return ParameterSnapshot();
+    }
+
+    QTextStream stream(&file);
+    const ParameterSnapshot snapshot = fromStream(stream, errorString);
+    qCDebug(ParameterSnapshotLog) << "Read" << snapshot.count() << "parameters from" << fileName << errorString;
+    return snapshot;
+}
+
+const ParameterSnapshot::Entry* ParameterSnapshot::find(int componentId, const QString& name) const
+{
+    const auto it = std::lower_bound(_entries.cbegin(), _entries.cend(), name, [componentId](const Entry& entry, const QString& name) {
+        return _lessThan(entry, componentId, name);
+    });
+    if (it == _entries.cend() || it->componentId != componentId || it->name != name) {
+        return nullptr;
+    }
+    return &(*it);
+}
+
+QList<ParameterSnapshot::Difference> ParameterSnapshot::diff(const ParameterSnapshot& other) const
+{
+    QList<Difference> differences;
+
+    auto thisIt = _entries.cbegin();
+    auto otherIt = other._entries.cbegin();
+    while (thisIt != _entries.cend() || otherIt != other._entries.cend()) {
+        if (otherIt == other._entries.cend() || (thisIt != _entries.cend() && _lessThan(*thisIt, otherIt->componentId, otherIt->name))) {
+            differences.append({ Difference::OnlyInThis, thisIt->componentId, thisIt->name, thisIt->value, QVariant() });
+            thisIt++;
+        } else if (thisIt == _entries.cend() || _lessThan(*otherIt, thisIt->componentId, thisIt->name)) {
+            differences.append({ Difference::OnlyInOther, otherIt->componentId, otherIt->name, QVariant(), otherIt->value });
+            otherIt++;
+        } else {
+            // QVariant compares numbers by value, so an int and a uint for the same parameter still match
+            if (thisIt->value != otherIt->value) {
+                differences.append({ Difference::ValueChanged, thisIt->componentId, thisIt->name, thisIt->value, otherIt->value });
+            }
+            thisIt++;
+            otherIt++;
+        }
+    }
+
+    return differences;
+}
+
+QStringList ParameterSnapshot::parameterFiles(const QString& path)
+{
+    const QFileInfo pathInfo(path);
+    if (!pathInfo.isDir()) {
+        return pathInfo.exists() ? QStringList(pathInfo.absoluteFilePath()) : QStringList();
+    }
+
+    QStringList files;
+    const QDir dir(path);
+    for (const QString& fileName: dir.entryList({ QStringLiteral("*.params"), QStringLiteral("*.param") }, QDir::Files, QDir::Name)) {
+        files.append(dir.absoluteFilePath(fileName));
+    }
+    return files;
+}
+
+int ParameterSnapshot::compareFiles(const QString& goldenFile, const QString& path, QTextStream& output)
+{
+    QString errorString;
+    const ParameterSnapshot golden = fromFile(goldenFile, errorString);
+    if (!errorString.isEmpty()) {
+        output << errorString << Qt::endl;
+        return -1;
+    }
+
+    const QStringList files = parameterFiles(path);
+    if (files.isEmpty()) {
+        output << QObject::tr("No parameter files found at %1").arg(path) << Qt::endl;
+        return -1;
+    }
+
+    int result = 0;
+    for (const QString& file: files) {
+        if (QFileInfo(file) == QFileInfo(goldenFile)) {
+            continue;
+        }
+
+        const ParameterSnapshot snapshot = fromFile(file, errorString);
+        if (!errorString.isEmpty()) {
+            output << file << ": " << errorString << Qt::endl;
+            result = -1;
+            continue;
+        }
+
+        const QList<Difference> differences = golden.diff(snapshot);
+        output << file << ": " << differences.count() << " differences" << Qt::endl;
+        for (const Difference& difference: differences) {
+            output << "\t" << difference.componentId << "\t" << difference.name << "\t";
+            switch (difference.kind) {
+            case Difference::ValueChanged:
+                output << difference.value.toString() << " -> " << difference.otherValue.toString();
+                break;
+            case Difference::OnlyInThis:
+                output << difference.value.toString() << " -> missing";
+                break;
+            case Difference::OnlyInOther:
+                output << "missing -> " << difference.otherValue.toString();
+                break;
+            }
+            output << Qt::endl;
+        }
+
+        if (!differences.isEmpty() && result == 0) {
+            result = 1;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,85 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "FactMetaData.h"
+
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+
+class QTextStream;
+
+Q_DECLARE_LOGGING_CATEGORY(ParameterSnapshotLog)
+
+/// Immutable set of parameter values, taken from a vehicle with ParameterManager::snapshot or read from a parameter
+/// file. The parameters are kept sorted by component and name, so comparing two snapshots is a single merge pass over
+/// both of them. Copies share the same data.
+class ParameterSnapshot
+{
+public:
+    struct Entry {
+        int                         componentId;
+        QString                     name;
+        FactMetaData::ValueType_t   type;
+        QVariant                    value;      ///< Raw value
+    };
+
+    struct Difference {
+        enum Kind {
+            ValueChanged,   ///< Parameter is in both snapshots with different values
+            OnlyInThis,     ///< Parameter is missing from the other snapshot
+            OnlyInOther,    ///< Parameter is only in the other snapshot
+        };
+
+        Kind        kind;
+        int         componentId;
+        QString     name;
+        QVariant    value;          ///< Value in this snapshot, invalid for OnlyInOther
+        QVariant    otherValue;     ///< Value in the other snapshot, invalid for OnlyInThis
+    };
+
+    ParameterSnapshot() = default;
+
+    /// @param entries Parameters in any order, a parameter must only be in the list once
+    ParameterSnapshot(int vehicleId, const QList<Entry>& entries);
+
+    /// Reads a parameter file in the format written by ParameterManager::writeParametersToStream
+    ///     @param errorString Set if the stream isn't a parameter file
+    static ParameterSnapshot fromStream(QTextStream& stream, QString& errorString);
+    static ParameterSnapshot fromFile(const QString& fileName, QString& errorString);
+
+    int                     vehicleId   () const { return _vehicleId; }
+    int                     count       () const { return static_cast<int>(_entries.count()); }
+    bool                    isEmpty     () const { return _entries.isEmpty(); }
+    const QList<Entry>&     entries     () const { return _entries; }
+
+    /// @return The parameter, nullptr if not in the snapshot
+    const Entry* find(int componentId, const QString& name) const;
+
+    /// @return Parameters which differ between this snapshot and @a other, sorted by component and name
+    QList<Difference> diff(const ParameterSnapshot& other) const;
+
+    /// @return Parameter files for @a path, which is either a single parameter file or a directory of them
+    static QStringList parameterFiles(const QString& path);
+
+    /// Compares every parameter file at @a path against @a goldenFile and writes the differences to @a output.
+    /// Used by the --param-golden and --param-diff command line options.
+    /// @return 0: All files match, 1: Differences found, -1: A file couldn't be read
+    static int compareFiles(const QString& goldenFile, const QString& path, QTextStream& output);
+
+private:
+    static bool _lessThan(const Entry& entry, int componentId, const QString& name);
+
+    int             _vehicleId = 0;
+    QList<Entry>    _entries;
+};
@@ -140,6 +140,26 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
     }
     _parameterMetaDataLoaded = true;
 
+    if (_parameterTable.load(metaDataFile, kParserVersion)) {
+        qCDebug(APMParameterMetaDataLog) << "Loaded compiled parameter meta data:" << metaDataFile;
+        return;
+    }
+
+    QMap<QString, ParameterNametoFactMetaDataMap> vehicleTypeToParametersMap;
+    _parseParameterFactMetaDataFile(metaDataFile, vehicleTypeToParametersMap);
+
+    QList<APMFactMetaDataRaw> parameters;
+    for (auto vehicleIt = vehicleTypeToParametersMap.begin(); vehicleIt != vehicleTypeToParametersMap.end(); ++vehicleIt) {
+        for (APMFactMetaDataRaw& rawMetaData: vehicleIt.value()) {
+            rawMetaData.section = vehicleIt.key();
+            parameters.append(rawMetaData);
+        }
+    }
+    _parameterTable.build(metaDataFile, kParserVersion, parameters);
+}
+
+void APMParameterMetaData::_parseParameterFactMetaDataFile(const QString& metaDataFile, QMap<QString, ParameterNametoFactMetaDataMap>& vehicleTypeToParametersMap)
+{
     QString currentCategory;
 
     qCDebug(APMParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
@@ -250,14 +270,12 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                           << "group: " << group;
 
                 Q_ASSERT(!rawMetaData);
-                if (_vehicleTypeToParametersMap[currentCategory].contains(name)) {
+                if (vehicleTypeToParametersMap[currentCategory].contains(name)) {
                     qCDebug(APMParameterMetaDataLog) << "Duplicate parameter found:" << name;
-                    rawMetaData = _vehicleTypeToParametersMap[currentCategory][name];
                 } else {
-                    rawMetaData = new APMFactMetaDataRaw(this);
-                    _vehicleTypeToParametersMap[currentCategory][name] = rawMetaData;
                     groupMembers[group] << name;
                 }
+                rawMetaData = &vehicleTypeToParametersMap[currentCategory][name];
                 qCDebug(APMParameterMetaDataVerboseLog) << "inserting metadata for field" << name;
                 rawMetaData->name = name;
                 if (!category.isEmpty()) {
@@ -292,7 +310,7 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                 xmlState.pop();
             } else if (elementName == "parameters") {
                 qCDebug(APMParameterMetaDataVerboseLog) << "end of parameters for category: " << currentCategory;
-                correctGroupMemberships(_vehicleTypeToParametersMap[currentCategory], groupMembers);
+                correctGroupMemberships(vehicleTypeToParametersMap[currentCategory], groupMembers);
                 groupMembers.clear();
                 xmlState.pop();
             } else if (elementName == "vehicles") {
@@ -310,7 +328,7 @@ void APMParameterMetaData::correctGroupMemberships(ParameterNametoFactMetaDataMa
     foreach(const QString& groupName, groupMembers.keys()) {
             if (groupMembers[groupName].count() == 1) {
                 foreach(const QString& parameter, groupMembers.value(groupName)) {
-                    parameterToFactMetaDataMap[parameter]->group = FactMetaData::defaultGroup();
+                    parameterToFactMetaDataMap[parameter].group = FactMetaData::defaultGroup();
                 }
             }
         }
@@ -370,7 +388,7 @@ bool APMParameterMetaData::parseParameterAttributes(QXmlStreamReader& xml, APMFa
             } else if (attributeName == "Increment") {
                 QString increment = xml.readElementText();
                 qCDebug(APMParameterMetaDataVerboseLog) << "read Increment: " << increment;
-                rawMetaData->incrementSize = increment;
+                rawMetaData->increment = increment;
             } else if (attributeName == "Units") {
                 QString units = xml.readElementText();
                 qCDebug(APMParameterMetaDataVerboseLog) << "read Units: " << units;
@@ -431,14 +449,13 @@ FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_
 {
     bool                keepTrying      = true;
     QString             mavTypeString   = mavTypeToString(vehicleType);
+    APMFactMetaDataRaw  foundMetaData;
     APMFactMetaDataRaw* rawMetaData     = nullptr;
 
     // check if we have metadata for fact, use generic otherwise
     while (keepTrying) {
-        if (_vehicleTypeToParametersMap[mavTypeString].contains(name)) {
-            rawMetaData = _vehicleTypeToParametersMap[mavTypeString][name];
-        } else if (_vehicleTypeToParametersMap["libraries"].contains(name)) {
-            rawMetaData = _vehicleTypeToParametersMap["libraries"][name];
+        if (_parameterTable.find(mavTypeString, name, foundMetaData) || _parameterTable.find(QStringLiteral("libraries"), name, foundMetaData)) {
+            rawMetaData = &foundMetaData;
         }
         if (!rawMetaData && mavTypeString == "Rover") {
             // Hack city: Older versions of Rover have different name
@@ -600,14 +617,14 @@ FactMetaData* APMParameterMetaData::getMetaDataForFact(const QString& name, MAV_
         }
     }
 
-    if (!rawMetaData->incrementSize.isEmpty()) {
+    if (!rawMetaData->increment.isEmpty()) {
         double  increment;
         bool    ok;
-        increment = rawMetaData->incrementSize.toDouble(&ok);
+        increment = rawMetaData->increment.toDouble(&ok);
         if (ok) {
             metaData->setRawIncrement(increment);
         } else {
-            qCDebug(APMParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << rawMetaData->incrementSize;
+            qCDebug(APMParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << rawMetaData->increment;
         }
     }
 
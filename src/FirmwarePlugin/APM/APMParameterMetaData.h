@@ -17,37 +17,15 @@
 
 #include "MAVLinkLib.h"
 #include "FactMetaData.h"
+#include "ParameterMetaDataTable.h"
 
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataLog)
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataVerboseLog)
 
-class APMFactMetaDataRaw : public QObject
-{
-    Q_OBJECT
-public:
-    APMFactMetaDataRaw(QObject *parent = nullptr)
-        : QObject(parent), rebootRequired(false)
-    { }
-
-    QString name;
-    QString category;
-    QString group;
-    QString shortDescription;
-    QString longDescription;
-    QString min;
-    QString max;
-    QString incrementSize;
-    QString units;
-    bool    rebootRequired;
-    bool    readOnly;
-    QList<QPair<QString, QString> > values;
-    QList<QPair<QString, QString> > bitmask;
-};
-
-
 /// Collection of Parameter Facts for PX4 AutoPilot
 
-typedef QMap<QString, APMFactMetaDataRaw*> ParameterNametoFactMetaDataMap;
+typedef ParameterMetaDataTable::Parameter APMFactMetaDataRaw;
+typedef QMap<QString, APMFactMetaDataRaw> ParameterNametoFactMetaDataMap;
 
 class APMParameterMetaData : public QObject
 {
@@ -75,15 +53,18 @@ private:
     };    
 
     QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
+    void _parseParameterFactMetaDataFile(const QString& metaDataFile, QMap<QString, ParameterNametoFactMetaDataMap>& vehicleTypeToParametersMap);
     bool skipXMLBlock(QXmlStreamReader& xml, const QString& blockName);
     bool parseParameterAttributes(QXmlStreamReader& xml, APMFactMetaDataRaw *rawMetaData);
     void correctGroupMemberships(ParameterNametoFactMetaDataMap& parameterToFactMetaDataMap, QMap<QString,QStringList>& groupMembers);
     QString mavTypeToString(MAV_TYPE vehicleTypeEnum);
     QString _groupFromParameterName(const QString& name);
 
-    bool                                            _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
-    // FIXME: metadata is vehicle type specific now
-    QMap<QString, ParameterNametoFactMetaDataMap>   _vehicleTypeToParametersMap;                ///< Maps from a vehicle type to paramametertoFactMeta map>
+    bool                    _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
+    ParameterMetaDataTable  _parameterTable;                            ///< Parameter meta data, the vehicle type is the section
+
+    /// Bump whenever parsing changes so cached tables from older versions are rebuilt
+    static constexpr quint32 kParserVersion = 1;
 
     static constexpr const char* kInvalidConverstion = "Internal Error: No support for string parameters";
 };
@@ -45,6 +45,9 @@ class APMSubmarineFactGroup : public FactGroup
 public:
     APMSubmarineFactGroup(QObject* parent = nullptr);
 
+    // Overrides from FactGroup
+    QList<uint32_t> handledMessageIds() const override { return {}; }  ///< Filled in by the firmware plugin
+
     Q_PROPERTY(Fact* camTilt             READ camTilt             CONSTANT)
     Q_PROPERTY(Fact* tetherTurns         READ tetherTurns         CONSTANT)
     Q_PROPERTY(Fact* lightsLevel1        READ lightsLevel1        CONSTANT)
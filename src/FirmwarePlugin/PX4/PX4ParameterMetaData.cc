@@ -85,6 +85,21 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
     }
     _parameterMetaDataLoaded = true;
 
+    if (!_parameterTable.load(metaDataFile, kParserVersion)) {
+        QList<ParameterMetaDataTable::Parameter> parameters;
+        _parseParameterFactMetaDataFile(metaDataFile, parameters);
+        _parameterTable.build(metaDataFile, kParserVersion, parameters);
+    } else {
+        qCDebug(PX4ParameterMetaDataLog) << "Loaded compiled parameter meta data:" << metaDataFile;
+    }
+
+#ifdef GENERATE_PARAMETER_JSON
+    _generateParameterJson();
+#endif
+}
+
+void PX4ParameterMetaData::_parseParameterFactMetaDataFile(const QString& metaDataFile, QList<ParameterMetaDataTable::Parameter>& parameters)
+{
     qCDebug(PX4ParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
 
     QFile xmlFile(metaDataFile);
@@ -106,11 +121,11 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
         return;
     }
     
-    QString         factGroup;
-    QString         errorString;
-    FactMetaData*   metaData = nullptr;
-    int             xmlState = XmlStateNone;
-    bool            badMetaData = true;
+    QString                                 factGroup;
+    QMap<QString, qsizetype>                parameterIndices;   ///< Parameter name to index in parameters
+    ParameterMetaDataTable::Parameter*      metaData = nullptr;
+    int                                     xmlState = XmlStateNone;
+    bool                                    badMetaData = true;
     
     while (!xml.atEnd()) {
         if (xml.isStartElement()) {
@@ -208,31 +223,28 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                     return;
                 }
                 
-                // Now that we know type we can create meta data object and add it to the system
-                metaData = new FactMetaData(foundType, this);
-                if (_mapParameterName2FactMetaData.contains(name)) {
+                // Now that we know type we can add the parameter
+                ParameterMetaDataTable::Parameter parameter;
+                parameter.name = name;
+                parameter.type = foundType;
+                if (parameterIndices.contains(name)) {
                     // We can't trust the meta data since we have dups
                     qCWarning(PX4ParameterMetaDataLog) << "Duplicate parameter found:" << name;
                     badMetaData = true;
                     // Reset to default meta data
-                    _mapParameterName2FactMetaData[name] = metaData;
+                    parameters[parameterIndices[name]] = parameter;
+                    metaData = &parameters[parameterIndices[name]];
                 } else {
-                    _mapParameterName2FactMetaData[name] = metaData;
-                    metaData->setName(name);
-                    metaData->setCategory(category);
-                    metaData->setGroup(factGroup);
-                    metaData->setReadOnly(readOnly);
-                    metaData->setVolatileValue(volatileValue);
-                    
-                    if (xml.attributes().hasAttribute("default") && !strDefault.isEmpty()) {
-                        QVariant varDefault;
-                        
-                        if (metaData->convertAndValidateRaw(strDefault, false, varDefault, errorString)) {
-                            metaData->setRawDefaultValue(varDefault);
-                        } else {
-                            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << name << " type:" << type << " default:" << strDefault << " error:" << errorString;
-                        }
+                    parameter.category = category;
+                    parameter.group = factGroup;
+                    parameter.readOnly = readOnly;
+                    parameter.volatileValue = volatileValue;
+                    if (xml.attributes().hasAttribute("default")) {
+                        parameter.defaultValue = strDefault;
                     }
+                    parameterIndices[name] = parameters.count();
+                    parameters.append(parameter);
+                    metaData = &parameters.last();
                 }
                 
             } else {
@@ -248,58 +260,39 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                             QString text = xml.readElementText();
                             text = text.replace("\n", " ");
                             qCDebug(PX4ParameterMetaDataLog) << "Short description:" << text;
-                            metaData->setShortDescription(text);
+                            metaData->shortDescription = text;
 
                         } else if (elementName == "long_desc") {
                             QString text = xml.readElementText();
                             text = text.replace("\n", " ");
                             qCDebug(PX4ParameterMetaDataLog) << "Long description:" << text;
-                            metaData->setLongDescription(text);
+                            metaData->longDescription = text;
 
                         } else if (elementName == "min") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Min:" << text;
-
-                            QVariant varMin;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMin, errorString)) {
-                                metaData->setRawMin(varMin);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << text << " error:" << errorString;
-                            }
+                            metaData->min = text;
 
                         } else if (elementName == "max") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Max:" << text;
-
-                            QVariant varMax;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMax, errorString)) {
-                                metaData->setRawMax(varMax);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << text << " error:" << errorString;
-                            }
+                            metaData->max = text;
 
                         } else if (elementName == "unit") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Unit:" << text;
-                            metaData->setRawUnits(text);
+                            metaData->units = text;
 
                         } else if (elementName == "decimal") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "Decimal:" << text;
-
-                            bool convertOk;
-                            QVariant varDecimals = QVariant(text).toUInt(&convertOk);
-                            if (convertOk) {
-                                metaData->setDecimalPlaces(varDecimals.toInt());
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << text << " error: invalid number";
-                            }
+                            metaData->decimalPlaces = text;
 
                         } else if (elementName == "reboot_required") {
                             QString text = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "RebootRequired:" << text;
                             if (text.compare("true", Qt::CaseInsensitive) == 0) {
-                                metaData->setVehicleRebootRequired(true);
+                                metaData->rebootRequired = true;
                             }
 
                         } else if (elementName == "values") {
@@ -310,60 +303,24 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
                             QString enumString = xml.readElementText();
                             qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
                                                              << "value desc:" << enumString << "code:" << enumValueStr;
+                            metaData->values.append({ enumValueStr, enumString });
 
-                            QVariant    enumValue;
-                            QString     errorString;
-                            if (metaData->convertAndValidateRaw(enumValueStr, false /* validate */, enumValue, errorString)) {
-                                metaData->addEnumInfo(enumString, enumValue);
-                            } else {
-                                qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
-                                                                 << " type:" << metaData->type() << " value:" << enumValueStr
-                                                                 << " error:" << errorString;
-                            }
                         } else if (elementName == "increment") {
-                            double  increment;
-                            bool    ok;
                             QString text = xml.readElementText();
-                            increment = text.toDouble(&ok);
-                            if (ok) {
-                                metaData->setRawIncrement(increment);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << text;
-                            }
+                            metaData->increment = text;
 
                         } else if (elementName == "boolean") {
-                            QVariant    enumValue;
-                            metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Enabled"), enumValue);
-                            metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Disabled"), enumValue);
+                            metaData->boolean = true;
 
                         } else if (elementName == "bitmask") {
                             // doing nothing individual bits will follow anyway. May be used for sanity checking.
 
                         } else if (elementName == "bit") {
-                            bool ok = false;
-                            unsigned char bit = xml.attributes().value("index").toString().toUInt(&ok);
-                            if (ok) {
-                                QString bitDescription = xml.readElementText();
-                                qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
-                                                                 << "index:" << bit << "description:" << bitDescription;
-
-                                if (bit < 31) {
-                                    QVariant bitmaskRawValue = 1 << bit;
-                                    QVariant bitmaskValue;
-                                    QString errorString;
-                                    if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
-                                        metaData->addBitmaskInfo(bitDescription, bitmaskValue);
-                                    } else {
-                                        qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
-                                                                         << " type:" << metaData->type() << " value:" << bitmaskValue
-                                                                         << " error:" << errorString;
-                                    }
-                                } else {
-                                    qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
-                                }
-                            }
+                            QString bitIndex = xml.attributes().value("index").toString();
+                            QString bitDescription = xml.readElementText();
+                            qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
+                                                             << "index:" << bitIndex << "description:" << bitDescription;
+                            metaData->bitmask.append({ bitIndex, bitDescription });
                         } else {
                             qCDebug(PX4ParameterMetaDataLog) << "Unknown element in XML: " << elementName;
                         }
@@ -376,15 +333,6 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             QString elementName = xml.name().toString();
 
             if (elementName == "parameter") {
-                // Done loading this parameter, validate default value
-                if (metaData->defaultValueAvailable()) {
-                    QVariant var;
-
-                    if (!metaData->convertAndValidateRaw(metaData->rawDefaultValue(), false /* convertOnly */, var, errorString)) {
-                        qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << metaData->rawDefaultValue() << " error:" << errorString;
-                    }
-                }
-
                 // Reset for next parameter
                 metaData = nullptr;
                 badMetaData = false;
@@ -397,10 +345,127 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
         }
         xml.readNext();
     }
+}
 
-#ifdef GENERATE_PARAMETER_JSON
-    _generateParameterJson();
-#endif
+FactMetaData* PX4ParameterMetaData::_createMetaData(const ParameterMetaDataTable::Parameter& parameter)
+{
+    FactMetaData*   metaData = new FactMetaData(static_cast<FactMetaData::ValueType_t>(parameter.type), this);
+    QString         errorString;
+
+    metaData->setName(parameter.name);
+    if (!parameter.category.isEmpty()) {
+        metaData->setCategory(parameter.category);
+    }
+    if (!parameter.group.isEmpty()) {
+        metaData->setGroup(parameter.group);
+    }
+    metaData->setReadOnly(parameter.readOnly);
+    metaData->setVolatileValue(parameter.volatileValue);
+
+    if (!parameter.defaultValue.isEmpty()) {
+        QVariant varDefault;
+
+        if (metaData->convertAndValidateRaw(parameter.defaultValue, false, varDefault, errorString)) {
+            metaData->setRawDefaultValue(varDefault);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << parameter.name << " type:" << metaData->type() << " default:" << parameter.defaultValue << " error:" << errorString;
+        }
+    }
+
+    if (!parameter.shortDescription.isEmpty()) {
+        metaData->setShortDescription(parameter.shortDescription);
+    }
+    if (!parameter.longDescription.isEmpty()) {
+        metaData->setLongDescription(parameter.longDescription);
+    }
+
+    if (!parameter.min.isEmpty()) {
+        QVariant varMin;
+        if (metaData->convertAndValidateRaw(parameter.min, false /* convertOnly */, varMin, errorString)) {
+            metaData->setRawMin(varMin);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << parameter.min << " error:" << errorString;
+        }
+    }
+
+    if (!parameter.max.isEmpty()) {
+        QVariant varMax;
+        if (metaData->convertAndValidateRaw(parameter.max, false /* convertOnly */, varMax, errorString)) {
+            metaData->setRawMax(varMax);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << parameter.max << " error:" << errorString;
+        }
+    }
+
+    if (!parameter.units.isEmpty()) {
+        metaData->setRawUnits(parameter.units);
+    }
+
+    if (!parameter.decimalPlaces.isEmpty()) {
+        bool convertOk;
+        QVariant varDecimals = QVariant(parameter.decimalPlaces).toUInt(&convertOk);
+        if (convertOk) {
+            metaData->setDecimalPlaces(varDecimals.toInt());
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << parameter.decimalPlaces << " error: invalid number";
+        }
+    }
+
+    if (parameter.rebootRequired) {
+        metaData->setVehicleRebootRequired(true);
+    }
+
+    for (const auto& value: parameter.values) {
+        QVariant enumValue;
+        if (metaData->convertAndValidateRaw(value.first, false /* validate */, enumValue, errorString)) {
+            metaData->addEnumInfo(value.second, enumValue);
+        } else {
+            qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
+                                             << " type:" << metaData->type() << " value:" << value.first
+                                             << " error:" << errorString;
+        }
+    }
+
+    if (!parameter.increment.isEmpty()) {
+        bool    ok;
+        double  increment = parameter.increment.toDouble(&ok);
+        if (ok) {
+            metaData->setRawIncrement(increment);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << parameter.increment;
+        }
+    }
+
+    if (parameter.boolean) {
+        QVariant enumValue;
+        metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
+        metaData->addEnumInfo(tr("Enabled"), enumValue);
+        metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
+        metaData->addEnumInfo(tr("Disabled"), enumValue);
+    }
+
+    for (const auto& bit: parameter.bitmask) {
+        bool ok = false;
+        const uint bitIndex = bit.first.toUInt(&ok);
+        if (!ok) {
+            continue;
+        }
+        if (bitIndex < 31) {
+            QVariant bitmaskRawValue = 1 << bitIndex;
+            QVariant bitmaskValue;
+            if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
+                metaData->addBitmaskInfo(bit.second, bitmaskValue);
+            } else {
+                qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
+                                                 << " type:" << metaData->type() << " value:" << bitmaskValue
+                                                 << " error:" << errorString;
+            }
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bitIndex;
+        }
+    }
+
+    return metaData;
 }
 
 #ifdef GENERATE_PARAMETER_JSON
@@ -427,6 +492,11 @@ void PX4ParameterMetaData::_generateParameterJson()
     _jsonWriteLine(jsonFile, indentLevel, "\"scope\": \"Firmware\",");
     _jsonWriteLine(jsonFile, indentLevel++, "\"parameters\": [");
 
+    // Meta data is normally created on first use, the json needs all of it
+    for (const QString& paramName: _parameterTable.names(QString())) {
+        (void) getMetaDataForFact(paramName, MAV_TYPE_GENERIC, FactMetaData::valueTypeFloat);
+    }
+
     int keyIndex = 0;
     for (const QString& paramName: _mapParameterName2FactMetaData.keys()) {
         const FactMetaData* metaData = _mapParameterName2FactMetaData[paramName];
@@ -492,9 +562,17 @@ FactMetaData* PX4ParameterMetaData::getMetaDataForFact(const QString& name, MAV_
     Q_UNUSED(vehicleType)
 
     if (!_mapParameterName2FactMetaData.contains(name)) {
-        qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
-        FactMetaData* metaData = new FactMetaData(type, this);
-        _mapParameterName2FactMetaData[name] = metaData;
+        ParameterMetaDataTable::Parameter parameter;
+        if (_parameterTable.find(QString(), name, parameter)) {
+            if (parameter.type < 0) {
+                parameter.type = type;
+            }
+            _mapParameterName2FactMetaData[name] = _createMetaData(parameter);
+        } else {
+            qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
+            FactMetaData* metaData = new FactMetaData(type, this);
+            _mapParameterName2FactMetaData[name] = metaData;
+        }
     }
 
     return _mapParameterName2FactMetaData[name];
@@ -12,6 +12,7 @@
 
 #include "MAVLinkLib.h"
 #include "FactMetaData.h"
+#include "ParameterMetaDataTable.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QLoggingCategory>
@@ -46,6 +47,9 @@ private:
         XmlStateDone
     };
 
+    void            _parseParameterFactMetaDataFile (const QString& metaDataFile, QList<ParameterMetaDataTable::Parameter>& parameters);
+    FactMetaData*   _createMetaData                 (const ParameterMetaDataTable::Parameter& parameter);
+
     QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
     static void _outputFileWarning(const QString& metaDataFile, const QString& error1, const QString& error2);
 
@@ -54,7 +58,10 @@ private:
 #endif
 
     bool                                _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
-    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData
+    FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData, filled in as parameters are looked up
+    ParameterMetaDataTable              _parameterTable;                            ///< Compiled meta data file
+
+    static constexpr quint32 kParserVersion = 1;    ///< Bump when parsing changes so cached tables are rebuilt
 
     static constexpr const char* kInvalidConverstion = "Internal Error: No support for string parameters";
 
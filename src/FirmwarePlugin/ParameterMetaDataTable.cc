@@ -0,0 +1,362 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterMetaDataTable.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include <algorithm>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(ParameterMetaDataTableLog, "ParameterMetaDataTableLog")
+
+ParameterMetaDataTable::~ParameterMetaDataTable()
+{
+    _close();
+}
+
+QString ParameterMetaDataTable::cacheFileName(const QString& sourceFile)
+{
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/QGCParameterMetaDataCache");
+    const QByteArray sourceHash = QCryptographicHash::hash(QFileInfo(sourceFile).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return cacheDir + QLatin1Char('/') + QString::fromLatin1(sourceHash) + QStringLiteral(".qgcpmd");
+}
+
+bool ParameterMetaDataTable::_sourceInfo(const QString& sourceFile, qint64& size, qint64& modifiedMSecs)
+{
+    const QFileInfo sourceInfo(sourceFile);
+    if (!sourceInfo.exists()) {
+        return false;
+    }
+    size = sourceInfo.size();
+    modifiedMSecs = sourceInfo.lastModified().toMSecsSinceEpoch();
+    return true;
+}
+
+bool ParameterMetaDataTable::load(const QString& sourceFile, quint32 parserVersion)
+{
+    _close();
+
+    qint64 sourceSize, sourceModifiedMSecs;
+    if (!_sourceInfo(sourceFile, sourceSize, sourceModifiedMSecs)) {
+        return false;
+    }
+
+    _file.setFileName(cacheFileName(sourceFile));
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = _file.size();
+    const uchar* const data = (size >= static_cast<qint64>(sizeof(Header))) ? _file.map(0, size) : nullptr;
+    if (!data) {
+        _file.close();
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, data, sizeof(header));
+    if ((header.parserVersion != parserVersion) || (header.sourceSize != sourceSize) || (header.sourceModifiedMSecs != sourceModifiedMSecs) || !_attach(data, size, header)) {
+        qCDebug(ParameterMetaDataTableLog) << "Ignoring stale or invalid cache" << _file.fileName() << "for" << sourceFile;
+        _close();
+        return false;
+    }
+
+    qCDebug(ParameterMetaDataTableLog) << "Mapped" << _parameterCount << "parameters from" << _file.fileName() << "for" << sourceFile;
+    return true;
+}
+
+bool ParameterMetaDataTable::_attach(const uchar* data, qint64 size, const Header& header)
+{
+    if ((header.magic != _magic) || (header.formatVersion != _formatVersion)) {
+        return false;
+    }
+
+    auto inRange = [size](quint64 offset, quint64 count, quint64 itemSize) {
+        return (offset + (count * itemSize)) <= static_cast<quint64>(size);
+    };
+    if (!inRange(header.indexOffset, header.parameterCount, sizeof(IndexEntry)) ||
+            !inRange(header.recordsOffset, header.parameterCount, sizeof(Record)) ||
+            !inRange(header.pairsOffset, header.pairCount, sizeof(PairRef)) ||
+            !inRange(header.stringsOffset, header.stringsSize, 1)) {
+        return false;
+    }
+
+    _data           = data;
+    _size           = size;
+    _parameterCount = header.parameterCount;
+    _indexOffset    = header.indexOffset;
+    _recordsOffset  = header.recordsOffset;
+    _pairsOffset    = header.pairsOffset;
+    _pairCount      = header.pairCount;
+    _stringsOffset  = header.stringsOffset;
+    _stringsSize    = header.stringsSize;
+
+    return true;
+}
+
+void ParameterMetaDataTable::_close()
+{
+    if (_file.isOpen()) {
+        if (_data) {
+            (void) _file.unmap(const_cast<uchar*>(_data));
+        }
+        _file.close();
+    }
+    _buffer.clear();
+    _data = nullptr;
+    _size = 0;
+    _parameterCount = 0;
+}
+
+void ParameterMetaDataTable::build(const QString& sourceFile, quint32 parserVersion, const QList<Parameter>& parameters)
+{
+    _close();
+
+    QElapsedTimer buildTimer;
+    buildTimer.start();
+
+    // Sort by the same utf8 byte order the lookups use
+    QList<QPair<QPair<QByteArray, QByteArray>, const Parameter*>> sorted;
+    sorted.reserve(parameters.count());
+    for (const Parameter& parameter: parameters) {
+        sorted.append({ { parameter.section.toUtf8(), parameter.name.toUtf8() }, &parameter });
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto& left, const auto& right) {
+        return left.first < right.first;
+    });
+
+    QByteArray          strings;
+    QHash<QString, StringRef> stringPool;
+    auto intern = [&strings, &stringPool](const QString& string) -> StringRef {
+        if (string.isEmpty()) {
+            return { 0, 0 };
+        }
+        const auto it = stringPool.constFind(string);
+        if (it != stringPool.constEnd()) {
+            return it.value();
+        }
+        const QByteArray utf8 = string.toUtf8();
+        const StringRef ref = { static_cast<quint32>(strings.size()), static_cast<quint32>(utf8.size()) };
+        strings.append(utf8);
+        stringPool.insert(string, ref);
+        return ref;
+    };
+
+    QList<IndexEntry>   index;
+    QList<Record>       records;
+    QList<PairRef>      pairs;
+    index.reserve(sorted.count());
+    records.reserve(sorted.count());
+
+    for (const auto& entry: sorted) {
+        const Parameter& parameter = *entry.second;
+
+        index.append({ intern(parameter.section), intern(parameter.name) });
+
+        Record record;
+        record.category         = intern(parameter.category);
+        record.group            = intern(parameter.group);
+        record.shortDescription = intern(parameter.shortDescription);
+        record.longDescription  = intern(parameter.longDescription);
+        record.min              = intern(parameter.min);
+        record.max              = intern(parameter.max);
+        record.defaultValue     = intern(parameter.defaultValue);
+        record.increment        = intern(parameter.increment);
+        record.units            = intern(parameter.units);
+        record.decimalPlaces    = intern(parameter.decimalPlaces);
+        record.type             = parameter.type;
+        record.flags            = (parameter.rebootRequired ? FlagRebootRequired : 0) |
+                                  (parameter.readOnly ? FlagReadOnly : 0) |
+                                  (parameter.volatileValue ? FlagVolatile : 0) |
+                                  (parameter.boolean ? FlagBoolean : 0);
+        record.firstValue       = static_cast<quint32>(pairs.count());
+        record.valueCount       = static_cast<quint32>(parameter.values.count());
+        for (const auto& value: parameter.values) {
+            pairs.append({ intern(value.first), intern(value.second) });
+        }
+        record.firstBit         = static_cast<quint32>(pairs.count());
+        record.bitCount         = static_cast<quint32>(parameter.bitmask.count());
+        for (const auto& bit: parameter.bitmask) {
+            pairs.append({ intern(bit.first), intern(bit.second) });
+        }
+        records.append(record);
+    }
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    header.magic            = _magic;
+    header.formatVersion    = _formatVersion;
+    header.parserVersion    = parserVersion;
+    header.parameterCount   = static_cast<quint32>(records.count());
+    (void) _sourceInfo(sourceFile, header.sourceSize, header.sourceModifiedMSecs);
+    header.indexOffset      = sizeof(Header);
+    header.recordsOffset    = header.indexOffset + static_cast<quint32>(index.count() * sizeof(IndexEntry));
+    header.pairsOffset      = header.recordsOffset + static_cast<quint32>(records.count() * sizeof(Record));
+    header.pairCount        = static_cast<quint32>(pairs.count());
+    header.stringsOffset    = header.pairsOffset + static_cast<quint32>(pairs.count() * sizeof(PairRef));
+    header.stringsSize      = static_cast<quint32>(strings.size());
+
+    QByteArray table;
+    table.reserve(header.stringsOffset + header.stringsSize);
+    table.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    table.append(reinterpret_cast<const char*>(index.constData()), index.count() * sizeof(IndexEntry));
+    table.append(reinterpret_cast<const char*>(records.constData()), records.count() * sizeof(Record));
+    table.append(reinterpret_cast<const char*>(pairs.constData()), pairs.count() * sizeof(PairRef));
+    table.append(strings);
+
+    _buffer = table;
+    (void) _attach(reinterpret_cast<const uchar*>(_buffer.constData()), _buffer.size(), header);
+
+    qCDebug(ParameterMetaDataTableLog) << "Compiled" << _parameterCount << "parameters" << _buffer.size() << "bytes in" << buildTimer.elapsed() << "msecs for" << sourceFile;
+
+    const QString cacheFile = cacheFileName(sourceFile);
+    if (!QDir().mkpath(QFileInfo(cacheFile).absolutePath())) {
+        qCDebug(ParameterMetaDataTableLog) << "Unable to create cache directory for" << cacheFile;
+        return;
+    }
+    QSaveFile saveFile(cacheFile);
+    if (!saveFile.open(QIODevice::WriteOnly) || (saveFile.write(_buffer) != _buffer.size()) || !saveFile.commit()) {
+        // Not fatal, the file is parsed again next time
+        qCDebug(ParameterMetaDataTableLog) << "Unable to write cache" << cacheFile << saveFile.errorString();
+    }
+}
+
+template<typename T>
+T ParameterMetaDataTable::_read(quint32 offset) const
+{
+    // Mapped data has no alignment guarantees for the structures, copy them out
+    T value;
+    memcpy(&value, _data + offset, sizeof(T));
+    return value;
+}
+
+ParameterMetaDataTable::IndexEntry ParameterMetaDataTable::_indexEntry(int index) const
+{
+    return _read<IndexEntry>(_indexOffset + (static_cast<quint32>(index) * sizeof(IndexEntry)));
+}
+
+int ParameterMetaDataTable::_compare(const StringRef& ref, const QByteArray& key) const
+{
+    const quint32 length = (ref.offset + ref.length <= _stringsSize) ? ref.length : 0;
+    const int result = memcmp(_data + _stringsOffset + ref.offset, key.constData(), qMin<size_t>(length, static_cast<size_t>(key.size())));
+    if (result != 0) {
+        return result;
+    }
+    return (length < static_cast<quint32>(key.size())) ? -1 : ((length > static_cast<quint32>(key.size())) ? 1 : 0);
+}
+
+QString ParameterMetaDataTable::_string(const StringRef& ref) const
+{
+    if ((ref.length == 0) || (ref.offset + ref.length > _stringsSize)) {
+        return QString();
+    }
+    return QString::fromUtf8(reinterpret_cast<const char*>(_data + _stringsOffset + ref.offset), ref.length);
+}
+
+int ParameterMetaDataTable::_lowerBound(const QByteArray& section, const QByteArray& name) const
+{
+    int first = 0;
+    int count = static_cast<int>(_parameterCount);
+    while (count > 0) {
+        const int step = count / 2;
+        const int middle = first + step;
+        const IndexEntry entry = _indexEntry(middle);
+        int result = _compare(entry.section, section);
+        if (result == 0) {
+            result = _compare(entry.name, name);
+        }
+        if (result < 0) {
+            first = middle + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+bool ParameterMetaDataTable::find(const QString& section, const QString& name, Parameter& parameter) const
+{
+    if (!_data) {
+        return false;
+    }
+
+    const QByteArray section8 = section.toUtf8();
+    const QByteArray name8 = name.toUtf8();
+    const int index = _lowerBound(section8, name8);
+    if (index >= static_cast<int>(_parameterCount)) {
+        return false;
+    }
+    const IndexEntry entry = _indexEntry(index);
+    if ((_compare(entry.section, section8) != 0) || (_compare(entry.name, name8) != 0)) {
+        return false;
+    }
+
+    const Record record = _read<Record>(_recordsOffset + (static_cast<quint32>(index) * sizeof(Record)));
+    parameter = Parameter();
+    parameter.section           = section;
+    parameter.name              = name;
+    parameter.category          = _string(record.category);
+    parameter.group             = _string(record.group);
+    parameter.shortDescription  = _string(record.shortDescription);
+    parameter.longDescription   = _string(record.longDescription);
+    parameter.min               = _string(record.min);
+    parameter.max               = _string(record.max);
+    parameter.defaultValue      = _string(record.defaultValue);
+    parameter.increment         = _string(record.increment);
+    parameter.units             = _string(record.units);
+    parameter.decimalPlaces     = _string(record.decimalPlaces);
+    parameter.type              = record.type;
+    parameter.rebootRequired    = record.flags & FlagRebootRequired;
+    parameter.readOnly          = record.flags & FlagReadOnly;
+    parameter.volatileValue     = record.flags & FlagVolatile;
+    parameter.boolean           = record.flags & FlagBoolean;
+
+    auto readPairs = [this](quint32 first, quint32 count, QList<QPair<QString, QString>>& list) {
+        if ((first + count) > _pairCount) {
+            return;
+        }
+        list.reserve(count);
+        for (quint32 i = first; i < first + count; i++) {
+            const PairRef pair = _read<PairRef>(_pairsOffset + (i * sizeof(PairRef)));
+            list.append({ _string(pair.first), _string(pair.second) });
+        }
+    };
+    readPairs(record.firstValue, record.valueCount, parameter.values);
+    readPairs(record.firstBit, record.bitCount, parameter.bitmask);
+
+    return true;
+}
+
+QStringList ParameterMetaDataTable::names(const QString& section) const
+{
+    QStringList names;
+    if (!_data) {
+        return names;
+    }
+
+    const QByteArray section8 = section.toUtf8();
+    for (int index = _lowerBound(section8, QByteArray()); index < static_cast<int>(_parameterCount); index++) {
+        const IndexEntry entry = _indexEntry(index);
+        if (_compare(entry.section, section8) != 0) {
+            break;
+        }
+        names.append(_string(entry.name));
+    }
+    return names;
+}
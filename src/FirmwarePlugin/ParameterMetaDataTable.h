@@ -0,0 +1,161 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+Q_DECLARE_LOGGING_CATEGORY(ParameterMetaDataTableLog)
+
+/// Compiled form of a firmware parameter meta data file. The first time a meta data file is used it is parsed by the
+/// firmware plugin, compiled into a binary table and cached. After that the cached table is memory mapped instead of
+/// parsing the file again. The table holds the parameters sorted by section and name, a string pool shared by all
+/// parameters and the enum and bitmask arrays. A parameter is only decoded when it is looked up.
+class ParameterMetaDataTable
+{
+public:
+    /// Raw meta data for a single parameter as found in the meta data file. Values are kept as strings, the firmware
+    /// plugin converts them once it knows the type of the parameter.
+    struct Parameter {
+        QString section;            ///< Firmware specific grouping, for example the ArduPilot vehicle the parameter belongs to
+        QString name;
+        QString category;
+        QString group;
+        QString shortDescription;
+        QString longDescription;
+        QString min;
+        QString max;
+        QString defaultValue;
+        QString increment;
+        QString units;
+        QString decimalPlaces;
+        int     type            = -1;       ///< FactMetaData::ValueType_t, -1 if the meta data file doesn't specify it
+        bool    rebootRequired  = false;
+        bool    readOnly        = false;
+        bool    volatileValue   = false;
+        bool    boolean         = false;    ///< Parameter is an enabled/disabled switch
+        QList<QPair<QString, QString>> values;     ///< Enum value, description
+        QList<QPair<QString, QString>> bitmask;    ///< Bit index, description
+    };
+
+    ParameterMetaDataTable() = default;
+    ~ParameterMetaDataTable();
+
+    /// Maps the cached table for @a sourceFile
+    ///     @param parserVersion Version of the parser which produced the parameters, a cache from another version is stale
+    /// @return false: No cache or the cache is stale, the caller must parse @a sourceFile and call build
+    bool load(const QString& sourceFile, quint32 parserVersion);
+
+    /// Compiles @a parameters into the table and caches it for @a sourceFile. The table is usable even if the cache
+    /// can't be written. Section and name pairs must be unique.
+    void build(const QString& sourceFile, quint32 parserVersion, const QList<Parameter>& parameters);
+
+    bool isValid() const { return _data != nullptr; }
+    int  count  () const { return static_cast<int>(_parameterCount); }
+
+    /// Decodes the meta data for @a name in @a section
+    /// @return false: Parameter not found
+    bool find(const QString& section, const QString& name, Parameter& parameter) const;
+
+    /// @return Names of all parameters in @a section, sorted
+    QStringList names(const QString& section) const;
+
+    /// @return File the table for @a sourceFile is cached in
+    static QString cacheFileName(const QString& sourceFile);
+
+private:
+    struct StringRef {
+        quint32 offset;
+        quint32 length;
+    };
+
+    struct IndexEntry {
+        StringRef section;
+        StringRef name;
+    };
+
+    struct Record {
+        StringRef category;
+        StringRef group;
+        StringRef shortDescription;
+        StringRef longDescription;
+        StringRef min;
+        StringRef max;
+        StringRef defaultValue;
+        StringRef increment;
+        StringRef units;
+        StringRef decimalPlaces;
+        qint32    type;
+        quint32   flags;
+        quint32   firstValue;
+        quint32   valueCount;
+        quint32   firstBit;
+        quint32   bitCount;
+    };
+
+    struct PairRef {
+        StringRef first;
+        StringRef second;
+    };
+
+    struct Header {
+        quint32 magic;
+        quint32 formatVersion;
+        quint32 parserVersion;
+        quint32 parameterCount;
+        qint64  sourceSize;
+        qint64  sourceModifiedMSecs;
+        quint32 indexOffset;
+        quint32 recordsOffset;
+        quint32 pairsOffset;
+        quint32 pairCount;
+        quint32 stringsOffset;
+        quint32 stringsSize;
+    };
+
+    enum RecordFlags {
+        FlagRebootRequired  = 1 << 0,
+        FlagReadOnly        = 1 << 1,
+        FlagVolatile        = 1 << 2,
+        FlagBoolean         = 1 << 3,
+    };
+
+    bool        _attach         (const uchar* data, qint64 size, const Header& header);
+    void        _close          ();
+    int         _lowerBound     (const QByteArray& section, const QByteArray& name) const;
+    int         _compare        (const StringRef& ref, const QByteArray& key) const;
+    QString     _string         (const StringRef& ref) const;
+    IndexEntry  _indexEntry     (int index) const;
+
+    template<typename T>
+    T _read(quint32 offset) const;
+
+    static bool _sourceInfo(const QString& sourceFile, qint64& size, qint64& modifiedMSecs);
+
+    QFile           _file;                  ///< Cache file while it is mapped
+    QByteArray      _buffer;                ///< Table built in this session
+    const uchar*    _data = nullptr;
+    qint64          _size = 0;
+    quint32         _parameterCount = 0;
+    quint32         _indexOffset = 0;
+    quint32         _recordsOffset = 0;
+    quint32         _pairsOffset = 0;
+    quint32         _pairCount = 0;
+    quint32         _stringsOffset = 0;
+    quint32         _stringsSize = 0;
+
+    static constexpr quint32 _magic = 0x514d4450;   // "QMDP"
+    static constexpr quint32 _formatVersion = 1;
+};
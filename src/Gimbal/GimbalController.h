@@ -32,6 +32,9 @@ public:
     Gimbal(const Gimbal& other);
     const Gimbal& operator=(const Gimbal& other);
 
+    // Overrides from FactGroup
+    QList<uint32_t> handledMessageIds() const override { return {}; }  ///< Filled in by GimbalController
+
     Q_PROPERTY(Fact* absoluteRoll               READ absoluteRoll               CONSTANT)
     Q_PROPERTY(Fact* absolutePitch              READ absolutePitch              CONSTANT)
     Q_PROPERTY(Fact* bodyYaw                    READ bodyYaw                    CONSTANT)
@@ -132,4 +132,14 @@ void createSetupSigning(mavlink_channel_t channel, mavlink_system_t target_syste
     }
 }
 
+/// Moves the signing timestamp of a channel up to one seen on an incoming packet, it never goes back.
+/// Must be called on the thread which signs the channel's outgoing packets.
+void advanceSigningTimestamp(mavlink_channel_t channel, uint64_t timestamp)
+{
+    mavlink_signing_t* const signing = _getChannelSigning(channel);
+    if (signing && (timestamp > signing->timestamp)) {
+        signing->timestamp = timestamp;
+    }
+}
+
 } // namespace MAVLinkSigning
@@ -1112,6 +1112,24 @@ Item {
                         _planMasterController.saveKmlToSelectedFile()
                     }
                 }
+
+                QGCButton {
+                    Layout.columnSpan:  3
+                    Layout.fillWidth:   true
+                    text:               qsTr("Download Mission Terrain For Offline Use")
+                    enabled:            _visualItems.count > 1
+                    onClicked: {
+                        dropPanel.hide()
+                        var missionArea = _missionController.travelBoundingCube.polygon2D()
+                        var setName = qsTr("Mission Terrain %1").arg(Qt.formatDateTime(new Date(), "yyyy-MM-dd hh:mm:ss"))
+                        var tileCount = QGroundControl.mapEngineManager.startElevationDownload(setName, missionArea)
+                        if (tileCount > 0) {
+                            mainWindow.showMessageDialog(qsTr("Terrain"), qsTr("Downloading %1 terrain tiles. Progress is shown in the Offline Maps settings.").arg(tileCount))
+                        } else {
+                            mainWindow.showMessageDialog(qsTr("Terrain"), qsTr("The mission has no area to download terrain for."))
+                        }
+                    }
+                }
             }
 
             SectionHeader {
@@ -138,9 +138,10 @@ static QObject* shapeFileHelperSingletonFactory(QQmlEngine*, QJSEngine*)
     return new ShapeFileHelper;
 }
 
-QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
+QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting, bool headless)
     : QApplication(argc, argv)
     , _runningUnitTests(unitTesting)
+    , _headless(headless)
 {
     _msecsElapsedTime.start();
 
@@ -398,7 +399,7 @@ void QGCApplication::init()
         qWarning() << "Could not load /fonts/opensans-demibold font";
     }
 
-    if (!_runningUnitTests) {
+    if (!_runningUnitTests && !_headless) {
         _initForNormalAppBoot();
     } else {
         AudioOutput::instance()->setMuted(true);
@@ -628,6 +629,9 @@ void QGCApplication::showAppMessage(const QString& message, const QString& title
     } else if (runningUnitTests()) {
         // Unit tests can run without UI
         qCDebug(QGCApplicationLog) << "QGCApplication::showAppMessage unittest title:message" << dialogTitle << message;
+    } else if (_headless) {
+        // No UI is ever coming, so the console is all we have
+        qCWarning(QGCApplicationLog) << dialogTitle << message;
     } else {
         // UI isn't ready yet
         _delayedAppMessages.append(QPair<QString, QString>(dialogTitle, message));
@@ -60,7 +60,7 @@ class QGCApplication : public QApplication
 {
     Q_OBJECT
 public:
-    QGCApplication(int &argc, char* argv[], bool unitTesting);
+    QGCApplication(int &argc, char* argv[], bool unitTesting, bool headless = false);
     ~QGCApplication();
 
     /// @brief Sets the persistent flag to delete all settings the next time QGroundControl is started.
@@ -72,6 +72,9 @@ public:
     /// @brief Returns true if unit tests are being run
     bool runningUnitTests(void) const{ return _runningUnitTests; }
 
+    /// @brief Returns true if running without any user interface, for example batch log replay
+    bool headless(void) const{ return _headless; }
+
     /// @brief Returns true if Qt debug output should be logged to a file
     bool logOutput(void) const{ return _logOutput; }
 
@@ -170,6 +173,7 @@ private:
     bool compressEvent(QEvent *event, QObject *receiver, QPostEventList *postedEvents) override;
 
     bool                        _runningUnitTests;                                  ///< true: running unit tests, false: normal app
+    bool                        _headless;                                          ///< true: no QML user interface is created
     static const int            _missingParamsDelayedDisplayTimerTimeout = 1000;    ///< Timeout to wait for next missing fact to come in before display
     QTimer                      _missingParamsDelayedDisplayTimer;                  ///< Timer use to delay missing fact display
     QList<QPair<int,QString>>   _missingParams;                                     ///< List of missing parameter component id:name
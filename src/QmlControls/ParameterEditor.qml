@@ -32,6 +32,7 @@ Item {
     property bool   _showRCToParam:     _activeVehicle.px4Firmware
     property var    _appSettings:       QGroundControl.settingsManager.appSettings
     property var    _controller:        controller
+    property var    _parameterManager:  _activeVehicle.parameterManager
 
     ParameterEditorController {
         id: controller
@@ -86,6 +87,15 @@ Item {
             onClicked:              controller.showModifiedOnly = checked
             visible:                QGroundControl.multiVehicleManager.activeVehicle.px4Firmware
         }
+
+        QGCLabel {
+            anchors.verticalCenter: parent.verticalCenter
+            text:                   qsTr("Writing %1 of %2 parameters, %3/s, %4s remaining").arg(_parameterManager.bulkWriteWrittenCount)
+                                                                                             .arg(_parameterManager.bulkWriteTotalCount)
+                                                                                             .arg(_parameterManager.bulkWriteParamsPerSecond.toFixed(1))
+                                                                                             .arg(_parameterManager.bulkWriteEtaSecs)
+            visible:                _parameterManager.bulkWriteInProgress
+        }
     } // Row - Header
 
     QGCButton {
@@ -234,6 +234,8 @@ void ParameterEditorController::clearDiff(void)
 
 void ParameterEditorController::sendDiff(void)
 {
+    // Parameters the vehicle already has are written as a single transaction
+    QList<QPair<Fact*, QVariant>> writes;
     for (int i=0; i<_diffList.count(); i++) {
         ParameterEditorDiff* paramDiff = _diffList.value<ParameterEditorDiff*>(i);
 
@@ -241,11 +243,14 @@ void ParameterEditorController::sendDiff(void)
             if (paramDiff->noVehicleValue) {
                 _parameterMgr->_factRawValueUpdateWorker(paramDiff->componentId, paramDiff->name, paramDiff->valueType, paramDiff->fileValueVar);
             } else {
-                Fact* fact = _parameterMgr->getParameter(paramDiff->componentId, paramDiff->name);
-                fact->setRawValue(paramDiff->fileValueVar);
+                writes.append({ _parameterMgr->getParameter(paramDiff->componentId, paramDiff->name), paramDiff->fileValueVar });
             }
         }
     }
+
+    if (!writes.isEmpty() && !_parameterMgr->writeParameters(writes)) {
+        qgcApp()->showAppMessage(tr("Parameters not loaded, a previous parameter load is still being written to the vehicle."));
+    }
 }
 
 bool ParameterEditorController::buildDiffFromFile(const QString& filename)
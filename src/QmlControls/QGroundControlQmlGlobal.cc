@@ -16,6 +16,7 @@
 #include "AppSettings.h"
 #include "PositionManager.h"
 #include "QGCMapEngineManager.h"
+#include "TerrainTileManager.h"
 #include "ADSBVehicleManager.h"
 #ifndef NO_SERIAL_LINK
 #include "GPSManager.h"
@@ -34,6 +35,7 @@ double           QGroundControlQmlGlobal::_zoom = 2;
 QGroundControlQmlGlobal::QGroundControlQmlGlobal(QGCApplication* app, QGCToolbox* toolbox)
     : QGCTool(app, toolbox)
     , _mapEngineManager(QGCMapEngineManager::instance())
+    , _terrainTileManager(TerrainTileManager::instance())
     , _adsbVehicleManager(ADSBVehicleManager::instance())
 {
     // We clear the parent on this object since we run into shutdown problems caused by hybrid qml app. Instead we let it leak on shutdown.
@@ -15,6 +15,9 @@
 #include "ElevationMapProvider.h"
 #include "TerrainTileCopernicus.h"
 
+#include <QtGui/QPolygonF>
+#include <QtPositioning/QGeoCoordinate>
+
 int CopernicusElevationProvider::long2tileX(double lon, int z) const
 {
     Q_UNUSED(z)
@@ -57,6 +60,41 @@ QGCTileSet CopernicusElevationProvider::getTileCount(int zoom, double topleftLon
     return set;
 }
 
+QList<QPoint> CopernicusElevationProvider::getTilesForPolygon(const QList<QGeoCoordinate> &polygon) const
+{
+    QList<QPoint> tiles;
+    if (polygon.count() < 3) {
+        return tiles;
+    }
+
+    // Tiles are small enough to treat lon/lat as planar coordinates
+    QPolygonF area;
+    for (const QGeoCoordinate &coordinate : polygon) {
+        area << QPointF(coordinate.longitude(), coordinate.latitude());
+    }
+    const QRectF bounds = area.boundingRect();
+
+    const int tileX0 = long2tileX(bounds.left(), 1);
+    const int tileX1 = long2tileX(bounds.right(), 1);
+    const int tileY0 = lat2tileY(bounds.top(), 1);
+    const int tileY1 = lat2tileY(bounds.bottom(), 1);
+    for (int x = tileX0; x <= tileX1; x++) {
+        for (int y = tileY0; y <= tileY1; y++) {
+            const QRectF tileRect(
+                (static_cast<double>(x) * TerrainTileCopernicus::tileSizeDegrees) - 180.0,
+                (static_cast<double>(y) * TerrainTileCopernicus::tileSizeDegrees) - 90.0,
+                TerrainTileCopernicus::tileSizeDegrees,
+                TerrainTileCopernicus::tileSizeDegrees
+            );
+            if (area.intersects(QPolygonF(tileRect))) {
+                tiles.append(QPoint(x, y));
+            }
+        }
+    }
+
+    return tiles;
+}
+
 QByteArray CopernicusElevationProvider::serialize(const QByteArray &image) const
 {
     return TerrainTileCopernicus::serializeFromJson(image);
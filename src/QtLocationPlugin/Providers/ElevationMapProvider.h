@@ -11,6 +11,11 @@
 
 #include "MapProvider.h"
 
+#include <QtCore/QList>
+#include <QtCore/QPoint>
+
+class QGeoCoordinate;
+
 static constexpr const quint32 AVERAGE_COPERNICUS_ELEV_SIZE = 2786;
 
 class ElevationProvider : public MapProvider
@@ -48,6 +53,10 @@ public:
                             double topleftLat, double bottomRightLon,
                             double bottomRightLat) const final;
 
+    /// Returns the x/y of every tile which intersects the polygon, unlike getTileCount tiles which only fall
+    /// within the bounding box of the polygon are left out
+    QList<QPoint> getTilesForPolygon(const QList<QGeoCoordinate> &polygon) const;
+
     QByteArray serialize(const QByteArray &image) const final;
 
     static constexpr const char *kProviderKey = "Copernicus Elevation";
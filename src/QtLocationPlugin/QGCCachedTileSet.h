@@ -21,7 +21,9 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QList>
 #include <QtCore/QObject>
+#include <QtCore/QPoint>
 #include <QtCore/QQueue>
 #include <QtCore/QString>
 #include <QtNetwork/QNetworkReply>
@@ -128,6 +130,10 @@ public:
     void setTotalTileSize(quint64 size) { if (size != _totalTileSize) { _totalTileSize = size; emit totalTilesSizeChanged(); } }
     void setSavedTileSize(quint64 size) { if (size != _savedTileSize) { _savedTileSize = size; emit savedTileSizeChanged(); }  }
 
+    /// Tiles at minZoom which make up the set when it doesn't cover its whole bounding box, only used while creating the set
+    const QList<QPoint> &tiles() const { return _tiles; }
+    void setTiles(const QList<QPoint> &tiles) { _tiles = tiles; }
+
     void setMinZoom(int zoom) { _minZoom = zoom; }
     void setMaxZoom(int zoom) { _maxZoom = zoom; }
     void setCreationDate(const QDateTime &date) { _creationDate = date; }
@@ -185,6 +191,7 @@ private:
     bool _batchRequested = false;
     bool _selected = false;
     QDateTime _creationDate;
+    QList<QPoint> _tiles;
 
     QHash<QString, QNetworkReply*> _replies;
     QQueue<QGCTile*> _tilesToDownload;
@@ -479,40 +479,55 @@ QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
             task->tileSet()->setId(setID);
             //-- Prepare Download List
             _db->transaction();
-            for(int z = task->tileSet()->minZoom(); z <= task->tileSet()->maxZoom(); z++) {
-                QGCTileSet set = UrlFactory::getTileCount(z,
-                    task->tileSet()->topleftLon(), task->tileSet()->topleftLat(),
-                    task->tileSet()->bottomRightLon(), task->tileSet()->bottomRightLat(), task->tileSet()->type());
-                QString type = task->tileSet()->type();
-                for(int x = set.tileX0; x <= set.tileX1; x++) {
-                    for(int y = set.tileY0; y <= set.tileY1; y++) {
-                        //-- See if tile is already downloaded
-                        QString hash = UrlFactory::getTileHash(type, x, y, z);
-                        quint64 tileID = _findTile(hash);
-                        if(!tileID) {
-                            //-- Set to download
-                            query.prepare("INSERT OR IGNORE INTO TilesDownload(setID, hash, type, x, y, z, state) VALUES(?, ?, ?, ?, ? ,? ,?)");
-                            query.addBindValue(setID);
-                            query.addBindValue(hash);
-                            query.addBindValue(UrlFactory::getQtMapIdFromProviderType(type));
-                            query.addBindValue(x);
-                            query.addBindValue(y);
-                            query.addBindValue(z);
-                            query.addBindValue(0);
-                            if(!query.exec()) {
-                                qWarning() << "Map Cache SQL error (add tile into TilesDownload):" << query.lastError().text();
-                                mtask->setError("Error creating tile set download list");
+            const QString type = task->tileSet()->type();
+            auto addTile = [&](int x, int y, int z) {
+                //-- See if tile is already downloaded
+                QString hash = UrlFactory::getTileHash(type, x, y, z);
+                quint64 tileID = _findTile(hash);
+                if(!tileID) {
+                    //-- Set to download
+                    query.prepare("INSERT OR IGNORE INTO TilesDownload(setID, hash, type, x, y, z, state) VALUES(?, ?, ?, ?, ? ,? ,?)");
+                    query.addBindValue(setID);
+                    query.addBindValue(hash);
+                    query.addBindValue(UrlFactory::getQtMapIdFromProviderType(type));
+                    query.addBindValue(x);
+                    query.addBindValue(y);
+                    query.addBindValue(z);
+                    query.addBindValue(0);
+                    if(!query.exec()) {
+                        qWarning() << "Map Cache SQL error (add tile into TilesDownload):" << query.lastError().text();
+                        mtask->setError("Error creating tile set download list");
+                        return false;
+                    } else
+                        actual_count++;
+                } else {
+                    //-- Tile already in the database. No need to dowload.
+                    QString s = QString("INSERT OR IGNORE INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
+                    query.prepare(s);
+                    if(!query.exec()) {
+                        qWarning() << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
+                    }
+                    qCDebug(QGCTileCacheWorkerLog) << "_createTileSet() Already Cached HASH:" << hash;
+                }
+                return true;
+            };
+            if(!task->tileSet()->tiles().isEmpty()) {
+                //-- Explicit tiles, for sets covering a polygon rather than the whole bounding box
+                for(const QPoint& tile: task->tileSet()->tiles()) {
+                    if(!addTile(tile.x(), tile.y(), task->tileSet()->minZoom())) {
+                        return;
+                    }
+                }
+            } else {
+                for(int z = task->tileSet()->minZoom(); z <= task->tileSet()->maxZoom(); z++) {
+                    QGCTileSet set = UrlFactory::getTileCount(z,
+                        task->tileSet()->topleftLon(), task->tileSet()->topleftLat(),
+                        task->tileSet()->bottomRightLon(), task->tileSet()->bottomRightLat(), type);
+                    for(int x = set.tileX0; x <= set.tileX1; x++) {
+                        for(int y = set.tileY0; y <= set.tileY1; y++) {
+                            if(!addTile(x, y, z)) {
                                 return;
-                            } else
-                                actual_count++;
-                        } else {
-                            //-- Tile already in the database. No need to dowload.
-                            QString s = QString("INSERT OR IGNORE INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
-                            query.prepare(s);
-                            if(!query.exec()) {
-                                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
                             }
-                            qCDebug(QGCTileCacheWorkerLog) << "_createTileSet() Already Cached HASH:" << hash;
                         }
                     }
                 }
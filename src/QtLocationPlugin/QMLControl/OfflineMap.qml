@@ -401,6 +401,26 @@ Item {
                     visible:        _customURLFact ? _customURLFact.visible : false
                     font.pointSize: _adjustableFontPointSize
                 }
+
+                Item { width: 1; height: 1 }
+                QGCLabel { text: qsTr("Terrain Tile Cache") }
+
+                GridLayout {
+                    id:             terrainCacheGrid
+                    columns:        2
+                    columnSpacing:  ScreenTools.defaultFontPixelWidth
+
+                    property var _terrainTileManager: QGroundControl.terrainTileManager
+
+                    QGCLabel { text: qsTr("Tiles in memory:") }
+                    QGCLabel { text: qsTr("%1 (%2 / %3 MB)").arg(terrainCacheGrid._terrainTileManager.cachedTileCount).arg((terrainCacheGrid._terrainTileManager.cacheSize / (1024 * 1024)).toFixed(1)).arg((terrainCacheGrid._terrainTileManager.maxCacheSize / (1024 * 1024)).toFixed(0)) }
+                    QGCLabel { text: qsTr("Hits / Misses:") }
+                    QGCLabel { text: terrainCacheGrid._terrainTileManager.cacheHits + " / " + terrainCacheGrid._terrainTileManager.cacheMisses }
+                    QGCLabel { text: qsTr("Evictions:") }
+                    QGCLabel { text: terrainCacheGrid._terrainTileManager.cacheEvictions }
+                    QGCLabel { text: qsTr("Loaded from disk cache:") }
+                    QGCLabel { text: terrainCacheGrid._terrainTileManager.diskCacheHits }
+                }
             }
         }
     } // Component - optionsDialogComponent
@@ -165,6 +165,56 @@ void QGCMapEngineManager::startDownload(const QString &name, const QString &mapT
     }
 }
 
+int QGCMapEngineManager::startElevationDownload(const QString &name, const QList<QGeoCoordinate> &polygon)
+{
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(kElevationMapType);
+    const std::shared_ptr<const CopernicusElevationProvider> elevationProvider = std::dynamic_pointer_cast<const CopernicusElevationProvider>(provider);
+    if (!elevationProvider) {
+        qCWarning(QGCMapEngineManagerLog) << Q_FUNC_INFO << "Unsupported elevation provider" << kElevationMapType;
+        return 0;
+    }
+
+    const QList<QPoint> tiles = elevationProvider->getTilesForPolygon(polygon);
+    if (tiles.isEmpty()) {
+        qCWarning(QGCMapEngineManagerLog) << Q_FUNC_INFO << "No Tiles to save";
+        return 0;
+    }
+
+    double north = polygon.first().latitude();
+    double south = north;
+    double west = polygon.first().longitude();
+    double east = west;
+    for (const QGeoCoordinate &coordinate : polygon) {
+        north = qMax(north, coordinate.latitude());
+        south = qMin(south, coordinate.latitude());
+        west = qMin(west, coordinate.longitude());
+        east = qMax(east, coordinate.longitude());
+    }
+
+    QGCCachedTileSet* const set = new QGCCachedTileSet(name);
+    set->setMapTypeStr(kElevationMapType);
+    set->setTopleftLat(north);
+    set->setTopleftLon(west);
+    set->setBottomRightLat(south);
+    set->setBottomRightLon(east);
+    set->setMinZoom(1);
+    set->setMaxZoom(1);
+    set->setTiles(tiles);
+    set->setTotalTileSize(static_cast<quint64>(tiles.count()) * provider->getAverageSize());
+    set->setTotalTileCount(static_cast<quint32>(tiles.count()));
+    set->setType(kElevationMapType);
+
+    // Downloads run through the regular tile set machinery, so they are parallel, report progress and resume
+    QGCCreateTileSetTask* const task = new QGCCreateTileSetTask(set);
+    (void) connect(task, &QGCCreateTileSetTask::tileSetSaved, this, &QGCMapEngineManager::_tileSetSaved);
+    (void) connect(task, &QGCMapTask::error, this, &QGCMapEngineManager::taskError);
+    (void) getQGCMapEngine()->addTask(task);
+
+    qCDebug(QGCMapEngineManagerLog) << Q_FUNC_INFO << name << "tiles" << tiles.count();
+
+    return static_cast<int>(tiles.count());
+}
+
 void QGCMapEngineManager::_tileSetSaved(QGCCachedTileSet *set)
 {
     qCDebug(QGCMapEngineManagerLog) << "New tile set saved (" << set->name() << "). Starting download...";
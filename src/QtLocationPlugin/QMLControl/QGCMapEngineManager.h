@@ -18,6 +18,7 @@
 
 // #include <QtQmlIntegration/QtQmlIntegration>
 #include <QtCore/QLoggingCategory>
+#include <QtPositioning/QGeoCoordinate>
 
 Q_DECLARE_LOGGING_CATEGORY(QGCMapEngineManagerLog)
 
@@ -72,6 +73,10 @@ public:
     Q_INVOKABLE void selectAll();
     Q_INVOKABLE void selectNone();
     Q_INVOKABLE void startDownload(const QString &name, const QString &mapType);
+    /// Creates and downloads an elevation tile set covering only the tiles which intersect @a polygon, such as a survey
+    /// area, a corridor or the bounding box of a mission
+    ///     @return Number of tiles in the set, 0 if nothing was queued
+    Q_INVOKABLE int startElevationDownload(const QString &name, const QList<QGeoCoordinate> &polygon);
     Q_INVOKABLE void updateForCurrentView(double lon0, double lat0, double lon1, double lat1, int minZoom, int maxZoom, const QString &mapName);
 
     Q_INVOKABLE static QString loadSetting(const QString &key, const QString &defaultValue);
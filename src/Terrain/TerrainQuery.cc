@@ -212,6 +212,11 @@ bool TerrainAtCoordinateQuery::getAltitudesForCoordinates(const QList<QGeoCoordi
     return TerrainTileManager::instance()->getAltitudesForCoordinates(coordinates, altitudes, error);
 }
 
+int TerrainAtCoordinateQuery::getAvailableAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error)
+{
+    return TerrainTileManager::instance()->getAvailableAltitudesForCoordinates(coordinates, altitudes, error);
+}
+
 void TerrainAtCoordinateQuery::signalTerrainData(bool success, const QList<double> &heights)
 {
     emit terrainDataReceived(success, heights);
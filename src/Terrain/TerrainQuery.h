@@ -97,6 +97,12 @@ public:
     /// @return true: altitude returned (check error as well), false: database query queued (altitudes not returned)
     static bool getAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error);
 
+    /// Returns the altitudes which are available now and queues downloads for the rest
+    ///     @param[out] altitudes One per coordinate, NaN for coordinates which aren't available yet
+    ///     @param[out] error true: an available altitude is invalid
+    /// @return Number of coordinates waiting on downloads
+    static int getAvailableAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error);
+
     void signalTerrainData(bool success, const QList<double> &heights);
 
 signals:
@@ -10,9 +10,12 @@
 #include "TerrainTile.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QVarLengthArray>
 #include <QtCore/QtNumeric>
 #include <QtPositioning/QGeoCoordinate>
 
+#include <cstring>
+
 QGC_LOGGING_CATEGORY(TerrainTileLog, "qgc.terrain.terraintile");
 
 TerrainTile::TerrainTile()
@@ -21,51 +24,48 @@ TerrainTile::TerrainTile()
 }
 
 TerrainTile::TerrainTile(const QByteArray &byteArray)
-    : _tileInfo(*reinterpret_cast<const TileInfo_t*>(byteArray.constData()))
 {
     // qCDebug(TerrainTileLog) << Q_FUNC_INFO << this;
 
+    const int cTileHeaderBytes = static_cast<int>(sizeof(TileInfo_t));
+    const int cTileBytesAvailable = byteArray.size();
+
+    if (cTileBytesAvailable < cTileHeaderBytes) {
+        qCWarning(TerrainTileLog) << "Terrain tile binary data too small for TileInfo_s header";
+        return;
+    }
+
+    (void) memcpy(&_tileInfo, byteArray.constData(), sizeof(TileInfo_t));
+
     if (((_tileInfo.neLon - _tileInfo.swLon) < 0.0) || ((_tileInfo.neLat - _tileInfo.swLat) < 0.0)) {
         qCWarning(TerrainTileLog) << this << "Tile extent is infeasible";
         _isValid = false;
         return;
     }
 
+    if ((_tileInfo.gridSizeLat <= 0) || (_tileInfo.gridSizeLon <= 0)) {
+        qCWarning(TerrainTileLog) << this << "Tile grid is empty";
+        return;
+    }
+
     _cellSizeLat = (_tileInfo.neLat - _tileInfo.swLat) / _tileInfo.gridSizeLat;
     _cellSizeLon = (_tileInfo.neLon - _tileInfo.swLon) / _tileInfo.gridSizeLon;
 
     qCDebug(TerrainTileLog) << this << "TileInfo: south west:" << _tileInfo.swLat << _tileInfo.swLon;
     qCDebug(TerrainTileLog) << this << "TileInfo: north east:" << _tileInfo.neLat << _tileInfo.neLon;
-    qCDebug(TerrainTileLog) << this << "TileInfo: dimensions:" << _tileInfo.gridSizeLat << "by" << _tileInfo.gridSizeLat;
+    qCDebug(TerrainTileLog) << this << "TileInfo: dimensions:" << _tileInfo.gridSizeLat << "by" << _tileInfo.gridSizeLon;
     qCDebug(TerrainTileLog) << this << "TileInfo: min, max, avg:" << _tileInfo.minElevation << _tileInfo.maxElevation << _tileInfo.avgElevation;
     qCDebug(TerrainTileLog) << this << "TileInfo: cell size:" << _cellSizeLat << _cellSizeLon;
 
-    const int cTileHeaderBytes = static_cast<int>(sizeof(TileInfo_t));
-    const int cTileBytesAvailable = byteArray.size();
-
-    if (cTileBytesAvailable < cTileHeaderBytes) {
-        qCWarning(TerrainTileLog) << "Terrain tile binary data too small for TileInfo_s header";
-        return;
-    }
-
     const int cTileDataBytes = static_cast<int>(sizeof(int16_t)) * _tileInfo.gridSizeLat * _tileInfo.gridSizeLon;
     if (cTileBytesAvailable < cTileHeaderBytes + cTileDataBytes) {
         qCWarning(TerrainTileLog) << "Terrain tile binary data too small for tile data";
         return;
     }
 
-    _elevationData.resize(_tileInfo.gridSizeLat);
-    for (int k = 0; k < _tileInfo.gridSizeLat; k++) {
-        _elevationData[k].resize(_tileInfo.gridSizeLon);
-    }
-
-    int valueIndex = 0;
-    const int16_t* const pTileData = reinterpret_cast<const int16_t*>(&reinterpret_cast<const uint8_t*>(byteArray.constData())[cTileHeaderBytes]);
-    for (int i = 0; i < _tileInfo.gridSizeLat; i++) {
-        for (int j = 0; j < _tileInfo.gridSizeLon; j++) {
-            _elevationData[i][j] = pTileData[valueIndex++];
-        }
-    }
+    // The grid is used in place, holding on to the byte array keeps it alive without copying it
+    _tileData = byteArray;
+    _elevationData = reinterpret_cast<const int16_t*>(_tileData.constData() + cTileHeaderBytes);
 
     _isValid = true;
 }
@@ -78,39 +78,78 @@ TerrainTile::~TerrainTile()
 double TerrainTile::elevation(const QGeoCoordinate &coordinate) const
 {
     if (!_isValid) {
-        qCWarning(TerrainTileLog) << this << "Request for elevation, but tile is invalid.";
         return qQNaN();
     }
 
-    const double latDeltaSw = coordinate.latitude() - _tileInfo.swLat;
-    const double lonDeltaSw = coordinate.longitude() - _tileInfo.swLon;
+    const double latCells = (coordinate.latitude() - _tileInfo.swLat) / _cellSizeLat;
+    const double lonCells = (coordinate.longitude() - _tileInfo.swLon) / _cellSizeLon;
 
-    const int16_t latIndex = qFloor(latDeltaSw / _cellSizeLat);
-    const int16_t lonIndex = qFloor(lonDeltaSw / _cellSizeLon);
+    return _interpolate(latCells, lonCells);
+}
 
-    const bool latIndexInvalid = (latIndex < 0) || (latIndex > (_tileInfo.gridSizeLat - 1));
-    const bool lonIndexInvalid = (lonIndex < 0) || (lonIndex > (_tileInfo.gridSizeLon - 1));
+QList<double> TerrainTile::elevations(const QList<QGeoCoordinate> &coordinates) const
+{
+    const qsizetype count = coordinates.count();
+    QList<double> result(count, qQNaN());
+    if (!_isValid || (count == 0)) {
+        return result;
+    }
 
-    if (latIndexInvalid || lonIndexInvalid) {
-        qCWarning(TerrainTileLog) << this << "Internal error: coordinate" << coordinate << "outside tile bounds";
-        return qQNaN();
+    // Positions are converted to grid cells in separate passes over flat arrays so the compiler can vectorize the
+    // index math, only the grid lookups themselves are done per coordinate
+    QVarLengthArray<double, 256> latCells(count);
+    QVarLengthArray<double, 256> lonCells(count);
+    for (qsizetype i = 0; i < count; i++) {
+        latCells[i] = coordinates[i].latitude();
+        lonCells[i] = coordinates[i].longitude();
     }
 
-    if ((latIndex >= _elevationData.size()) || (lonIndex >= _elevationData[latIndex].size())) {
-        qCWarning(TerrainTileLog).noquote() << this << "Internal error: _elevationData size inconsistent _tileInfo << coordinate" << coordinate
-            << "\n\t_tillIndo.gridSizeLat: " << _tileInfo.gridSizeLat << " _tileInfo.gridSizeLon: " << _tileInfo.gridSizeLon
-            << "\n\t_data.size(): " << _elevationData.size() << " _elevationData[latIndex].size(): " << _elevationData[latIndex].size();
-        return qQNaN();
+    const double swLat = _tileInfo.swLat;
+    const double swLon = _tileInfo.swLon;
+    const double latScale = 1.0 / _cellSizeLat;
+    const double lonScale = 1.0 / _cellSizeLon;
+    double* const pLatCells = latCells.data();
+    double* const pLonCells = lonCells.data();
+    for (qsizetype i = 0; i < count; i++) {
+        pLatCells[i] = (pLatCells[i] - swLat) * latScale;
+        pLonCells[i] = (pLonCells[i] - swLon) * lonScale;
     }
-    const auto elevation = _elevationData[latIndex][lonIndex];
 
-    if (elevation < _tileInfo.minElevation) {
-        qCWarning(TerrainTileLog) << this << "Warning: elevation read is below min elevation in tile:" << elevation << "<" << _tileInfo.minElevation;
-    } else if (elevation > _tileInfo.maxElevation) {
-        qCWarning(TerrainTileLog) << this << "Warning: elevation read is above max elevation in tile:" << elevation << ">" << _tileInfo.maxElevation;
+    double* const pResult = result.data();
+    for (qsizetype i = 0; i < count; i++) {
+        pResult[i] = _interpolate(pLatCells[i], pLonCells[i]);
     }
 
-    qCDebug(TerrainTileLog) << this << "latIndex, lonIndex:" << latIndex << lonIndex << "elevation:" << elevation;
+    return result;
+}
+
+double TerrainTile::_interpolate(double latCells, double lonCells) const
+{
+    // Written so NaN positions fail the check as well
+    const bool latInside = (latCells >= 0.0) && (latCells < _tileInfo.gridSizeLat);
+    const bool lonInside = (lonCells >= 0.0) && (lonCells < _tileInfo.gridSizeLon);
+    if (!latInside || !lonInside) {
+        return qQNaN();
+    }
 
-    return static_cast<double>(elevation);
+    // Each value is the elevation at the center of its cell, positions between the outermost centers and the tile
+    // edge use the edge values
+    const int lastLat = _tileInfo.gridSizeLat - 1;
+    const int lastLon = _tileInfo.gridSizeLon - 1;
+    const double latPos = qBound(0.0, latCells - 0.5, static_cast<double>(lastLat));
+    const double lonPos = qBound(0.0, lonCells - 0.5, static_cast<double>(lastLon));
+
+    const int lat0 = static_cast<int>(latPos);
+    const int lon0 = static_cast<int>(lonPos);
+    const int lat1 = qMin(lat0 + 1, lastLat);
+    const int lon1 = qMin(lon0 + 1, lastLon);
+    const double latFraction = latPos - lat0;
+    const double lonFraction = lonPos - lon0;
+
+    const int16_t* const row0 = _elevationData + (lat0 * _tileInfo.gridSizeLon);
+    const int16_t* const row1 = _elevationData + (lat1 * _tileInfo.gridSizeLon);
+    const double south = row0[lon0] + (lonFraction * (row0[lon1] - row0[lon0]));
+    const double north = row1[lon0] + (lonFraction * (row1[lon1] - row1[lon0]));
+
+    return south + (latFraction * (north - south));
 }
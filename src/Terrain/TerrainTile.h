@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
 #include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 
@@ -30,11 +31,20 @@ public:
     ///    @return true if data is valid
     bool isValid() const { return _isValid; }
 
-    /// Evaluates the elevation at the given coordinate
+    /// Evaluates the elevation at the given coordinate, bilinearly interpolated between the surrounding cell centers
     ///    @param coordinate
-    ///    @return elevation
+    ///    @return elevation, NaN if the coordinate is outside of the tile
     double elevation(const QGeoCoordinate &coordinate) const;
 
+    /// Evaluates the elevations of many coordinates at once, same as calling elevation() for each of them
+    ///    @param coordinates
+    ///    @return elevation for each coordinate, NaN for coordinates outside of the tile
+    QList<double> elevations(const QList<QGeoCoordinate> &coordinates) const;
+
+    /// Approximate memory used by the tile, used as its cost in the tile cache
+    ///    @return size in bytes
+    qsizetype memorySize() const { return static_cast<qsizetype>(sizeof(TerrainTile)) + _tileData.size(); }
+
     /// Accessor for the minimum elevation of the tile
     ///    @return minimum elevation
     double minElevation() const { return (_isValid ? static_cast<double>(_tileInfo.minElevation) : qQNaN()); }
@@ -56,8 +66,12 @@ protected:
     };
 
 private:
+    /// Interpolates the grid at a position given in cells from the south west corner
+    double _interpolate(double latCells, double lonCells) const;
+
     TileInfo_t _tileInfo{};
-    QList<QList<int16_t>> _elevationData;   /// 2D elevation data array
+    QByteArray _tileData;                   /// serialized tile, shared with the cache it was loaded from
+    const int16_t *_elevationData = nullptr;/// row major elevation grid within _tileData, gridSizeLat rows of gridSizeLon values
     double _cellSizeLat = 0.0;              /// data grid size in latitude direction
     double _cellSizeLon = 0.0;              /// data grid size in longitude direction
     bool _isValid = false;                  /// data loaded is valid
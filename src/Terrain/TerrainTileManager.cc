@@ -16,7 +16,11 @@
 #include "QGCMapUrlEngine.h"
 #include "ElevationMapProvider.h"
 #include "QGCLoggingCategory.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "MapsSettings.h"
 
+#include <QtCore/QScopeGuard>
 #include <QtLocation/private/qgeotilespec_p.h>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkProxy>
@@ -33,6 +37,7 @@ TerrainTileManager *TerrainTileManager::instance()
 
 TerrainTileManager::TerrainTileManager(QObject *parent)
     : QObject(parent)
+    , _tiles(_defaultMaxCacheSize)
     , _networkManager(new QNetworkAccessManager(this))
 {
     // qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << this;
@@ -42,12 +47,16 @@ TerrainTileManager::TerrainTileManager(QObject *parent)
     proxy.setType(QNetworkProxy::DefaultProxy);
     _networkManager->setProxy(proxy);
 #endif
+
+    Fact* const maxDownloadsFact = qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxConcurrentTerrainDownloads();
+    _maxConcurrentDownloads = qMax(1, maxDownloadsFact->rawValue().toInt());
+    (void) connect(maxDownloadsFact, &Fact::rawValueChanged, this, [this](const QVariant &value) {
+        setMaxConcurrentDownloads(value.toInt());
+    });
 }
 
 TerrainTileManager::~TerrainTileManager()
 {
-    qDeleteAll(_tiles);
-
     // qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << this;
 }
 
@@ -149,55 +158,144 @@ void TerrainTileManager::addPathQuery(TerrainQueryInterface *terrainQueryInterfa
 }
 
 bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error)
+{
+    return (_getAltitudes(coordinates, altitudes, error, false /* fillMissing */) == 0);
+}
+
+int TerrainTileManager::getAvailableAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error)
+{
+    return _getAltitudes(coordinates, altitudes, error, true /* fillMissing */);
+}
+
+int TerrainTileManager::_getAltitudes(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error, bool fillMissing)
 {
     error = false;
 
+    // Statistics are signalled once per query rather than per tile lookup
+    const auto statisticsGuard = qScopeGuard([this]() { emit cacheStatisticsChanged(); });
+
     static const QString kMapType = CopernicusElevationProvider::kProviderKey;
     const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(kMapType);
-    for (const QGeoCoordinate &coordinate: coordinates) {
-        const QString tileHash = UrlFactory::getTileHash(
-            provider->getMapName(),
-            provider->long2tileX(coordinate.longitude(), 1),
-            provider->lat2tileY(coordinate.latitude(), 1),
-            1
-        );
-        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "hash:coordinate" << tileHash << coordinate;
-
-        TerrainTile* const tile = _getCachedTile(tileHash);
-        if (tile) {
-            const double elevation = tile->elevation(coordinate);
-            if (qIsNaN(elevation)) {
-                error = true;
+
+    altitudes.reserve(altitudes.count() + coordinates.count());
+    int missingCount = 0;
+
+    // Consecutive coordinates usually fall in the same tile (paths, survey grids), each run of them is sampled from
+    // the tile in a single batch
+    qsizetype runStart = 0;
+    while (runStart < coordinates.count()) {
+        const QGeoCoordinate &coordinate = coordinates[runStart];
+        const int tileX = provider->long2tileX(coordinate.longitude(), 1);
+        const int tileY = provider->lat2tileY(coordinate.latitude(), 1);
+
+        qsizetype runEnd = runStart + 1;
+        while ((runEnd < coordinates.count()) &&
+                (provider->long2tileX(coordinates[runEnd].longitude(), 1) == tileX) &&
+                (provider->lat2tileY(coordinates[runEnd].latitude(), 1) == tileY)) {
+            runEnd++;
+        }
+
+        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "tile:coordinate:count" << tileX << tileY << coordinate << (runEnd - runStart);
+
+        TerrainTile* const tile = _getCachedTile(_tileKey(tileX, tileY, 1));
+        if (!tile) {
+            // Keep going so every missing tile of the query is downloaded in parallel
+            missingCount += static_cast<int>(runEnd - runStart);
+            _requestTile(tileX, tileY, 1);
+            if (fillMissing) {
+                altitudes.append(QList<double>(runEnd - runStart, qQNaN()));
+            }
+        } else if (fillMissing || (missingCount == 0)) {
+            const QList<double> elevations = tile->elevations(coordinates.mid(runStart, runEnd - runStart));
+            for (const double elevation: elevations) {
+                if (qIsNaN(elevation)) {
+                    error = true;
+                }
+            }
+            if (error) {
                 qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "Internal Error: missing elevation in tile cache";
-            } else {
-                qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "returning elevation from tile cache" << elevation;
             }
-            altitudes.push_back(elevation);
-        } else if (_state != TerrainQuery::State::Downloading) {
-            QGeoTileSpec spec;
-            spec.setX(provider->long2tileX(coordinate.longitude(), 1));
-            spec.setY(provider->lat2tileY(coordinate.latitude(), 1));
-            spec.setZoom(1);
-            spec.setMapId(provider->getMapId());
-            const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
-            QGeoTiledMapReplyQGC* const reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
-            (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, &TerrainTileManager::_terrainDone);
-            _state = TerrainQuery::State::Downloading;
-            // TODO: Batch Downloading?
-            return false;
-        } else {
-            return false;
+            altitudes.append(elevations);
         }
+
+        runStart = runEnd;
     }
 
-    return true;
+    _startDownloads();
+
+    return missingCount;
 }
 
-void TerrainTileManager::_tileFailed()
+void TerrainTileManager::_requestTile(int x, int y, int zoom)
+{
+    const quint64 key = _tileKey(x, y, zoom);
+    if (_requestedTiles.contains(key)) {
+        return;
+    }
+
+    (void) _requestedTiles.insert(key);
+    _pendingDownloads.enqueue(key);
+}
+
+void TerrainTileManager::_startDownloads()
+{
+    while ((_downloadsInFlight < _maxConcurrentDownloads) && !_pendingDownloads.isEmpty()) {
+        const quint64 key = _pendingDownloads.dequeue();
+        _downloadsInFlight++;
+        qCDebug(TerrainTileManagerLog) << "Downloading tile" << key << "in flight" << _downloadsInFlight << "pending" << _pendingDownloads.count();
+        _downloadTile(key);
+    }
+}
+
+void TerrainTileManager::_downloadTile(quint64 key)
+{
+    static const QString kMapType = CopernicusElevationProvider::kProviderKey;
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(kMapType);
+
+    QGeoTileSpec spec;
+    spec.setX(static_cast<int>((key >> 24) & 0xFFFFFF));
+    spec.setY(static_cast<int>(key & 0xFFFFFF));
+    spec.setZoom(static_cast<int>(key >> 48));
+    spec.setMapId(provider->getMapId());
+
+    const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
+    QGeoTiledMapReplyQGC* const reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
+    (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, &TerrainTileManager::_terrainDone);
+}
+
+void TerrainTileManager::setMaxConcurrentDownloads(int maxConcurrentDownloads)
+{
+    _maxConcurrentDownloads = qMax(1, maxConcurrentDownloads);
+    _startDownloads();
+}
+
+bool TerrainTileManager::_coordinatesInTile(const QList<QGeoCoordinate> &coordinates, quint64 key)
+{
+    static const QString kMapType = CopernicusElevationProvider::kProviderKey;
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(kMapType);
+
+    for (const QGeoCoordinate &coordinate: coordinates) {
+        if (_tileKey(provider->long2tileX(coordinate.longitude(), 1), provider->lat2tileY(coordinate.latitude(), 1), 1) == key) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TerrainTileManager::_tileFailed(quint64 key)
 {
     QList<double> noAltitudes;
 
-    for (const QueuedRequestInfo_t &requestInfo: _requestQueue) {
+    // Requests which don't need the failed tile keep waiting for their own downloads
+    for (qsizetype i = _requestQueue.count() - 1; i >= 0; i--) {
+        const QueuedRequestInfo_t requestInfo = _requestQueue[i];
+        if (!_coordinatesInTile(requestInfo.coordinates, key)) {
+            continue;
+        }
+
+        _requestQueue.removeAt(i);
+
         switch (requestInfo.queryMode) {
         case TerrainQuery::QueryMode::QueryModeCoordinates:
             requestInfo.terrainQueryInterface->signalCoordinateHeights(false, noAltitudes);
@@ -206,17 +304,13 @@ void TerrainTileManager::_tileFailed()
             requestInfo.terrainQueryInterface->signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
             break;
         default:
-            continue;
+            break;
         }
     }
-
-    _requestQueue.clear();
 }
 
 void TerrainTileManager::_terrainDone()
 {
-    _state = TerrainQuery::State::Idle;
-
     QGeoTiledMapReplyQGC* const reply = qobject_cast<QGeoTiledMapReplyQGC*>(QObject::sender());
     if (!reply) {
         qCWarning(TerrainTileManagerLog) << "Elevation tile fetched but invalid reply data type.";
@@ -224,35 +318,62 @@ void TerrainTileManager::_terrainDone()
     }
     reply->deleteLater();
 
-    const QByteArray responseBytes = reply->mapImageData();
     const QGeoTileSpec spec = reply->tileSpec();
+    const quint64 key = _tileKey(spec.x(), spec.y(), spec.zoom());
 
     if (reply->error() != QGeoTiledMapReplyQGC::NoError) {
         qCWarning(TerrainTileManagerLog) << "Elevation tile fetching returned error:" << reply->errorString();
-        _tileFailed();
+        _tileDownloaded(key, QByteArray(), false);
         return;
     }
 
+    const QByteArray responseBytes = reply->mapImageData();
     if (responseBytes.isEmpty()) {
         qCWarning(TerrainTileManagerLog) << "Error in fetching elevation tile. Empty response.";
-        _tileFailed();
+    } else {
+        qCDebug(TerrainTileManagerLog) << "Received some bytes of terrain data:" << responseBytes.size() << "from disk cache:" << reply->isCached();
+    }
+
+    _tileDownloaded(key, responseBytes, reply->isCached());
+}
+
+void TerrainTileManager::_tileDownloaded(quint64 key, const QByteArray &data, bool fromDiskCache)
+{
+    _downloadsInFlight--;
+    (void) _requestedTiles.remove(key);
+
+    // Keep the download slots busy while the finished tile is processed
+    _startDownloads();
+
+    if (data.isEmpty()) {
+        _tileFailed(key);
         return;
     }
 
-    qCDebug(TerrainTileManagerLog) << "Received some bytes of terrain data:" << responseBytes.size();
+    if (fromDiskCache) {
+        _diskCacheHits++;
+    }
+    if (!_cacheTile(data, key)) {
+        _tileFailed(key);
+        return;
+    }
 
-    const QString hash = UrlFactory::getTileHash(UrlFactory::getProviderTypeFromQtMapId(spec.mapId()), spec.x(), spec.y(), spec.zoom());
-    _cacheTile(responseBytes, hash);
+    _processRequestQueue();
+}
 
+void TerrainTileManager::_processRequestQueue()
+{
     for (qsizetype i = _requestQueue.count() - 1; i >= 0; i--) {
         bool error;
         QList<double> altitudes;
-        QueuedRequestInfo_t &requestInfo = _requestQueue[i];
+        const QueuedRequestInfo_t requestInfo = _requestQueue[i];
 
         if (!getAltitudesForCoordinates(requestInfo.coordinates, altitudes, error)) {
             continue;
         }
 
+        _requestQueue.removeAt(i);
+
         switch (requestInfo.queryMode) {
         case TerrainQuery::QueryMode::QueryModeCoordinates:
             if (error) {
@@ -277,44 +398,85 @@ void TerrainTileManager::_terrainDone()
         default:
             break;
         }
-
-        _requestQueue.removeAt(i);
     }
 }
 
-void TerrainTileManager::_cacheTile(const QByteArray &data, const QString &hash)
+bool TerrainTileManager::_cacheTile(const QByteArray &data, quint64 key)
 {
     TerrainTile* const terrainTile = new TerrainTile(data);
-    if (terrainTile->isValid()) {
-        _tilesMutex.lock();
-        if (!_tiles.contains(hash)) {
-            (void) _tiles.insert(hash, terrainTile);
-        } else {
-            delete terrainTile;
-        }
-        _tilesMutex.unlock();
-    } else {
+    if (!terrainTile->isValid()) {
         delete terrainTile;
         qCWarning(TerrainTileManagerLog) << "Received invalid tile";
+        return false;
     }
+
+    {
+        QMutexLocker locker(&_tilesMutex);
+        if (_tiles.contains(key)) {
+            delete terrainTile;
+            return true;
+        }
+
+        // QCache takes ownership and evicts the least recently used tiles to stay within its bound
+        const qsizetype countBefore = _tiles.count();
+        if (_tiles.insert(key, terrainTile, terrainTile->memorySize())) {
+            _cacheEvictions += static_cast<quint64>(countBefore + 1 - _tiles.count());
+        } else {
+            qCWarning(TerrainTileManagerLog) << "Tile larger than the tile cache" << _tiles.maxCost();
+        }
+    }
+
+    emit cacheStatisticsChanged();
+
+    return true;
 }
 
-TerrainTile *TerrainTileManager::_getCachedTile(const QString &hash)
+TerrainTile *TerrainTileManager::_getCachedTile(quint64 key)
 {
-    _tilesMutex.lock();
-    if (!_tiles.contains(hash)) {
-        _tilesMutex.unlock();
-        return nullptr;
+    QMutexLocker locker(&_tilesMutex);
+
+    // QCache::object marks the tile as most recently used
+    TerrainTile* const tile = _tiles.object(key);
+    if (tile) {
+        _cacheHits++;
+    } else {
+        _cacheMisses++;
     }
 
-    TerrainTile* const tile = _tiles[hash];
+    return tile;
+}
 
-    if (!tile->isValid()) {
-        _tilesMutex.unlock();
-        return nullptr;
-    }
+quint64 TerrainTileManager::_tileKey(int x, int y, int zoom)
+{
+    return ((static_cast<quint64>(zoom) << 48) | (static_cast<quint64>(static_cast<quint32>(x) & 0xFFFFFF) << 24) | (static_cast<quint32>(y) & 0xFFFFFF));
+}
 
-    _tilesMutex.unlock();
+int TerrainTileManager::cachedTileCount() const
+{
+    QMutexLocker locker(&_tilesMutex);
+    return static_cast<int>(_tiles.count());
+}
 
-    return tile;
+qint64 TerrainTileManager::cacheSize() const
+{
+    QMutexLocker locker(&_tilesMutex);
+    return _tiles.totalCost();
+}
+
+qint64 TerrainTileManager::maxCacheSize() const
+{
+    QMutexLocker locker(&_tilesMutex);
+    return _tiles.maxCost();
+}
+
+void TerrainTileManager::setMaxCacheSize(qint64 bytes)
+{
+    {
+        QMutexLocker locker(&_tilesMutex);
+        const qsizetype countBefore = _tiles.count();
+        _tiles.setMaxCost(bytes);
+        _cacheEvictions += static_cast<quint64>(countBefore - _tiles.count());
+    }
+
+    emit cacheStatisticsChanged();
 }
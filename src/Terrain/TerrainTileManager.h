@@ -11,10 +11,12 @@
 
 #include "TerrainQueryInterface.h"
 
+#include <QtCore/QCache>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QQueue>
+#include <QtCore/QSet>
 #include <QtPositioning/QGeoCoordinate>
 
 class TerrainTile;
@@ -22,10 +24,22 @@ class QNetworkAccessManager;
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainTileManagerLog)
 
+/// Tiles are kept in a size bounded least recently used memory cache. Tiles evicted from it are fetched again through
+/// QGeoTiledMapReplyQGC, which looks in the on disk map cache before going to the network. All tiles missing for a
+/// query are fetched in parallel, up to maxConcurrentDownloads at a time, and each query completes as soon as its
+/// own tiles are available.
 class TerrainTileManager : public QObject
 {
     Q_OBJECT
 
+    Q_PROPERTY(quint64  cacheHits       READ cacheHits          NOTIFY cacheStatisticsChanged)
+    Q_PROPERTY(quint64  cacheMisses     READ cacheMisses        NOTIFY cacheStatisticsChanged)
+    Q_PROPERTY(quint64  cacheEvictions  READ cacheEvictions     NOTIFY cacheStatisticsChanged)
+    Q_PROPERTY(quint64  diskCacheHits   READ diskCacheHits      NOTIFY cacheStatisticsChanged)
+    Q_PROPERTY(int      cachedTileCount READ cachedTileCount    NOTIFY cacheStatisticsChanged)
+    Q_PROPERTY(qint64   cacheSize       READ cacheSize          NOTIFY cacheStatisticsChanged)
+    Q_PROPERTY(qint64   maxCacheSize    READ maxCacheSize       NOTIFY cacheStatisticsChanged)
+
 public:
     explicit TerrainTileManager(QObject *parent = nullptr);
     ~TerrainTileManager();
@@ -35,21 +49,72 @@ public:
     void addCoordinateQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &coordinates);
     void addPathQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &startPoint, const QGeoCoordinate &endPoint);
 
-    /// Either returns altitudes from cache or queues database request
+    /// Either returns altitudes from cache or requests all missing tiles
     ///     @param[out] error true: altitude not returned due to error, false: altitudes returned
-    ///     @return true: altitude returned (check error as well), false: database query queued (altitudes not returned)
+    ///     @return true: altitude returned (check error as well), false: tile downloads queued (altitudes not returned)
     bool getAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error);
 
+    /// Same as getAltitudesForCoordinates, but returns whatever the cached tiles have instead of all or nothing
+    ///     @param[out] altitudes One per coordinate, NaN for coordinates whose tile is still being downloaded
+    ///     @param[out] error true: a cached tile is missing an elevation
+    ///     @return Number of coordinates waiting on tile downloads
+    int getAvailableAltitudesForCoordinates(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error);
+
     /// Returns a list of individual coordinates along the requested path spaced according to the terrain tile value spacing
     static QList<QGeoCoordinate> pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween);
 
+    quint64 cacheHits() const { return _cacheHits; }            ///< Tile lookups answered from memory
+    quint64 cacheMisses() const { return _cacheMisses; }        ///< Tile lookups which required a fetch
+    quint64 cacheEvictions() const { return _cacheEvictions; }  ///< Tiles dropped from memory to stay within maxCacheSize
+    quint64 diskCacheHits() const { return _diskCacheHits; }    ///< Fetched tiles which came from the on disk map cache
+    int cachedTileCount() const;
+    qint64 cacheSize() const;                                   ///< Bytes used by the tiles in memory
+    qint64 maxCacheSize() const;
+
+    /// Sets the memory bound of the tile cache, evicting tiles if needed
+    ///     @param bytes
+    void setMaxCacheSize(qint64 bytes);
+
+    int maxConcurrentDownloads() const { return _maxConcurrentDownloads; }
+
+    /// Sets how many tiles are downloaded at the same time, downloads already running are not affected
+    void setMaxConcurrentDownloads(int maxConcurrentDownloads);
+
+signals:
+    void cacheStatisticsChanged();
+
 private slots:
     void _terrainDone();
 
 private:
-    void _tileFailed();
-    void _cacheTile(const QByteArray &data, const QString &hash);
-    TerrainTile *_getCachedTile(const QString &hash);
+    friend class TerrainTileTest; // Unit test
+
+    /// Fails the queued requests which need the tile @a key
+    void _tileFailed(quint64 key);
+    /// Starts the download of the tile @a key, the reply is handled by _terrainDone. Virtual so the unit test can
+    /// complete downloads without a network.
+    virtual void _downloadTile(quint64 key);
+    /// Frees the download slot of the tile @a key and caches the tile or fails the requests which need it
+    ///     @param data Tile data, empty if the download failed
+    void _tileDownloaded(quint64 key, const QByteArray &data, bool fromDiskCache);
+    /// @return false: tile data is invalid
+    bool _cacheTile(const QByteArray &data, quint64 key);
+    TerrainTile *_getCachedTile(quint64 key);
+    /// Shared by getAltitudesForCoordinates and getAvailableAltitudesForCoordinates
+    ///     @param fillMissing true: NaN for coordinates in missing tiles, false: stop adding altitudes at the first missing tile
+    ///     @return Number of coordinates in missing tiles
+    int _getAltitudes(const QList<QGeoCoordinate> &coordinates, QList<double> &altitudes, bool &error, bool fillMissing);
+
+    /// Queues a download of the tile unless it is already queued or downloading
+    void _requestTile(int x, int y, int zoom);
+    void _startDownloads();
+    /// Completes all queued requests whose tiles are now available
+    void _processRequestQueue();
+    /// @return true: one of @a coordinates lies in the tile @a key
+    static bool _coordinatesInTile(const QList<QGeoCoordinate> &coordinates, quint64 key);
+
+    /// Packs the tile coordinates into a cache key
+    static quint64 _tileKey(int x, int y, int zoom);
 
     struct QueuedRequestInfo_t {
         TerrainQueryInterface *terrainQueryInterface;
@@ -60,10 +125,21 @@ private:
     };
 
     QQueue<QueuedRequestInfo_t> _requestQueue;
-    TerrainQuery::State _state = TerrainQuery::State::Idle;
 
-    QMutex _tilesMutex;
-    QHash<QString, TerrainTile*> _tiles;
+    QQueue<quint64> _pendingDownloads;          ///< Tiles waiting for a free download slot
+    QSet<quint64> _requestedTiles;              ///< Tiles which are either pending or downloading
+    int _downloadsInFlight = 0;
+    int _maxConcurrentDownloads = _defaultMaxConcurrentDownloads;
+
+    mutable QMutex _tilesMutex;
+    QCache<quint64, TerrainTile> _tiles;         ///< Cost of each tile is TerrainTile::memorySize
+    quint64 _cacheHits = 0;
+    quint64 _cacheMisses = 0;
+    quint64 _cacheEvictions = 0;
+    quint64 _diskCacheHits = 0;
 
     QNetworkAccessManager *_networkManager = nullptr;
+
+    static constexpr qint64 _defaultMaxCacheSize = 32 * 1024 * 1024;
+    static constexpr int _defaultMaxConcurrentDownloads = 4;
 };
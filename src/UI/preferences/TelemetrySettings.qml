@@ -67,6 +67,13 @@ SettingsPage {
             checked:            QGroundControl.isVersionCheckEnabled
             onClicked:          QGroundControl.isVersionCheckEnabled = checked
         }
+
+        LabelledFactTextField {
+            Layout.fillWidth:   true
+            label:              qsTr("Outbound write latency")
+            fact:               _appSettings.linkWriteLatency
+            visible:            fact.visible
+        }
     }
 
     SettingsGroupLayout {
@@ -131,6 +138,24 @@ SettingsPage {
             visible:                    fact.visible
             enabled:                    _appSettings.forwardMavlink.rawValue
         }
+
+        LabelledFactTextField {
+            Layout.fillWidth:           true
+            textFieldPreferredWidth:    ScreenTools.defaultFontPixelWidth * 20
+            label:                      qsTr("System ids (empty for all)")
+            fact:                       _appSettings.forwardMavlinkSysIds
+            visible:                    fact.visible
+            enabled:                    _appSettings.forwardMavlink.rawValue
+        }
+
+        LabelledFactTextField {
+            Layout.fillWidth:           true
+            textFieldPreferredWidth:    ScreenTools.defaultFontPixelWidth * 20
+            label:                      qsTr("Message ids (empty for all)")
+            fact:                       _appSettings.forwardMavlinkMsgIds
+            visible:                    fact.visible
+            enabled:                    _appSettings.forwardMavlink.rawValue
+        }
     }
 
     SettingsGroupLayout {
@@ -155,6 +180,14 @@ SettingsPage {
             property Fact _telemetrySaveNotArmed: _appSettings.telemetrySaveNotArmed
         }
 
+        LabelledFactComboBox {
+            Layout.fillWidth:   true
+            label:              qsTr("Sync log to disk")
+            fact:               _appSettings.telemetryLogFsync
+            indexModel:         false
+            visible:            fact.visible
+        }
+
         FactCheckBoxSlider {
             Layout.fillWidth:   true
             text:               qsTr("Save CSV log of telemetry data")
@@ -24,6 +24,9 @@ public:
     Fact* blocksPending () { return &_blocksPendingFact; }
     Fact* blocksLoaded  () { return &_blocksLoadedFact; }
 
+    // Overrides from FactGroup
+    QList<uint32_t> handledMessageIds() const override { return {}; }  ///< Updated by TerrainProtocolHandler, not by messages
+
 private:
     const QString _blocksPendingFactName =  QStringLiteral("blocksPending");
     const QString _blocksLoadedFactName =   QStringLiteral("blocksLoaded");
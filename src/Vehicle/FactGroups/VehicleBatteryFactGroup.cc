@@ -88,13 +88,22 @@ void VehicleBatteryFactGroup::handleMessage(Vehicle* vehicle, mavlink_message_t&
     }
 }
 
+QList<uint32_t> VehicleBatteryFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2,
+        MAVLINK_MSG_ID_BATTERY_STATUS,
+    };
+}
+
 void VehicleBatteryFactGroup::_handleHighLatency(Vehicle* vehicle, mavlink_message_t& message)
 {
     mavlink_high_latency_t highLatency;
     mavlink_msg_high_latency_decode(&message, &highLatency);
 
     VehicleBatteryFactGroup* group = _findOrAddBatteryGroupById(vehicle, 0);
-    group->percentRemaining()->setRawValue(highLatency.battery_remaining == UINT8_MAX ? qQNaN() : highLatency.battery_remaining);
+    group->percentRemaining()->setRawDouble(highLatency.battery_remaining == UINT8_MAX ? qQNaN() : highLatency.battery_remaining);
     group->_setTelemetryAvailable(true);
 }
 
@@ -104,7 +113,7 @@ void VehicleBatteryFactGroup::_handleHighLatency2(Vehicle* vehicle, mavlink_mess
     mavlink_msg_high_latency2_decode(&message, &highLatency2);
 
     VehicleBatteryFactGroup* group = _findOrAddBatteryGroupById(vehicle, 0);
-    group->percentRemaining()->setRawValue(highLatency2.battery == -1 ? qQNaN() : highLatency2.battery);
+    group->percentRemaining()->setRawDouble(highLatency2.battery == -1 ? qQNaN() : highLatency2.battery);
     group->_setTelemetryAvailable(true);
 }
 
@@ -135,16 +144,16 @@ void VehicleBatteryFactGroup::_handleBatteryStatus(Vehicle* vehicle, mavlink_mes
         totalVoltage += cellVoltage;
     }
 
-    group->function()->setRawValue          (batteryStatus.battery_function);
-    group->type()->setRawValue              (batteryStatus.type);
-    group->temperature()->setRawValue       (batteryStatus.temperature == INT16_MAX ?   qQNaN() : static_cast<double>(batteryStatus.temperature) / 100.0);
-    group->voltage()->setRawValue           (totalVoltage);
-    group->current()->setRawValue           (batteryStatus.current_battery == -1 ?      qQNaN() : static_cast<double>(batteryStatus.current_battery) / 100.0);
-    group->mahConsumed()->setRawValue       (batteryStatus.current_consumed == -1  ?    qQNaN() : batteryStatus.current_consumed);
-    group->percentRemaining()->setRawValue  (batteryStatus.battery_remaining == -1 ?    qQNaN() : batteryStatus.battery_remaining);
-    group->timeRemaining()->setRawValue     (batteryStatus.time_remaining == 0 ?        qQNaN() : batteryStatus.time_remaining);
-    group->chargeState()->setRawValue       (batteryStatus.charge_state);
-    group->instantPower()->setRawValue      (totalVoltage * group->current()->rawValue().toDouble());
+    group->function()->setRawInt            (batteryStatus.battery_function);
+    group->type()->setRawInt                (batteryStatus.type);
+    group->temperature()->setRawDouble      (batteryStatus.temperature == INT16_MAX ?   qQNaN() : static_cast<double>(batteryStatus.temperature) / 100.0);
+    group->voltage()->setRawDouble          (totalVoltage);
+    group->current()->setRawDouble          (batteryStatus.current_battery == -1 ?      qQNaN() : static_cast<double>(batteryStatus.current_battery) / 100.0);
+    group->mahConsumed()->setRawDouble      (batteryStatus.current_consumed == -1  ?    qQNaN() : batteryStatus.current_consumed);
+    group->percentRemaining()->setRawDouble (batteryStatus.battery_remaining == -1 ?    qQNaN() : batteryStatus.battery_remaining);
+    group->timeRemaining()->setRawDouble    (batteryStatus.time_remaining == 0 ?        qQNaN() : batteryStatus.time_remaining);
+    group->chargeState()->setRawInt         (batteryStatus.charge_state);
+    group->instantPower()->setRawDouble     (totalVoltage * group->current()->rawValue().toDouble());
     group->_setTelemetryAvailable(true);
 }
 
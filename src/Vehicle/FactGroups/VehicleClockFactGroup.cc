@@ -23,6 +23,9 @@ VehicleClockFactGroup::VehicleClockFactGroup(QObject* parent)
     _currentTimeFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _currentUTCTimeFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _currentDateFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
+
+    // Values come from the local clock, not from changes
+    _setPeriodicUpdates(true);
 }
 
 void VehicleClockFactGroup::_updateAllValues()
@@ -80,6 +80,13 @@ void VehicleEFIFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_
     }
 }
 
+QList<uint32_t> VehicleEFIFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_EFI_STATUS,
+    };
+}
+
 void VehicleEFIFactGroup::_handleEFIStatus(mavlink_message_t& message)
 {
     mavlink_efi_status_t efi;
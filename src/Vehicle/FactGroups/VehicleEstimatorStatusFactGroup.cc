@@ -87,3 +87,10 @@ void VehicleEstimatorStatusFactGroup::handleMessage(Vehicle* /* vehicle */, mavl
 
     _setTelemetryAvailable(true);
 }
+
+QList<uint32_t> VehicleEstimatorStatusFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_ESTIMATOR_STATUS,
+    };
+}
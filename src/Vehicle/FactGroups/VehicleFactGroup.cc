@@ -110,6 +110,22 @@ void VehicleFactGroup::handleMessage(Vehicle* vehicle, mavlink_message_t& messag
     }
 }
 
+QList<uint32_t> VehicleFactGroup::handledMessageIds() const
+{
+    QList<uint32_t> messageIds = {
+        MAVLINK_MSG_ID_ATTITUDE,
+        MAVLINK_MSG_ID_ATTITUDE_QUATERNION,
+        MAVLINK_MSG_ID_ALTITUDE,
+        MAVLINK_MSG_ID_VFR_HUD,
+        MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT,
+        MAVLINK_MSG_ID_RAW_IMU,
+    };
+#ifndef NO_ARDUPILOT_DIALECT
+    messageIds.append(MAVLINK_MSG_ID_RANGEFINDER);
+#endif
+    return messageIds;
+}
+
 void VehicleFactGroup::_handleAttitudeWorker(double rollRadians, double pitchRadians, double yawRadians)
 {
     double roll = QGC::limitAngleToPMPIf(rollRadians);
@@ -126,9 +142,9 @@ void VehicleFactGroup::_handleAttitudeWorker(double rollRadians, double pitchRad
     // truncate to integer so widget never displays 360
     yaw = trunc(yaw);
 
-    _rollFact.setRawValue(roll);
-    _pitchFact.setRawValue(pitch);
-    _headingFact.setRawValue(yaw);
+    _rollFact.setRawDouble(roll);
+    _pitchFact.setRawDouble(pitch);
+    _headingFact.setRawDouble(yaw);
 }
 
 void VehicleFactGroup::_handleAttitude(Vehicle* vehicle, const mavlink_message_t &message)
@@ -155,8 +171,8 @@ void VehicleFactGroup::_handleAltitude(const mavlink_message_t &message)
 
     // Data from ALTITUDE message takes precedence over gps messages
     _altitudeMessageAvailable = true;
-    _altitudeRelativeFact.setRawValue(altitude.altitude_relative);
-    _altitudeAMSLFact.setRawValue(altitude.altitude_amsl);
+    _altitudeRelativeFact.setRawDouble(altitude.altitude_relative);
+    _altitudeAMSLFact.setRawDouble(altitude.altitude_amsl);
 }
 
 void VehicleFactGroup::_handleAttitudeQuaternion(Vehicle* vehicle, const mavlink_message_t &message)
@@ -187,9 +203,9 @@ void VehicleFactGroup::_handleAttitudeQuaternion(Vehicle* vehicle, const mavlink
 
     _handleAttitudeWorker(roll, pitch, yaw);
 
-    _rollRateFact.setRawValue(qRadiansToDegrees(rates[0]));
-    _pitchRateFact.setRawValue(qRadiansToDegrees(rates[1]));
-    _yawRateFact.setRawValue(qRadiansToDegrees(rates[2]));
+    _rollRateFact.setRawDouble(qRadiansToDegrees(rates[0]));
+    _pitchRateFact.setRawDouble(qRadiansToDegrees(rates[1]));
+    _yawRateFact.setRawDouble(qRadiansToDegrees(rates[2]));
 }
 
 void VehicleFactGroup::_handleNavControllerOutput(const mavlink_message_t &message)
@@ -197,10 +213,10 @@ void VehicleFactGroup::_handleNavControllerOutput(const mavlink_message_t &messa
     mavlink_nav_controller_output_t navControllerOutput;
     mavlink_msg_nav_controller_output_decode(&message, &navControllerOutput);
 
-    _altitudeTuningSetpointFact.setRawValue(_altitudeTuningFact.rawValue().toDouble() - navControllerOutput.alt_error);
-    _xTrackErrorFact.setRawValue(navControllerOutput.xtrack_error);
-    _airSpeedSetpointFact.setRawValue(_airSpeedFact.rawValue().toDouble() - navControllerOutput.aspd_error);
-    _distanceToNextWPFact.setRawValue(navControllerOutput.wp_dist);
+    _altitudeTuningSetpointFact.setRawDouble(_altitudeTuningFact.rawValue().toDouble() - navControllerOutput.alt_error);
+    _xTrackErrorFact.setRawDouble(navControllerOutput.xtrack_error);
+    _airSpeedSetpointFact.setRawDouble(_airSpeedFact.rawValue().toDouble() - navControllerOutput.aspd_error);
+    _distanceToNextWPFact.setRawDouble(navControllerOutput.wp_dist);
 }
 
 void VehicleFactGroup::_handleVfrHud(const mavlink_message_t &message)
@@ -208,16 +224,16 @@ void VehicleFactGroup::_handleVfrHud(const mavlink_message_t &message)
     mavlink_vfr_hud_t vfrHud;
     mavlink_msg_vfr_hud_decode(&message, &vfrHud);
 
-    _airSpeedFact.setRawValue(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
-    _groundSpeedFact.setRawValue(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
-    _climbRateFact.setRawValue(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
-    _throttlePctFact.setRawValue(static_cast<int16_t>(vfrHud.throttle));
+    _airSpeedFact.setRawDouble(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
+    _groundSpeedFact.setRawDouble(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
+    _climbRateFact.setRawDouble(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
+    _throttlePctFact.setRawInt(static_cast<int16_t>(vfrHud.throttle));
     if (qIsNaN(_altitudeTuningOffset)) {
         _altitudeTuningOffset = vfrHud.alt;
     }
-    _altitudeTuningFact.setRawValue(vfrHud.alt - _altitudeTuningOffset);
+    _altitudeTuningFact.setRawDouble(vfrHud.alt - _altitudeTuningOffset);
     if (!qIsNaN(vfrHud.groundspeed) && !qIsNaN(_distanceToHomeFact.cookedValue().toDouble())) {
-      _timeToHomeFact.setRawValue(_distanceToHomeFact.cookedValue().toDouble() / vfrHud.groundspeed);
+      _timeToHomeFact.setRawDouble(_distanceToHomeFact.cookedValue().toDouble() / vfrHud.groundspeed);
     }
 }
 
@@ -226,7 +242,7 @@ void VehicleFactGroup::_handleRawImuTemp(const mavlink_message_t &message)
     mavlink_raw_imu_t imuRaw;
     mavlink_msg_raw_imu_decode(&message, &imuRaw);
 
-    _imuTempFact.setRawValue(imuRaw.temperature == 0 ? 0 : imuRaw.temperature * 0.01);
+    _imuTempFact.setRawDouble(imuRaw.temperature == 0 ? 0 : imuRaw.temperature * 0.01);
 }
 
 #ifndef NO_ARDUPILOT_DIALECT
@@ -236,6 +252,6 @@ void VehicleFactGroup::_handleRangefinder(const mavlink_message_t &message)
     mavlink_rangefinder_t rangefinder;
     mavlink_msg_rangefinder_decode(&message, &rangefinder);
 
-    _rangeFinderDistFact.setRawValue(qIsNaN(rangefinder.distance) ? 0 : rangefinder.distance);
+    _rangeFinderDistFact.setRawDouble(qIsNaN(rangefinder.distance) ? 0 : rangefinder.distance);
 }
 #endif
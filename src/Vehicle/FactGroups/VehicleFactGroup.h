@@ -78,6 +78,7 @@ public:
     Fact* imuTemp                   () { return &_imuTempFact; }
 
     void handleMessage(Vehicle* vehicle, mavlink_message_t& message) override;
+    QList<uint32_t> handledMessageIds() const override;
 
 protected:
     void _handleAttitude                (Vehicle* vehicle, const mavlink_message_t &message);
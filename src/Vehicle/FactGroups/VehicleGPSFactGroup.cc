@@ -56,19 +56,28 @@ void VehicleGPSFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message_
     }
 }
 
+QList<uint32_t> VehicleGPSFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_GPS_RAW_INT,
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2,
+    };
+}
+
 void VehicleGPSFactGroup::_handleGpsRawInt(mavlink_message_t& message)
 {
     mavlink_gps_raw_int_t gpsRawInt;
     mavlink_msg_gps_raw_int_decode(&message, &gpsRawInt);
 
-    lat()->setRawValue              (gpsRawInt.lat * 1e-7);
-    lon()->setRawValue              (gpsRawInt.lon * 1e-7);
+    lat()->setRawDouble             (gpsRawInt.lat * 1e-7);
+    lon()->setRawDouble             (gpsRawInt.lon * 1e-7);
     mgrs()->setRawValue             (QGCGeo::convertGeoToMGRS(QGeoCoordinate(gpsRawInt.lat * 1e-7, gpsRawInt.lon * 1e-7)));
-    count()->setRawValue            (gpsRawInt.satellites_visible == 255 ? 0 : gpsRawInt.satellites_visible);
-    hdop()->setRawValue             (gpsRawInt.eph == UINT16_MAX ? qQNaN() : gpsRawInt.eph / 100.0);
-    vdop()->setRawValue             (gpsRawInt.epv == UINT16_MAX ? qQNaN() : gpsRawInt.epv / 100.0);
-    courseOverGround()->setRawValue (gpsRawInt.cog == UINT16_MAX ? qQNaN() : gpsRawInt.cog / 100.0);
-    lock()->setRawValue             (gpsRawInt.fix_type);
+    count()->setRawInt              (gpsRawInt.satellites_visible == 255 ? 0 : gpsRawInt.satellites_visible);
+    hdop()->setRawDouble            (gpsRawInt.eph == UINT16_MAX ? qQNaN() : gpsRawInt.eph / 100.0);
+    vdop()->setRawDouble            (gpsRawInt.epv == UINT16_MAX ? qQNaN() : gpsRawInt.epv / 100.0);
+    courseOverGround()->setRawDouble(gpsRawInt.cog == UINT16_MAX ? qQNaN() : gpsRawInt.cog / 100.0);
+    lock()->setRawInt               (gpsRawInt.fix_type);
 }
 
 void VehicleGPSFactGroup::_handleHighLatency(mavlink_message_t& message)
@@ -86,10 +95,10 @@ void VehicleGPSFactGroup::_handleHighLatency(mavlink_message_t& message)
                 static_cast<double>(highLatency.altitude_amsl)
     };
 
-    lat()->setRawValue  (coordinate.latitude);
-    lon()->setRawValue  (coordinate.longitude);
+    lat()->setRawDouble (coordinate.latitude);
+    lon()->setRawDouble (coordinate.longitude);
     mgrs()->setRawValue (QGCGeo::convertGeoToMGRS(QGeoCoordinate(coordinate.latitude, coordinate.longitude)));
-    count()->setRawValue(0);
+    count()->setRawInt(0);
 }
 
 void VehicleGPSFactGroup::_handleHighLatency2(mavlink_message_t& message)
@@ -97,10 +106,10 @@ void VehicleGPSFactGroup::_handleHighLatency2(mavlink_message_t& message)
     mavlink_high_latency2_t highLatency2;
     mavlink_msg_high_latency2_decode(&message, &highLatency2);
 
-    lat()->setRawValue  (highLatency2.latitude * 1e-7);
-    lon()->setRawValue  (highLatency2.longitude * 1e-7);
+    lat()->setRawDouble (highLatency2.latitude * 1e-7);
+    lon()->setRawDouble (highLatency2.longitude * 1e-7);
     mgrs()->setRawValue (QGCGeo::convertGeoToMGRS(QGeoCoordinate(highLatency2.latitude * 1e-7, highLatency2.longitude * 1e-7)));
-    count()->setRawValue(0);
-    hdop()->setRawValue (highLatency2.eph == UINT8_MAX ? qQNaN() : highLatency2.eph / 10.0);
-    vdop()->setRawValue (highLatency2.epv == UINT8_MAX ? qQNaN() : highLatency2.epv / 10.0);
+    count()->setRawInt(0);
+    hdop()->setRawDouble(highLatency2.eph == UINT8_MAX ? qQNaN() : highLatency2.eph / 10.0);
+    vdop()->setRawDouble(highLatency2.epv == UINT8_MAX ? qQNaN() : highLatency2.epv / 10.0);
 }
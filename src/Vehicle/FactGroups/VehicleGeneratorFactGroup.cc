@@ -62,6 +62,13 @@ void VehicleGeneratorFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_me
     }
 }
 
+QList<uint32_t> VehicleGeneratorFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_GENERATOR_STATUS,
+    };
+}
+
 void VehicleGeneratorFactGroup::_handleGeneratorStatus(mavlink_message_t& message)
 {
     mavlink_generator_status_t generator;
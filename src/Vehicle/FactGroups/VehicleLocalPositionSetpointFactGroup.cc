@@ -56,3 +56,10 @@ void VehicleLocalPositionSetpointFactGroup::handleMessage(Vehicle* /* vehicle */
 
     _setTelemetryAvailable(true);
 }
+
+QList<uint32_t> VehicleLocalPositionSetpointFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_POSITION_TARGET_LOCAL_NED,
+    };
+}
@@ -49,6 +49,17 @@ void VehicleTemperatureFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_
     }
 }
 
+QList<uint32_t> VehicleTemperatureFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_SCALED_PRESSURE,
+        MAVLINK_MSG_ID_SCALED_PRESSURE2,
+        MAVLINK_MSG_ID_SCALED_PRESSURE3,
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2,
+    };
+}
+
 void VehicleTemperatureFactGroup::_handleHighLatency(mavlink_message_t& message)
 {
     mavlink_high_latency_t highLatency;
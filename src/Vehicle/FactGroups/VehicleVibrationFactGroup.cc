@@ -50,3 +50,10 @@ void VehicleVibrationFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_me
     _setTelemetryAvailable(true);
 }
 
+QList<uint32_t> VehicleVibrationFactGroup::handledMessageIds() const
+{
+    return {
+        MAVLINK_MSG_ID_VIBRATION,
+    };
+}
+
@@ -50,6 +50,19 @@ void VehicleWindFactGroup::handleMessage(Vehicle* /* vehicle */, mavlink_message
     }
 }
 
+QList<uint32_t> VehicleWindFactGroup::handledMessageIds() const
+{
+    QList<uint32_t> messageIds = {
+        MAVLINK_MSG_ID_WIND_COV,
+        MAVLINK_MSG_ID_HIGH_LATENCY,
+        MAVLINK_MSG_ID_HIGH_LATENCY2,
+    };
+#if !defined(NO_ARDUPILOT_DIALECT)
+    messageIds.append(MAVLINK_MSG_ID_WIND);
+#endif
+    return messageIds;
+}
+
 void VehicleWindFactGroup::_handleHighLatency(mavlink_message_t& message)
 {
     mavlink_high_latency_t highLatency;
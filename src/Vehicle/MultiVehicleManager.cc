@@ -125,6 +125,7 @@ void MultiVehicleManager::_vehicleHeartbeatInfo(LinkInterface* link, int vehicle
     connect(vehicle->parameterManager(),    &ParameterManager::parametersReadyChanged,  this, &MultiVehicleManager::_vehicleParametersReadyChanged);
 
     _vehicles.append(vehicle);
+    _mavlinkProtocol->registerVehicle(vehicle);
 
     // Send QGC heartbeat ASAP, this allows PX4 to start accepting commands
     _sendGCSHeartbeat();
@@ -180,6 +181,7 @@ void MultiVehicleManager::_deleteVehiclePhase1(Vehicle* vehicle)
     qCDebug(MultiVehicleManagerLog) << "_deleteVehiclePhase1" << vehicle;
 
     _vehiclesBeingDeleted << vehicle;
+    _mavlinkProtocol->unregisterVehicle(vehicle);
 
     // Remove from map
     bool found = false;
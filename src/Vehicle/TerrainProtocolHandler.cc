@@ -14,6 +14,13 @@
 #include "QGCToolbox.h"
 #include "MAVLinkProtocol.h"
 #include "QGCLoggingCategory.h"
+#ifndef NO_SERIAL_LINK
+#include "SerialLink.h"
+#endif
+
+#include <QtCore/QtMath>
+
+#include <algorithm>
 
 QGC_LOGGING_CATEGORY(TerrainProtocolHandlerLog, "TerrainProtocolHandlerLog")
 
@@ -23,7 +30,7 @@ TerrainProtocolHandler::TerrainProtocolHandler(Vehicle* vehicle, TerrainFactGrou
     , _terrainFactGroup (terrainFactGroup)
 {
     _terrainDataSendTimer.setSingleShot(false);
-    _terrainDataSendTimer.setInterval(1000.0/12.0);
+    _terrainDataSendTimer.setInterval(1000.0/_sendRateHz);
     connect(&_terrainDataSendTimer, &QTimer::timeout, this, &TerrainProtocolHandler::_sendNextTerrainData);
 }
 
@@ -43,8 +50,26 @@ bool TerrainProtocolHandler::mavlinkMessageReceived(const mavlink_message_t mess
 
 void TerrainProtocolHandler::_handleTerrainRequest(const mavlink_message_t& message)
 {
+    mavlink_terrain_request_t terrainRequest;
+    mavlink_msg_terrain_request_decode(&message, &terrainRequest);
+
+    // The vehicle repeats the request for the same grid until it has every block, keep the heights already looked up
+    const bool sameGrid = (terrainRequest.lat == _currentTerrainRequest.lat) &&
+                          (terrainRequest.lon == _currentTerrainRequest.lon) &&
+                          (terrainRequest.grid_spacing == _currentTerrainRequest.grid_spacing);
+    QGeoCoordinate previousRequestCoord;
+    if (!sameGrid) {
+        if (_currentTerrainRequest.grid_spacing != 0) {
+            previousRequestCoord = QGeoCoordinate(static_cast<double>(_currentTerrainRequest.lat) / 1e7, static_cast<double>(_currentTerrainRequest.lon) / 1e7);
+        }
+        _resolvedMask = 0;
+    }
+
     _terrainRequestActive = true;
-    mavlink_msg_terrain_request_decode(&message, &_currentTerrainRequest);
+    _currentTerrainRequest = terrainRequest;
+    if (!sameGrid) {
+        _prefetchPredictedPath(previousRequestCoord);
+    }
     _sendNextTerrainData();
 }
 
@@ -77,84 +102,195 @@ void TerrainProtocolHandler::_sendNextTerrainData(void)
         return;
     }
 
-    QGeoCoordinate terrainRequestCoordSWCorner(static_cast<double>(_currentTerrainRequest.lat) / 1e7, static_cast<double>(_currentTerrainRequest.lon) / 1e7);
-    int spacingBetweenGrids = _currentTerrainRequest.grid_spacing * 4;
+    if (_currentTerrainRequest.mask & ~_resolvedMask) {
+        _resolveTerrainBlocks();
+    }
 
-    // Each TERRAIN_DATA sent to vehicle contains a 4x4 grid of heights
-    // TERRAIN_REQUEST.mask has a bit for each entry in an 8x7 grid
-    // gridBit = 0 refers to the the sw corner of the 8x7 grid
-
-    bool bitFound = false;
-    for (int rowIndex=0; rowIndex<7; rowIndex++) {
-        for (int colIndex=0; colIndex<8; colIndex++) {
-            uint8_t gridBit = (rowIndex * 8) + colIndex;
-            uint64_t checkBit = 1ull << gridBit;
-            if (_currentTerrainRequest.mask & checkBit) {
-                // Move east and then north to generate the coordinate for sw corner of the specific gridBit
-                QGeoCoordinate swCorner = terrainRequestCoordSWCorner.atDistanceAndAzimuth(spacingBetweenGrids * colIndex, 90);
-                swCorner = swCorner.atDistanceAndAzimuth(spacingBetweenGrids * rowIndex, 0);
-                _sendTerrainData(swCorner, gridBit);
-                bitFound = true;
-                break;
+    SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+    if (sharedLink) {
+        // Bits are only cleared once the block is sent. Blocks still waiting on terrain tiles go out on a later tick.
+        int blocksToSend = _blocksPerTick(sharedLink->linkConfiguration().get());
+        for (uint8_t gridBit=0; (gridBit<_gridBlocks) && (blocksToSend > 0); gridBit++) {
+            if (_currentTerrainRequest.mask & _resolvedMask & (1ull << gridBit)) {
+                _sendTerrainData(sharedLink.get(), gridBit);
+                blocksToSend--;
             }
         }
-        if (bitFound) {
-            break;
-        }
     }
 
-    if (bitFound) {
+    if (_currentTerrainRequest.mask) {
         // Kick timer to send next possible TERRAIN_DATA to vehicle
         _terrainDataSendTimer.start();
     } else {
         _terrainRequestActive = false;
+        _terrainDataSendTimer.stop();
     }
 }
 
-void TerrainProtocolHandler::_sendTerrainData(const QGeoCoordinate& swCorner, uint8_t gridBit)
+/// Looks up the heights for every requested block which doesn't have them yet with a single terrain query. Points whose
+/// terrain tiles are still downloading come back without a height, the blocks which are complete go out right away and
+/// the rest are looked up again on a later tick.
+void TerrainProtocolHandler::_resolveTerrainBlocks(void)
 {
-    QList<QGeoCoordinate> coordinates;
-    for (int rowIndex=0; rowIndex<4; rowIndex++) {
-        for (int colIndex=0; colIndex<4; colIndex++) {
-            // Move east and then north to generate the coordinate for grid point
-            QGeoCoordinate coord = swCorner.atDistanceAndAzimuth(_currentTerrainRequest.grid_spacing * colIndex, 90);
-            coord = coord.atDistanceAndAzimuth(_currentTerrainRequest.grid_spacing * rowIndex, 0);
-            coordinates.append(coord);
-        }
-    }
+    const uint64_t          unresolvedMask =    _currentTerrainRequest.mask & ~_resolvedMask;
+    const QGeoCoordinate    gridSWCorner(static_cast<double>(_currentTerrainRequest.lat) / 1e7, static_cast<double>(_currentTerrainRequest.lon) / 1e7);
+    const QList<QGeoCoordinate> coordinates = _gridCoordinates(gridSWCorner, _currentTerrainRequest.grid_spacing, unresolvedMask);
 
-    // Query terrain system for altitudes. If it has them available it will return them. If not they will be queued for download.
+    // Query terrain system for altitudes. Whatever it doesn't have yet is queued for download.
     bool            error = false;
     QList<double>   altitudes;
-    if (TerrainAtCoordinateQuery::getAltitudesForCoordinates(coordinates, altitudes, error)) {
-        if (error) {
-            qCWarning(TerrainProtocolHandlerLog) << "_sendTerrainData TerrainAtCoordinateQuery::getAltitudesForCoordinates failed";
+    const int waitingPoints = TerrainAtCoordinateQuery::getAvailableAltitudesForCoordinates(coordinates, altitudes, error);
+    if (altitudes.count() != coordinates.count()) {
+        qCWarning(TerrainProtocolHandlerLog) << "_resolveTerrainBlocks unexpected altitude count" << altitudes.count() << coordinates.count();
+        return;
+    }
+
+    // A block only counts as resolved once all of its heights are valid
+    int unresolvedBlocks = 0;
+    const double* blockAltitudes = altitudes.constData();
+    for (int gridBit=0; gridBit<_gridBlocks; gridBit++) {
+        if (!(unresolvedMask & (1ull << gridBit))) {
+            continue;
+        }
+
+        if (std::any_of(blockAltitudes, blockAltitudes + _blockPoints, [](double altitude) { return qIsNaN(altitude); })) {
+            unresolvedBlocks++;
         } else {
-            // Only clear the bit if the query succeeds. Otherwise just let it try again on the next timer tick
-            uint64_t removeBit = ~(1ull << gridBit);
-            _currentTerrainRequest.mask &= removeBit;
-            int altIndex = 0;
-            int16_t terrainData[16];
-            for (const double& altitude : altitudes) {
-                terrainData[altIndex++] = static_cast<int16_t>(altitude);
+            for (int pointIndex=0; pointIndex<_blockPoints; pointIndex++) {
+                _terrainData[gridBit][pointIndex] = static_cast<int16_t>(blockAltitudes[pointIndex]);
             }
+            _resolvedMask |= 1ull << gridBit;
+        }
+        blockAltitudes += _blockPoints;
+    }
+
+    if (waitingPoints) {
+        qCDebug(TerrainProtocolHandlerLog) << "_resolveTerrainBlocks waiting on terrain tiles for" << waitingPoints << "points," << unresolvedBlocks << "blocks unresolved";
+    }
+    if (error && (!_resolveWarningTimer.isValid() || _resolveWarningTimer.hasExpired(_resolveWarningIntervalMSecs))) {
+        qCWarning(TerrainProtocolHandlerLog) << "_resolveTerrainBlocks TerrainAtCoordinateQuery::getAvailableAltitudesForCoordinates failed," << unresolvedBlocks << "blocks unresolved";
+        _resolveWarningTimer.start();
+    }
+}
+
+/// Flat earth offsets from the sw corner, computed once per row and column of the whole grid. Over the few kilometers
+/// the grid covers this is well within a meter of QGeoCoordinate::atDistanceAndAzimuth.
+QList<QGeoCoordinate> TerrainProtocolHandler::_gridCoordinates(const QGeoCoordinate& gridSWCorner, double gridSpacing, uint64_t mask)
+{
+    // Each TERRAIN_DATA sent to vehicle contains a 4x4 grid of heights
+    // TERRAIN_REQUEST.mask has a bit for each entry in an 8x7 grid
+    // gridBit = 0 refers to the sw corner of the 8x7 grid, bits go east and then north
+    static constexpr int    pointRows =         _gridRows * _blockSize;
+    static constexpr int    pointColumns =      _gridColumns * _blockSize;
+    static constexpr double metersPerDegree =   111318.84502145034; // Same scaling ArduPilot uses to offset a location
+
+    const double swLatitude = gridSWCorner.latitude();
+    const double swLongitude = gridSWCorner.longitude();
 
-            SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
-            if (sharedLink) {
-                mavlink_message_t       msg;
-
-                mavlink_msg_terrain_data_pack_chan(
-                            qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
-                            qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
-                            sharedLink->mavlinkChannel(),
-                            &msg,
-                            _currentTerrainRequest.lat,
-                            _currentTerrainRequest.lon,
-                            _currentTerrainRequest.grid_spacing,
-                            gridBit,
-                            terrainData);
-                _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
+    double rowLatitudes[pointRows];
+    double rowDegreesPerMeterEast[pointRows];
+    for (int pointRow=0; pointRow<pointRows; pointRow++) {
+        const double latitudeOffset = (pointRow * gridSpacing) / metersPerDegree;
+        rowLatitudes[pointRow] = swLatitude + latitudeOffset;
+        rowDegreesPerMeterEast[pointRow] = 1.0 / (metersPerDegree * qCos(qDegreesToRadians(swLatitude + (latitudeOffset / 2.0))));
+    }
+    double columnMetersEast[pointColumns];
+    for (int pointColumn=0; pointColumn<pointColumns; pointColumn++) {
+        columnMetersEast[pointColumn] = pointColumn * gridSpacing;
+    }
+
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve(qPopulationCount(mask) * _blockPoints);
+    for (int gridBit=0; gridBit<_gridBlocks; gridBit++) {
+        if (!(mask & (1ull << gridBit))) {
+            continue;
+        }
+        const int firstRow = (gridBit / _gridColumns) * _blockSize;
+        const int firstColumn = (gridBit % _gridColumns) * _blockSize;
+        for (int pointRow=firstRow; pointRow<firstRow + _blockSize; pointRow++) {
+            for (int pointColumn=firstColumn; pointColumn<firstColumn + _blockSize; pointColumn++) {
+                coordinates.append(QGeoCoordinate(rowLatitudes[pointRow], swLongitude + (columnMetersEast[pointColumn] * rowDegreesPerMeterEast[pointRow])));
             }
         }
     }
+
+    return coordinates;
+}
+
+void TerrainProtocolHandler::_sendTerrainData(LinkInterface* link, uint8_t gridBit)
+{
+    _currentTerrainRequest.mask &= ~(1ull << gridBit);
+
+    mavlink_message_t msg;
+    mavlink_msg_terrain_data_pack_chan(
+                qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
+                qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
+                link->mavlinkChannel(),
+                &msg,
+                _currentTerrainRequest.lat,
+                _currentTerrainRequest.lon,
+                _currentTerrainRequest.grid_spacing,
+                gridBit,
+                _terrainData[gridBit]);
+    _vehicle->sendMessageOnLinkThreadSafe(link, msg);
+}
+
+/// @return Number of TERRAIN_DATA messages to send per timer tick without crowding out the rest of the telemetry
+int TerrainProtocolHandler::_blocksPerTick(const LinkConfiguration* linkConfig)
+{
+#ifndef NO_SERIAL_LINK
+    const SerialConfiguration* const serialConfig = qobject_cast<const SerialConfiguration*>(linkConfig);
+    if (serialConfig) {
+        // 10 bits on the wire per byte with start and stop bits
+        static constexpr double messageBytes = MAVLINK_MSG_ID_TERRAIN_DATA_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+        const double bytesPerTick = ((serialConfig->baud() / 10.0) * _serialLinkShare) / _sendRateHz;
+        return qMax(1, static_cast<int>(bytesPerTick / messageBytes));
+    }
+#else
+    Q_UNUSED(linkConfig);
+#endif
+
+    // Network links have plenty of bandwidth for the whole grid at once
+    return _gridBlocks;
+}
+
+/// Queues downloads for the terrain tiles along the vehicle's predicted path, so they are already cached when the
+/// vehicle requests the next grid.
+///     @param previousRequestCoord SW corner of the previous grid, used for the direction of travel without telemetry
+void TerrainProtocolHandler::_prefetchPredictedPath(const QGeoCoordinate& previousRequestCoord)
+{
+    const QGeoCoordinate requestCoord(static_cast<double>(_currentTerrainRequest.lat) / 1e7, static_cast<double>(_currentTerrainRequest.lon) / 1e7);
+    QGeoCoordinate startCoord = _vehicle->coordinate();
+    if (!startCoord.isValid()) {
+        startCoord = requestCoord;
+    }
+
+    FactGroup* vehicleFactGroup = _vehicle->vehicleFactGroup();
+    const Fact* headingFact = vehicleFactGroup->getFact(QStringLiteral("heading"));
+    const Fact* groundSpeedFact = vehicleFactGroup->getFact(QStringLiteral("groundSpeed"));
+    double heading = headingFact ? headingFact->rawValue().toDouble() : qQNaN();
+    double groundSpeed = groundSpeedFact ? groundSpeedFact->rawValue().toDouble() : qQNaN();
+    if (qIsNaN(groundSpeed)) {
+        groundSpeed = 0;
+    }
+    if (qIsNaN(heading) || (groundSpeed < 1.0)) {
+        // No usable telemetry, follow the direction the requested grids are moving in
+        if (!previousRequestCoord.isValid() || (previousRequestCoord.distanceTo(requestCoord) < 1.0)) {
+            return;
+        }
+        heading = previousRequestCoord.azimuthTo(requestCoord);
+    }
+
+    const double prefetchDistance = qMax(groundSpeed * _prefetchSeconds, _prefetchMinDistance);
+    QList<QGeoCoordinate> coordinates;
+    for (double distance=0; distance<=prefetchDistance; distance+=_prefetchPointSpacing) {
+        coordinates.append(startCoord.atDistanceAndAzimuth(distance, heading));
+    }
+
+    // The heights aren't needed yet, this only queues the missing tiles for download
+    bool            error = false;
+    QList<double>   altitudes;
+    if (!TerrainAtCoordinateQuery::getAltitudesForCoordinates(coordinates, altitudes, error)) {
+        qCDebug(TerrainProtocolHandlerLog) << "_prefetchPredictedPath queued terrain tiles along" << prefetchDistance << "meters at heading" << heading;
+    }
 }
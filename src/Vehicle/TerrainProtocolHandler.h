@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
@@ -16,6 +17,8 @@
 
 #include "QGCMAVLink.h"
 
+class LinkConfiguration;
+class LinkInterface;
 class TerrainFactGroup;
 class Vehicle;
 
@@ -35,13 +38,38 @@ private slots:
     void _sendNextTerrainData(void);
 
 private:
+    friend class TerrainProtocolHandlerTest; // Unit test
+
     void _handleTerrainRequest  (const mavlink_message_t& message);
     void _handleTerrainReport   (const mavlink_message_t& message);
-    void _sendTerrainData       (const QGeoCoordinate& swCorner, uint8_t gridBit);
+    void _resolveTerrainBlocks  (void);
+    void _sendTerrainData       (LinkInterface* link, uint8_t gridBit);
+    void _prefetchPredictedPath (const QGeoCoordinate& previousRequestCoord);
+
+    /// @return The points of every block in @a mask in gridBit order, 16 per block with rows south to north and each row west to east
+    static QList<QGeoCoordinate> _gridCoordinates(const QGeoCoordinate& gridSWCorner, double gridSpacing, uint64_t mask);
+    static int _blocksPerTick(const LinkConfiguration* linkConfig);
+
+    // TERRAIN_REQUEST.mask has a bit for each 4x4 block in an 8x7 grid of blocks
+    static constexpr int _gridColumns =     8;
+    static constexpr int _gridRows =        7;
+    static constexpr int _gridBlocks =      _gridColumns * _gridRows;
+    static constexpr int _blockSize =       4;
+    static constexpr int _blockPoints =     _blockSize * _blockSize;
+
+    static constexpr int    _sendRateHz =               12;
+    static constexpr double _serialLinkShare =          0.25;   ///< Fraction of a serial link's bandwidth used for TERRAIN_DATA
+    static constexpr double _prefetchSeconds =          60;     ///< How far ahead along the vehicle's path terrain tiles are prefetched
+    static constexpr double _prefetchMinDistance =      2000;   ///< Minimum prefetch distance in meters, for slow or hovering vehicles
+    static constexpr double _prefetchPointSpacing =     500;    ///< Meters between prefetch points, well under the terrain tile size
+    static constexpr int    _resolveWarningIntervalMSecs = 5000;
 
     Vehicle*                    _vehicle;
     TerrainFactGroup*           _terrainFactGroup;
     bool                        _terrainRequestActive =             false;
-    mavlink_terrain_request_t   _currentTerrainRequest;
+    mavlink_terrain_request_t   _currentTerrainRequest =            {};
+    uint64_t                    _resolvedMask =                     0;      ///< Blocks of the current grid which have heights in _terrainData
+    int16_t                     _terrainData[_gridBlocks][_blockPoints];
+    QElapsedTimer               _resolveWarningTimer;                       ///< Limits the failed lookup warning while the vehicle keeps asking
     QTimer                      _terrainDataSendTimer;
 };
@@ -122,7 +122,6 @@ Vehicle::Vehicle(LinkInterface*             link,
     _mavlink = _toolbox->mavlinkProtocol();
     qCDebug(VehicleLog) << "Link started with Mavlink " << (_mavlink->getCurrentVersion() >= 200 ? "V2" : "V1");
 
-    connect(_mavlink, &MAVLinkProtocol::messageReceived,        this, &Vehicle::_mavlinkMessageReceived);
     connect(_mavlink, &MAVLinkProtocol::mavlinkMessageStatus,   this, &Vehicle::_mavlinkMessageStatus);
 
     connect(this, &Vehicle::flightModeChanged,          this, &Vehicle::_handleFlightModeChanged);
@@ -176,8 +175,16 @@ Vehicle::Vehicle(LinkInterface*             link,
     }
 
     _firmwarePlugin->initializeVehicle(this);
+    // Meta data is shared between vehicles, adjustments are only made once per firmware plugin and vehicle type
+    const QString metaDataVariant = QStringLiteral("%1:%2").arg(_firmwarePlugin->metaObject()->className()).arg(vehicleType);
     for(auto& factName: factNames()) {
-        _firmwarePlugin->adjustMetaData(vehicleType, getFact(factName)->metaData());
+        Fact* fact = getFact(factName);
+        FactMetaData* metaData = FactMetaData::sharedVariant(fact->metaData(), metaDataVariant, [this, vehicleType](FactMetaData* variantMetaData) {
+            _firmwarePlugin->adjustMetaData(vehicleType, variantMetaData);
+        });
+        if (metaData != fact->metaData()) {
+            fact->setMetaData(metaData);
+        }
     }
 
     _sendMultipleTimer.start(_sendMessageMultipleIntraMessageDelay);
@@ -356,6 +363,9 @@ void Vehicle::_commonInit()
         }
     }
 
+    _updateMessageHandlers();
+    connect(this, &FactGroup::factGroupNamesChanged, this, &Vehicle::_updateMessageHandlers);
+
     _flightDistanceFact.setRawValue(0);
     _flightTimeFact.setRawValue(0);
     _flightTimeUpdater.setInterval(1000);
@@ -478,6 +488,7 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
         qCDebug(VehicleLog) << "_mavlinkMessageReceived Link already running Mavlink v2. Setting _maxProtoVersion" << _maxProtoVersion;
     }
 
+    // MAVLinkProtocol only routes our own sysid, broadcasts and RADIO_STATUS to us
     if (message.sysid != _id && message.sysid != 0) {
         // We allow RADIO_STATUS messages which come from a link the vehicle is using to pass through and be handled
         if (!(message.msgid == MAVLINK_MSG_ID_RADIO_STATUS && _vehicleLinkManager->containsLink(link))) {
@@ -524,25 +535,41 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
         return;
     }
 
-    if (!_terrainProtocolHandler->mavlinkMessageReceived(message)) {
+    // Copied since handlers can add fact groups, which rebuilds the table
+    MessageHandlers handlers = _messageHandlers.value(message.msgid);
+
+    if (handlers.terrainProtocol && !_terrainProtocolHandler->mavlinkMessageReceived(message)) {
         return;
     }
-    _ftpManager->_mavlinkMessageReceived(message);
-    _parameterManager->mavlinkMessageReceived(message);
-    (void) QMetaObject::invokeMethod(_imageProtocolManager, "mavlinkMessageReceived", Qt::AutoConnection, message);
-    _remoteIDManager->mavlinkMessageReceived(message);
+    if (handlers.ftp) {
+        _ftpManager->_mavlinkMessageReceived(message);
+    }
+    if (handlers.parameter) {
+        _parameterManager->mavlinkMessageReceived(message);
+    }
+    if (handlers.imageProtocol) {
+        (void) QMetaObject::invokeMethod(_imageProtocolManager, "mavlinkMessageReceived", Qt::AutoConnection, message);
+    }
+    if (handlers.remoteID) {
+        _remoteIDManager->mavlinkMessageReceived(message);
+    }
 
     _waitForMavlinkMessageMessageReceivedHandler(message);
 
-    // Battery fact groups are created dynamically as new batteries are discovered
-    VehicleBatteryFactGroup::handleMessageForFactGroupCreation(this, message);
+    if (handlers.batteryCreation) {
+        // Battery fact groups are created dynamically as new batteries are discovered
+        VehicleBatteryFactGroup::handleMessageForFactGroupCreation(this, message);
+        handlers = _messageHandlers.value(message.msgid);
+    }
 
-    // Let the fact groups take a whack at the mavlink traffic
-    for (FactGroup* factGroup : factGroups()) {
+    // Let the fact groups, including our own, take a whack at the mavlink traffic they are interested in
+    const QList<FactGroup*> allMessageFactGroups = _allMessageFactGroups;
+    for (FactGroup* factGroup : allMessageFactGroups) {
+        factGroup->handleMessage(this, message);
+    }
+    for (FactGroup* factGroup : handlers.factGroups) {
         factGroup->handleMessage(this, message);
     }
-
-    this->handleMessage(this, message);
 
     switch (message.msgid) {
     case MAVLINK_MSG_ID_HOME_POSITION:
@@ -2771,6 +2798,37 @@ void Vehicle::_removeRequestMessageInfo(int compId, int msgId)
 }
 
 
+void Vehicle::_updateMessageHandlers()
+{
+    _messageHandlers.clear();
+    _allMessageFactGroups.clear();
+
+    // Message ids the managers called from _mavlinkMessageReceived act on
+    _messageHandlers[MAVLINK_MSG_ID_TERRAIN_REQUEST].terrainProtocol = true;
+    _messageHandlers[MAVLINK_MSG_ID_TERRAIN_REPORT].terrainProtocol = true;
+    _messageHandlers[MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL].ftp = true;
+    _messageHandlers[MAVLINK_MSG_ID_PARAM_VALUE].parameter = true;
+    _messageHandlers[MAVLINK_MSG_ID_DATA_TRANSMISSION_HANDSHAKE].imageProtocol = true;
+    _messageHandlers[MAVLINK_MSG_ID_ENCAPSULATED_DATA].imageProtocol = true;
+    _messageHandlers[MAVLINK_MSG_ID_OPEN_DRONE_ID_ARM_STATUS].remoteID = true;
+    _messageHandlers[MAVLINK_MSG_ID_BATTERY_STATUS].batteryCreation = true;
+    _messageHandlers[MAVLINK_MSG_ID_HIGH_LATENCY].batteryCreation = true;
+    _messageHandlers[MAVLINK_MSG_ID_HIGH_LATENCY2].batteryCreation = true;
+
+    QList<FactGroup*> factGroupList = factGroups().values();
+    factGroupList.append(this);
+    for (FactGroup* factGroup : factGroupList) {
+        const QList<uint32_t> messageIds = factGroup->handledMessageIds();
+        if (messageIds.contains(FactGroup::allMessageIds)) {
+            _allMessageFactGroups.append(factGroup);
+            continue;
+        }
+        for (const uint32_t messageId : messageIds) {
+            _messageHandlers[messageId].factGroups.append(factGroup);
+        }
+    }
+}
+
 void Vehicle::_waitForMavlinkMessageMessageReceivedHandler(const mavlink_message_t& message)
 {
     if (_requestMessageInfoMap.contains(message.compid) && _requestMessageInfoMap[message.compid].contains(message.msgid)) {
@@ -15,6 +15,7 @@
 #include <QtCore/QTime>
 #include <QtCore/QTimer>
 #include <QtCore/QVariantList>
+#include <QtCore/QVarLengthArray>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtCore/QFile>
 
@@ -107,11 +108,13 @@ class Vehicle : public VehicleFactGroup
     Q_MOC_INCLUDE("QGCCameraManager.h")
 
     friend class InitialConnectStateMachine;
+    friend class MAVLinkProtocol;                   // Routes messages for our system id to _mavlinkMessageReceived
     friend class VehicleLinkManager;
     friend class VehicleBatteryFactGroup;           // Allow VehicleBatteryFactGroup to call _addFactGroup
     friend class SendMavCommandWithSignallingTest;  // Unit test
     friend class SendMavCommandWithHandlerTest;     // Unit test
     friend class RequestMessageTest;                // Unit test
+    friend class VehicleMessageDispatchTest;        // Unit test
     friend class GimbalController;                  // Allow GimbalController to call _addFactGroup
 
 public:
@@ -1270,6 +1273,23 @@ private:
 
     TerrainProtocolHandler* _terrainProtocolHandler = nullptr;
 
+    /// Who in _mavlinkMessageReceived consumes a given message id, so the rest never sees it
+    struct MessageHandlers {
+        bool                            terrainProtocol = false;
+        bool                            ftp             = false;
+        bool                            parameter       = false;
+        bool                            imageProtocol   = false;
+        bool                            remoteID        = false;
+        bool                            batteryCreation = false;
+        QVarLengthArray<FactGroup*, 4>  factGroups;     ///< Includes the vehicle itself
+    };
+
+    /// Rebuilds _messageHandlers from the fact groups' handledMessageIds. Called whenever a fact group is added.
+    void _updateMessageHandlers();
+
+    QHash<uint32_t, MessageHandlers>    _messageHandlers;
+    QList<FactGroup*>                   _allMessageFactGroups;  ///< Groups which don't declare their message ids
+
     MissionManager*                 _missionManager             = nullptr;
     GeoFenceManager*                _geoFenceManager            = nullptr;
     RallyPointManager*              _rallyPointManager          = nullptr;
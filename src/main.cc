@@ -9,6 +9,7 @@
 
 #include <QtCore/QProcessEnvironment>
 #include <QtCore/QtPlugin>
+#include <QtCore/QTextStream>
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QMessageBox>
 #include <QtQuick/QQuickWindow>
@@ -16,6 +17,9 @@
 #include "QGCApplication.h"
 #include "QGC.h"
 #include "AppMessages.h"
+#include "CmdLineOptParser.h"
+#include "LogReplayDrain.h"
+#include "ParameterSnapshot.h"
 
 #ifndef __mobile__
     #include "RunGuard.h"
@@ -27,8 +31,6 @@
 
 #ifdef QT_DEBUG
 
-#include "CmdLineOptParser.h"
-
 #ifdef UNITTEST_BUILD
 #include "UnitTestList.h"
 #endif
@@ -63,7 +65,9 @@ void sigHandler(int s)
 {
     std::signal(s, SIG_DFL);
     if(qgcApp()) {
-        qgcApp()->mainRootWindow()->close();
+        if (qgcApp()->mainRootWindow()) {
+            qgcApp()->mainRootWindow()->close();
+        }
         QEvent event{QEvent::Quit};
         qgcApp()->event(&event);
     }
@@ -195,7 +199,46 @@ int main(int argc, char *argv[])
 #endif // Q_OS_WIN
 #endif // QT_DEBUG
 
-    QGCApplication app(argc, argv, runUnitTests);
+    // Headless comparison of parameter files against a golden set, see ParameterSnapshot::compareFiles
+    bool paramGolden = false;
+    bool paramDiff = false;
+    QString paramGoldenFile;
+    QString paramDiffPath;
+    CmdLineOpt_t rgParamDiffCmdLineOptions[] = {
+        { "--param-golden",     &paramGolden,   &paramGoldenFile },     // Parameter file to compare against
+        { "--param-diff",       &paramDiff,     &paramDiffPath },       // Parameter file or directory of parameter files
+    };
+
+    ParseCmdLineOptions(argc, argv, rgParamDiffCmdLineOptions, sizeof(rgParamDiffCmdLineOptions)/sizeof(rgParamDiffCmdLineOptions[0]), false);
+    if (paramGolden && paramDiff) {
+        // Only reads files, no application or display needed
+        QTextStream output(stdout);
+        return ParameterSnapshot::compareFiles(paramGoldenFile, paramDiffPath, output);
+    }
+
+    // Headless batch replay of telemetry logs, see LogReplayDrain
+    bool replayDrain = false;
+    bool replayOutput = false;
+    bool replayFacts = false;
+    bool replayRate = false;
+    QString replayDrainPath;
+    QString replayOutputDir;
+    QString replayFactList;
+    QString replayRateHz;
+    CmdLineOpt_t rgReplayCmdLineOptions[] = {
+        { "--replay-drain",     &replayDrain,   &replayDrainPath },     // Log file or directory of logs
+        { "--replay-output",    &replayOutput,  &replayOutputDir },     // Directory for the CSV files
+        { "--replay-facts",     &replayFacts,   &replayFactList },      // Comma separated, for example: altitudeRelative,gps.lat,gps.lon
+        { "--replay-rate",      &replayRate,    &replayRateHz },        // Samples per second of log time
+    };
+
+    ParseCmdLineOptions(argc, argv, rgReplayCmdLineOptions, sizeof(rgReplayCmdLineOptions)/sizeof(rgReplayCmdLineOptions[0]), false);
+    if (replayDrain && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        // Nothing is displayed, so don't require a display. That lets this run on a build server.
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGCApplication app(argc, argv, runUnitTests, replayDrain);
 
     #ifdef Q_OS_LINUX
         std::signal(SIGINT, sigHandler);
@@ -211,7 +254,18 @@ int main(int argc, char *argv[])
         exitCode = runTests(stressUnitTests, unitTestOptions);
     } else
 #endif
-    {
+    if (replayDrain) {
+        const QStringList logFiles = LogReplayDrain::logFiles(replayDrainPath);
+        if (logFiles.isEmpty()) {
+            qWarning() << "No telemetry logs found at" << replayDrainPath;
+            exitCode = -1;
+        } else {
+            LogReplayDrain drain(logFiles, replayOutputDir, replayFactList.split(QLatin1Char(','), Qt::SkipEmptyParts), replayRateHz.toDouble());
+            QObject::connect(&drain, &LogReplayDrain::finished, &app, &QCoreApplication::exit);
+            drain.start();
+            exitCode = app.exec();
+        }
+    } else {
         #ifdef Q_OS_ANDROID
             AndroidInterface::checkStoragePermissions();
         #endif
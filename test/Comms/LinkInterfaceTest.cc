@@ -0,0 +1,133 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkInterfaceTest.h"
+#include "LinkInterface.h"
+#include "MockLink.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QTest>
+
+namespace {
+
+/// Link which records the writes it is handed instead of sending them anywhere. It lives on the main thread like
+/// the serial and TCP links, so queued flushes run from the test's event loop.
+class WriteRecordingLink : public LinkInterface
+{
+public:
+    WriteRecordingLink(SharedLinkConfigurationPtr& config, qsizetype maxCoalescedWriteSize)
+        : LinkInterface(config)
+        , _maxWriteSize(maxCoalescedWriteSize)
+    {}
+
+    void disconnect() override {}
+    bool isConnected() const override { return true; }
+
+    QList<QByteArray> writes;
+
+protected:
+    qsizetype _maxCoalescedWriteSize() const override { return _maxWriteSize; }
+
+private:
+    void _writeBytes(const QByteArray& bytes) override { writes.append(bytes); }
+    bool _connect() override { return true; }
+
+    const qsizetype _maxWriteSize;
+};
+
+QByteArray packet(int index, int length)
+{
+    return QByteArray(length, static_cast<char>('a' + index));
+}
+
+} // namespace
+
+void LinkInterfaceTest::_testCoalescedWrites()
+{
+    SharedLinkConfigurationPtr config = std::make_shared<MockConfiguration>(QStringLiteral("LinkInterfaceTest"));
+    WriteRecordingLink link(config, 1024);
+
+    // Everything queued before the link's thread gets to run goes out as a single write
+    QByteArray expected;
+    for (int i = 0; i < 5; i++) {
+        link.writeBytesThreadSafe(packet(i, 20));
+        expected.append(packet(i, 20));
+    }
+    QVERIFY(link.writes.isEmpty());
+
+    QTRY_COMPARE(link.writes.count(), 1);
+    QCOMPARE(link.writes.first(), expected);
+
+    // Without a latency nothing is held back once the queue is flushed
+    link.writeBytesThreadSafe(packet(5, 20));
+    QTRY_COMPARE(link.writes.count(), 2);
+    QCOMPARE(link.writes.last(), packet(5, 20));
+}
+
+void LinkInterfaceTest::_testMaxCoalescedWriteSize()
+{
+    SharedLinkConfigurationPtr config = std::make_shared<MockConfiguration>(QStringLiteral("LinkInterfaceTest"));
+    WriteRecordingLink link(config, 100);
+
+    // Packets are never split, a packet which doesn't fit starts the next write
+    for (int i = 0; i < 5; i++) {
+        link.writeBytesThreadSafe(packet(i, 40));
+    }
+    // A packet bigger than the maximum still goes out as is
+    link.writeBytesThreadSafe(packet(5, 150));
+
+    QTRY_COMPARE(link.writes.count(), 4);
+    QCOMPARE(link.writes[0], packet(0, 40) + packet(1, 40));
+    QCOMPARE(link.writes[1], packet(2, 40) + packet(3, 40));
+    QCOMPARE(link.writes[2], packet(4, 40));
+    QCOMPARE(link.writes[3], packet(5, 150));
+}
+
+void LinkInterfaceTest::_testWriteLatency()
+{
+    SharedLinkConfigurationPtr config = std::make_shared<MockConfiguration>(QStringLiteral("LinkInterfaceTest"));
+    WriteRecordingLink link(config, 1024);
+
+    static constexpr int latencyMSecs = 200;
+    link.setWriteLatencyMSecs(latencyMSecs);
+    QCOMPARE(link.writeLatencyMSecs(), latencyMSecs);
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    link.writeBytesThreadSafe(packet(0, 20));
+
+    // Packets which arrive inside the latency window join the first one
+    QTest::qWait(latencyMSecs / 4);
+    QVERIFY(link.writes.isEmpty());
+    link.writeBytesThreadSafe(packet(1, 20));
+
+    QTRY_COMPARE_WITH_TIMEOUT(link.writes.count(), 1, latencyMSecs * 10);
+    QVERIFY(elapsed.elapsed() >= latencyMSecs - 10);
+    QCOMPARE(link.writes.first(), packet(0, 20) + packet(1, 20));
+}
+
+void LinkInterfaceTest::_testFullWriteSkipsLatency()
+{
+    SharedLinkConfigurationPtr config = std::make_shared<MockConfiguration>(QStringLiteral("LinkInterfaceTest"));
+    WriteRecordingLink link(config, 100);
+
+    // Once a full write is waiting it goes out right away instead of sitting out the latency window
+    static constexpr int latencyMSecs = 5000;
+    link.setWriteLatencyMSecs(latencyMSecs);
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    link.writeBytesThreadSafe(packet(0, 60));
+    link.writeBytesThreadSafe(packet(1, 60));
+
+    QTRY_COMPARE_WITH_TIMEOUT(link.writes.count(), 2, latencyMSecs / 2);
+    QVERIFY(elapsed.elapsed() < latencyMSecs);
+    QCOMPARE(link.writes[0], packet(0, 60));
+    QCOMPARE(link.writes[1], packet(1, 60));
+}
@@ -0,0 +1,171 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogReplayLinkTest.h"
+#include "LogReplayLink.h"
+#include "LinkManager.h"
+#include "QGCApplication.h"
+#include "TLogIndex.h"
+#include "MAVLinkLib.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+void LogReplayLinkTest::_writeLog(const QString& fileName, int messageCount, quint64 intervalUSecs, bool insertGarbage, QByteArray& frames)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+
+    frames.clear();
+    for (int i = 0; i < messageCount; i++) {
+        if (insertGarbage && (i == messageCount / 2)) {
+            const QByteArray garbage(1000, static_cast<char>(MAVLINK_STX));
+            (void) file.write(garbage);
+        }
+
+        const quint64 timeUSecs = _startTimeUSecs + (i * intervalUSecs);
+        mavlink_message_t message;
+        // time_boot_ms is never zero, so the payload isn't truncated and all frames are the same length
+        (void) mavlink_msg_system_time_pack_chan(_logSysId, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, timeUSecs, i + 1);
+
+        uchar timestamp[TLogIndex::cbTimestamp];
+        qToBigEndian(timeUSecs, timestamp);
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t length = mavlink_msg_to_send_buffer(buffer, &message);
+        (void) file.write(reinterpret_cast<const char*>(timestamp), sizeof(timestamp));
+        (void) file.write(reinterpret_cast<const char*>(buffer), length);
+        frames.append(reinterpret_cast<const char*>(buffer), length);
+    }
+}
+
+void LogReplayLinkTest::_testChunkedPlayback()
+{
+    // One second of log which is larger than the link's 1MB read block, with garbage to resync over
+    static constexpr int messageCount = 40000;
+    static constexpr quint64 intervalUSecs = 25;
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath(QStringLiteral("chunked.tlog"));
+    QByteArray frames;
+    _writeLog(fileName, messageCount, intervalUSecs, true, frames);
+    QVERIFY(QFile(fileName).size() > (1024 * 1024));
+
+    LogReplayLinkConfiguration* const linkConfig = new LogReplayLinkConfiguration(QStringLiteral("LogReplayLinkTest"));
+    linkConfig->setLogFilename(fileName);
+    linkConfig->setDynamic(true);
+    LinkManager* const linkManager = qgcApp()->toolbox()->linkManager();
+    SharedLinkConfigurationPtr sharedConfig = linkManager->addConfiguration(linkConfig);
+
+    // Playback starts as soon as the link connects, so hook up to the link before it is connected
+    QList<QByteArray> chunks;
+    const QMetaObject::Connection linkChangedConnection = connect(linkConfig, &LinkConfiguration::linkChanged, this, [this, linkConfig, &chunks]() {
+        if (linkConfig->link()) {
+            (void) connect(linkConfig->link(), &LinkInterface::bytesReceived, this, [&chunks](LinkInterface*, const QByteArray& bytes) {
+                chunks.append(bytes);
+            });
+        }
+    });
+    QVERIFY(linkManager->createConnectedLink(sharedConfig));
+    LogReplayLink* const link = qobject_cast<LogReplayLink*>(sharedConfig->link());
+    QVERIFY(link);
+    QSignalSpy spyAtEnd(link, &LogReplayLink::playbackAtEnd);
+
+    QVERIFY(spyAtEnd.wait(10000));
+    // Chunks are delivered to us through a queued connection, let the last ones arrive
+    QTRY_COMPARE(chunks.join().size(), frames.size());
+
+    // Every frame arrives exactly once and in order, without the timestamps or the garbage
+    QCOMPARE(chunks.join(), frames);
+
+    // Due messages go out together, one chunk per tick instead of one per message
+    QVERIFY(chunks.count() < (messageCount / 10));
+    for (const QByteArray& chunk: chunks) {
+        QVERIFY(chunk.size() <= ((64 * 1024) + MAVLINK_MAX_PACKET_LEN));
+    }
+
+    (void) disconnect(linkChangedConnection);
+    (void) disconnect(link, nullptr, this, nullptr);
+    linkManager->removeConfiguration(linkConfig);
+}
+
+void LogReplayLinkTest::_testDrain()
+{
+    // Two seconds of log at 1ms per message, delivered in 100ms slices
+    static constexpr int messageCount = 2000;
+    static constexpr quint64 intervalUSecs = 1000;
+    static constexpr quint64 sliceUSecs = 100000;
+    static constexpr int messagesPerSlice = static_cast<int>(sliceUSecs / intervalUSecs);
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath(QStringLiteral("drain.tlog"));
+    QByteArray frames;
+    _writeLog(fileName, messageCount, intervalUSecs, false, frames);
+    const qsizetype frameLength = frames.size() / messageCount;
+
+    LogReplayLinkConfiguration* const linkConfig = new LogReplayLinkConfiguration(QStringLiteral("LogReplayLinkTest"));
+    linkConfig->setLogFilename(fileName);
+    linkConfig->setDynamic(true);
+    linkConfig->setDrain(true);
+    linkConfig->setDrainSliceUSecs(sliceUSecs);
+    LinkManager* const linkManager = qgcApp()->toolbox()->linkManager();
+    SharedLinkConfigurationPtr sharedConfig = linkManager->addConfiguration(linkConfig);
+    QVERIFY(linkManager->createConnectedLink(sharedConfig));
+    LogReplayLink* const link = qobject_cast<LogReplayLink*>(sharedConfig->link());
+    QVERIFY(link);
+
+    struct Slice {
+        quint64     logTimeUSecs;
+        qsizetype   bytesReceived;  ///< Total bytes received when the slice completed
+    };
+    QByteArray received;
+    QList<Slice> slices;
+    bool autoProcess = false;
+    (void) connect(link, &LogReplayLink::bytesReceived, this, [&received](LinkInterface*, const QByteArray& bytes) {
+        received.append(bytes);
+    });
+    (void) connect(link, &LogReplayLink::drainSliceComplete, this, [link, &received, &slices, &autoProcess](quint64 logTimeUSecs) {
+        slices.append({ logTimeUSecs, received.size() });
+        if (autoProcess) {
+            link->drainSliceProcessed();
+        }
+    });
+    QSignalSpy spyAtEnd(link, &LogReplayLink::playbackAtEnd);
+
+    // Drain mode waits to be told to play
+    QTest::qWait(200);
+    QVERIFY(received.isEmpty());
+    link->play();
+
+    // Without the slices being processed the link stops once a few are outstanding
+    QTRY_VERIFY(slices.count() > 0);
+    QTest::qWait(200);
+    const int slicesInFlight = static_cast<int>(slices.count());
+    QVERIFY(slicesInFlight < (messageCount / messagesPerSlice));
+    QVERIFY(spyAtEnd.isEmpty());
+
+    autoProcess = true;
+    for (int i = 0; i < slicesInFlight; i++) {
+        link->drainSliceProcessed();
+    }
+    QVERIFY(spyAtEnd.wait(10000));
+    QTRY_COMPARE(received.size(), frames.size());
+    QCOMPARE(received, frames);
+    QCOMPARE(slices.count(), messageCount / messagesPerSlice);
+
+    // Each slice covers one slice interval of log time, and everything up to it was delivered before it completed
+    for (int i = 0; i < slices.count(); i++) {
+        const quint64 expectedTimeUSecs = _startTimeUSecs + ((((i + 1) * messagesPerSlice) - 1) * intervalUSecs);
+        QCOMPARE(slices[i].logTimeUSecs, expectedTimeUSecs);
+        QCOMPARE(slices[i].bytesReceived, (i + 1) * messagesPerSlice * frameLength);
+    }
+
+    (void) disconnect(link, nullptr, this, nullptr);
+    linkManager->removeConfiguration(linkConfig);
+}
@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class LogReplayLinkTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testChunkedPlayback();
+    void _testDrain();
+
+private:
+    /// Writes a log of SYSTEM_TIME messages, which don't bring up a vehicle
+    ///     @param frames[out] The MAVLink frames in the log, without timestamps or garbage
+    void _writeLog(const QString& fileName, int messageCount, quint64 intervalUSecs, bool insertGarbage, QByteArray& frames);
+
+    static constexpr quint64 _startTimeUSecs = 1700000000000000ULL;
+    static constexpr uint8_t _logSysId = 201;
+};
@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkForwardRouteTest.h"
+#include "MAVLinkForwardRoute.h"
+
+#include <QtTest/QTest>
+
+static mavlink_message_t _heartbeat(uint8_t sysid)
+{
+    const mavlink_heartbeat_t heartbeat{};
+    mavlink_message_t message;
+    (void) mavlink_msg_heartbeat_encode_chan(sysid, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, &heartbeat);
+    return message;
+}
+
+void MAVLinkForwardRouteTest::_testNoFilter()
+{
+    const MAVLinkForwardRoute route;
+    QVERIFY(route.accepts(_heartbeat(1)));
+    QVERIFY(route.accepts(_heartbeat(255)));
+
+    // Signing setup is never forwarded
+    mavlink_message_t message = _heartbeat(1);
+    message.msgid = MAVLINK_MSG_ID_SETUP_SIGNING;
+    QVERIFY(!route.accepts(message));
+}
+
+void MAVLinkForwardRouteTest::_testSysIdFilter()
+{
+    MAVLinkForwardRoute route;
+    QVERIFY(route.setSysIdFilter(QStringLiteral("1, 10-12")));
+    QVERIFY(route.accepts(_heartbeat(1)));
+    QVERIFY(!route.accepts(_heartbeat(2)));
+    QVERIFY(route.accepts(_heartbeat(10)));
+    QVERIFY(route.accepts(_heartbeat(12)));
+    QVERIFY(!route.accepts(_heartbeat(13)));
+
+    QVERIFY(route.setSysIdFilter(QString()));
+    QVERIFY(route.accepts(_heartbeat(2)));
+}
+
+void MAVLinkForwardRouteTest::_testMsgIdFilter()
+{
+    MAVLinkForwardRoute route;
+    QVERIFY(route.setMsgIdFilter(QStringLiteral("30-33")));
+    QVERIFY(!route.accepts(_heartbeat(1)));
+
+    mavlink_message_t message = _heartbeat(1);
+    message.msgid = MAVLINK_MSG_ID_ATTITUDE;
+    QVERIFY(route.accepts(message));
+}
+
+void MAVLinkForwardRouteTest::_testInvalidFilter()
+{
+    MAVLinkForwardRoute route;
+    QVERIFY(route.setSysIdFilter(QStringLiteral("5")));
+    QVERIFY(!route.setSysIdFilter(QStringLiteral("256")));
+    QVERIFY(!route.setSysIdFilter(QStringLiteral("abc")));
+    QVERIFY(!route.setSysIdFilter(QStringLiteral("10-1")));
+    QVERIFY(!route.setSysIdFilter(QStringLiteral("1-2-3")));
+    QVERIFY(!route.setMsgIdFilter(QStringLiteral("0-16777215")));
+
+    // Failed updates leave the previous filter in place
+    QVERIFY(route.accepts(_heartbeat(5)));
+    QVERIFY(!route.accepts(_heartbeat(6)));
+}
+
+void MAVLinkForwardRouteTest::_testFrameLength()
+{
+    const mavlink_message_t message = _heartbeat(1);
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t length = mavlink_msg_to_send_buffer(buffer, &message);
+    QCOMPARE(MAVLinkForwardRoute::frameLength(message), static_cast<int>(length));
+}
@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkParserTest.h"
+#include "MAVLinkParser.h"
+#include "MAVLinkProtocol.h"
+#include "MockLink.h"
+#include "QGCApplication.h"
+
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+void MAVLinkParserTest::_testParserThread()
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    // Parsers run on a worker thread of their own, not on the main thread and not on the link's thread
+    MAVLinkParser* const parser = _mockLink->mavlinkParser();
+    QVERIFY(parser);
+    QVERIFY(parser->thread() != QThread::currentThread());
+    QVERIFY(parser->thread() != _mockLink->thread());
+    QVERIFY(parser->thread()->isRunning());
+
+    _disconnectMockLink();
+}
+
+void MAVLinkParserTest::_testMessagesOnMainThread()
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    static constexpr uint8_t testSysId = 201;
+    static constexpr int messageCount = 3;
+
+    QThread* receiveThread = nullptr;
+    QList<mavlink_message_t> received;
+    MAVLinkProtocol* const protocol = qgcApp()->toolbox()->mavlinkProtocol();
+    const QMetaObject::Connection connection = connect(protocol, &MAVLinkProtocol::messagesReceived, this,
+        [this, &receiveThread, &received](LinkInterface* link, const QList<mavlink_message_t>& messages) {
+            if (link != _mockLink) {
+                return;
+            }
+            for (const mavlink_message_t& message : messages) {
+                if (message.sysid == testSysId) {
+                    receiveThread = QThread::currentThread();
+                    received.append(message);
+                }
+            }
+        });
+
+    QByteArray bytes;
+    for (int i = 0; i < messageCount; i++) {
+        mavlink_message_t message;
+        (void) mavlink_msg_system_time_pack_chan(testSysId, MAV_COMP_ID_AUTOPILOT1, _mockLink->mavlinkChannel(), &message, 1000 + i, i);
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const int length = mavlink_msg_to_send_buffer(buffer, &message);
+        bytes.append(reinterpret_cast<const char*>(buffer), length);
+    }
+
+    // MockLink emits the vehicle's own traffic from its thread at the same time, so only whole frames are pushed
+    emit _mockLink->bytesReceived(_mockLink, bytes);
+
+    QTRY_COMPARE(received.count(), messageCount);
+    QCOMPARE(receiveThread, QThread::currentThread());
+    for (int i = 0; i < messageCount; i++) {
+        QCOMPARE(mavlink_msg_system_time_get_time_boot_ms(&received[i]), static_cast<uint32_t>(i));
+    }
+
+    (void) disconnect(connection);
+    _disconnectMockLink();
+}
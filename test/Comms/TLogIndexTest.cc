@@ -0,0 +1,196 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TLogIndexTest.h"
+#include "TLogIndex.h"
+#include "MAVLinkLib.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+void TLogIndexTest::_writeLog(const QString& fileName, int messageCount, bool insertGarbage)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+
+    for (int i = 0; i < messageCount; i++) {
+        if (insertGarbage && (i == messageCount / 2)) {
+            const QByteArray garbage(1000, static_cast<char>(MAVLINK_STX));
+            (void) file.write(garbage);
+        }
+
+        mavlink_heartbeat_t heartbeat{};
+        heartbeat.custom_mode = static_cast<uint32_t>(i);
+        mavlink_message_t message;
+        (void) mavlink_msg_heartbeat_encode_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_0, &message, &heartbeat);
+
+        uchar timestamp[TLogIndex::cbTimestamp];
+        qToBigEndian(_startTimeUSecs + (i * _intervalUSecs), timestamp);
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t length = mavlink_msg_to_send_buffer(buffer, &message);
+        (void) file.write(reinterpret_cast<const char*>(timestamp), sizeof(timestamp));
+        (void) file.write(reinterpret_cast<const char*>(buffer), length);
+    }
+}
+
+void TLogIndexTest::_testBuildIndex()
+{
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath(QStringLiteral("build.tlog"));
+    _writeLog(fileName, _messageCount, false);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    TLogIndex index;
+    QVERIFY(index.load(file));
+    QVERIFY(index.isValid());
+    QCOMPARE(index.startTimeUSecs(), _startTimeUSecs);
+    QCOMPARE(index.endTimeUSecs(), _startTimeUSecs + ((_messageCount - 1) * _intervalUSecs));
+
+    // Entries are sparse and ordered
+    const QList<TLogIndex::Entry>& entries = index.entries();
+    QVERIFY(entries.count() > 2);
+    QVERIFY(entries.count() < _messageCount);
+    QCOMPARE(entries.first().offset, static_cast<qint64>(0));
+    for (qsizetype i = 1; i < entries.count(); i++) {
+        QVERIFY(entries[i].timeUSecs >= entries[i - 1].timeUSecs);
+        QVERIFY(entries[i].offset - entries[i - 1].offset <= TLogIndex::indexStrideBytes + MAVLINK_MAX_PACKET_LEN + TLogIndex::cbTimestamp);
+    }
+}
+
+void TLogIndexTest::_testFindRecord()
+{
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath(QStringLiteral("find.tlog"));
+    _writeLog(fileName, _messageCount, false);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    TLogIndex index;
+    QVERIFY(index.load(file));
+
+    for (const int messageIndex: { 0, 1, 1234, _messageCount / 2, _messageCount - 1 }) {
+        const quint64 timeUSecs = _startTimeUSecs + (messageIndex * _intervalUSecs);
+        TLogIndex::Record record;
+        QVERIFY(index.findRecord(file, timeUSecs, record));
+        QCOMPARE(record.timeUSecs, timeUSecs);
+
+        // The record must point at a complete heartbeat carrying the expected index
+        QVERIFY(file.seek(record.frameOffset));
+        const QByteArray frame = file.read(record.frameLength);
+        QCOMPARE(frame.size(), static_cast<qsizetype>(record.frameLength));
+        mavlink_message_t message;
+        mavlink_status_t status;
+        bool found = false;
+        mavlink_reset_channel_status(MAVLINK_COMM_1);
+        for (const char byte: frame) {
+            found = mavlink_parse_char(MAVLINK_COMM_1, static_cast<uint8_t>(byte), &message, &status);
+        }
+        QVERIFY(found);
+        QCOMPARE(mavlink_msg_heartbeat_get_custom_mode(&message), static_cast<uint32_t>(messageIndex));
+    }
+
+    // A time between two messages rounds up to the next one
+    TLogIndex::Record record;
+    QVERIFY(index.findRecord(file, _startTimeUSecs + (_intervalUSecs / 2), record));
+    QCOMPARE(record.timeUSecs, _startTimeUSecs + _intervalUSecs);
+
+    // Past the end of the log there is nothing to find
+    QVERIFY(!index.findRecord(file, index.endTimeUSecs() + 1, record));
+}
+
+void TLogIndexTest::_testResyncAfterGarbage()
+{
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath(QStringLiteral("garbage.tlog"));
+    _writeLog(fileName, _messageCount, true);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    TLogIndex index;
+    QVERIFY(index.load(file));
+    QCOMPARE(index.endTimeUSecs(), _startTimeUSecs + ((_messageCount - 1) * _intervalUSecs));
+
+    const quint64 timeUSecs = _startTimeUSecs + ((_messageCount / 2) * _intervalUSecs);
+    TLogIndex::Record record;
+    QVERIFY(index.findRecord(file, timeUSecs, record));
+    QCOMPARE(record.timeUSecs, timeUSecs);
+}
+
+void TLogIndexTest::_testCache()
+{
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath(QStringLiteral("cache.tlog"));
+    _writeLog(fileName, _messageCount, false);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    TLogIndex builtIndex;
+    QVERIFY(builtIndex.load(file));
+    QVERIFY(QFile::exists(TLogIndex::cacheFileName(fileName)));
+
+    TLogIndex cachedIndex;
+    QVERIFY(cachedIndex.load(file));
+    QCOMPARE(cachedIndex.startTimeUSecs(), builtIndex.startTimeUSecs());
+    QCOMPARE(cachedIndex.endTimeUSecs(), builtIndex.endTimeUSecs());
+    QCOMPARE(cachedIndex.entries().count(), builtIndex.entries().count());
+    QCOMPARE(cachedIndex.entries().last().offset, builtIndex.entries().last().offset);
+
+    // A cache which doesn't match the log is ignored and rebuilt
+    file.close();
+    _writeLog(fileName, _messageCount / 2, false);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    TLogIndex rebuiltIndex;
+    QVERIFY(rebuiltIndex.load(file));
+    QCOMPARE(rebuiltIndex.endTimeUSecs(), _startTimeUSecs + (((_messageCount / 2) - 1) * _intervalUSecs));
+}
+
+void TLogIndexTest::_testCorruptCache()
+{
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath(QStringLiteral("corrupt.tlog"));
+    _writeLog(fileName, _messageCount, false);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    TLogIndex builtIndex;
+    QVERIFY(builtIndex.load(file));
+    const qsizetype entryCount = builtIndex.entries().count();
+
+    // Header: magic, version, log size, log modified, start time, end time, entry count
+    static constexpr qint64 entryCountOffset = (2 * sizeof(quint32)) + (4 * sizeof(quint64));
+    const auto writeEntryCount = [&](quint32 count, qint64 padBytes) {
+        QFile cacheFile(TLogIndex::cacheFileName(fileName));
+        QVERIFY(cacheFile.open(QIODevice::ReadWrite));
+        uchar bytes[sizeof(quint32)];
+        qToBigEndian(count, bytes);
+        QVERIFY(cacheFile.seek(entryCountOffset));
+        QCOMPARE(cacheFile.write(reinterpret_cast<const char*>(bytes), sizeof(bytes)), static_cast<qint64>(sizeof(bytes)));
+        if (padBytes > 0) {
+            QVERIFY(cacheFile.seek(cacheFile.size()));
+            QCOMPARE(cacheFile.write(QByteArray(padBytes, 0)), padBytes);
+        }
+    };
+
+    // A count larger than the cache file can hold must not be allocated, the index is rebuilt instead
+    writeEntryCount(0xFFFFFFF0, 0);
+    TLogIndex oversizedIndex;
+    QVERIFY(oversizedIndex.load(file));
+    QCOMPARE(oversizedIndex.entries().count(), entryCount);
+
+    // Same for a count the cache file can hold but the log can't have produced
+    static constexpr int extraEntries = 1000;
+    writeEntryCount(static_cast<quint32>(entryCount + extraEntries), extraEntries * (sizeof(quint64) + sizeof(qint64)));
+    TLogIndex paddedIndex;
+    QVERIFY(paddedIndex.load(file));
+    QCOMPARE(paddedIndex.entries().count(), entryCount);
+    QCOMPARE(paddedIndex.entries().last().offset, builtIndex.entries().last().offset);
+}
@@ -0,0 +1,31 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class TLogIndexTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testBuildIndex();
+    void _testFindRecord();
+    void _testResyncAfterGarbage();
+    void _testCache();
+    void _testCorruptCache();
+
+private:
+    void _writeLog(const QString& fileName, int messageCount, bool insertGarbage);
+
+    static constexpr quint64 _startTimeUSecs = 1700000000000000ULL;
+    static constexpr quint64 _intervalUSecs = 10000;
+    static constexpr int _messageCount = 10000;
+};
@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TLogWriterTest.h"
+#include "TLogWriter.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+QByteArray TLogWriterTest::_frame(int index)
+{
+    QByteArray frame(_frameLength, 0);
+    for (int i = 0; i < _frameLength; i++) {
+        frame[i] = static_cast<char>(index + i);
+    }
+    return frame;
+}
+
+QByteArray TLogWriterTest::_record(int index)
+{
+    uchar timestamp[sizeof(quint64)];
+    qToBigEndian(_startTimeUSecs + index, timestamp);
+    return QByteArray(reinterpret_cast<const char*>(timestamp), sizeof(timestamp)) + _frame(index);
+}
+
+qsizetype TLogWriterTest::_bufferedBytes(const TLogWriter& writer)
+{
+    QMutexLocker locker(&writer._mutex);
+    return writer._used;
+}
+
+void TLogWriterTest::_testWraparound()
+{
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath(QStringLiteral("wrap.tlog"));
+
+    // Records don't divide the buffer evenly, so they keep splitting across the end of the ring
+    TLogWriter writer;
+    writer.setBufferSize(64);
+    writer.setCommitThreshold(1);
+    QVERIFY(writer.open(fileName));
+
+    static constexpr int recordCount = 25;
+    QByteArray expected;
+    for (int i = 0; i < recordCount; i++) {
+        const QByteArray frame = _frame(i);
+        QVERIFY(writer.append(_startTimeUSecs + i, frame.constData(), static_cast<int>(frame.size())));
+        expected.append(_record(i));
+
+        // Let the writer drain the ring before the next record so nothing is dropped
+        QTRY_COMPARE(_bufferedBytes(writer), static_cast<qsizetype>(0));
+    }
+    writer.close();
+    QCOMPARE(writer.droppedFrames(), 0ULL);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), expected);
+}
+
+void TLogWriterTest::_testDropOnOverflow()
+{
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath(QStringLiteral("overflow.tlog"));
+
+    // Nothing is committed until close, so the ring fills up
+    static constexpr int recordLength = sizeof(quint64) + _frameLength;
+    static constexpr int fittingRecords = 4;
+    TLogWriter writer;
+    writer.setBufferSize((recordLength * fittingRecords) + (recordLength / 2));
+    writer.setCommitThreshold(1024 * 1024);
+    writer.setCommitIntervalMSecs(60 * 1000);
+    QVERIFY(writer.open(fileName));
+
+    QByteArray expected;
+    for (int i = 0; i < fittingRecords + 3; i++) {
+        const QByteArray frame = _frame(i);
+        const bool appended = writer.append(_startTimeUSecs + i, frame.constData(), static_cast<int>(frame.size()));
+        QCOMPARE(appended, i < fittingRecords);
+        if (appended) {
+            expected.append(_record(i));
+        }
+    }
+    QCOMPARE(writer.droppedFrames(), 3ULL);
+
+    // Everything which made it into the ring is committed on close
+    writer.close();
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), expected);
+}
+
+void TLogWriterTest::_testWriteError()
+{
+    // Writes to /dev/full always fail with ENOSPC
+    const QString fileName = QStringLiteral("/dev/full");
+    if (!QFile::exists(fileName)) {
+        QSKIP("No /dev/full on this platform");
+    }
+
+    TLogWriter writer;
+    writer.setCommitThreshold(1);
+    QSignalSpy spyError(&writer, &TLogWriter::writeError);
+    QVERIFY(writer.open(fileName));
+
+    const QByteArray frame = _frame(0);
+    QVERIFY(writer.append(_startTimeUSecs, frame.constData(), static_cast<int>(frame.size())));
+    QVERIFY(spyError.wait(5000));
+    QCOMPARE(spyError.count(), 1);
+    QCOMPARE(spyError.first().at(0).toString(), fileName);
+
+    // The writer stops taking frames after an error, without counting them as dropped
+    QVERIFY(!writer.append(_startTimeUSecs + 1, frame.constData(), static_cast<int>(frame.size())));
+    QCOMPARE(writer.droppedFrames(), 0ULL);
+    QCOMPARE(_bufferedBytes(writer), static_cast<qsizetype>(0));
+
+    writer.close();
+    QVERIFY(!writer.isOpen());
+}
@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class TLogWriter;
+
+class TLogWriterTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testWraparound();
+    void _testDropOnOverflow();
+    void _testWriteError();
+
+private:
+    /// Frame @a index of the test log, its bytes are derived from the index
+    static QByteArray _frame(int index);
+    /// The timestamped record append() writes for frame @a index
+    static QByteArray _record(int index);
+    static qsizetype _bufferedBytes(const TLogWriter& writer);
+
+    static constexpr quint64 _startTimeUSecs = 1700000000000000ULL;
+    static constexpr int _frameLength = 20;
+};
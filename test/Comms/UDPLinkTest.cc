@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UDPLinkTest.h"
+#include "LinkManager.h"
+#include "QGCApplication.h"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QMutexLocker>
+#include <QtNetwork/QNetworkDatagram>
+#include <QtNetwork/QUdpSocket>
+#include <QtTest/QTest>
+
+void UDPLinkTest::init()
+{
+    UnitTest::init();
+
+    _peer = new QUdpSocket(this);
+    QVERIFY(_peer->bind(QHostAddress::LocalHost, 0));
+
+    // Let the link pick a free port, and start from no configured hosts whatever the autoconnect settings say
+    _udpConfig = new UDPConfiguration(QStringLiteral("UDPLinkTest"));
+    _udpConfig->setDynamic(true);
+    _udpConfig->setLocalPort(0);
+    for (const QString& host: _udpConfig->hostList()) {
+        _udpConfig->removeHost(host);
+    }
+
+    LinkManager* const linkManager = qgcApp()->toolbox()->linkManager();
+    SharedLinkConfigurationPtr sharedConfig = linkManager->addConfiguration(_udpConfig);
+    QVERIFY(linkManager->createConnectedLink(sharedConfig));
+    _udpLink = qobject_cast<UDPLink*>(sharedConfig->link());
+    QVERIFY(_udpLink);
+    QTRY_VERIFY(_udpLink->isConnected());
+    _linkPort = _udpLink->_socket->localPort();
+    QVERIFY(_linkPort != 0);
+}
+
+void UDPLinkTest::cleanup()
+{
+    if (_udpConfig) {
+        qgcApp()->toolbox()->linkManager()->removeConfiguration(_udpConfig);
+    }
+    _udpConfig = nullptr;
+    _udpLink = nullptr;
+    delete _peer;
+    _peer = nullptr;
+
+    UnitTest::cleanup();
+}
+
+QList<UDPEndpoint> UDPLinkTest::_writeTargets()
+{
+    QMutexLocker locker(&_udpLink->_sessionTargetsMutex);
+    return _udpLink->_writeTargets;
+}
+
+bool UDPLinkTest::_peerReceived(const QByteArray& payload, int timeoutMSecs)
+{
+    const QDeadlineTimer deadline(timeoutMSecs);
+    while (!deadline.hasExpired()) {
+        while (_peer->hasPendingDatagrams()) {
+            if (_peer->receiveDatagram().data() == payload) {
+                return true;
+            }
+        }
+        (void) _peer->waitForReadyRead(static_cast<int>(qMax<qint64>(deadline.remainingTime(), 1)));
+    }
+    return false;
+}
+
+void UDPLinkTest::_testSessionTargetExpiry()
+{
+    const UDPEndpoint peerEndpoint{ QHostAddress(QHostAddress::LocalHost), _peer->localPort() };
+
+    // Anything the link hears from becomes a session target which gets our traffic
+    QVERIFY(_peer->writeDatagram(QByteArrayLiteral("hello"), QHostAddress::LocalHost, _linkPort) > 0);
+    QTRY_VERIFY(_writeTargets().contains(peerEndpoint));
+
+    const QByteArray firstPayload = QByteArrayLiteral("before expiry");
+    _udpLink->writeBytesThreadSafe(firstPayload);
+    QVERIFY(_peerReceived(firstPayload, 5000));
+
+    // Make the peer look like it went quiet, and have the next write run the expiry check
+    {
+        QMutexLocker locker(&_udpLink->_sessionTargetsMutex);
+        const qint64 staleMSecs = _udpLink->_sessionClock.elapsed() - UDPLink::_sessionTargetTimeoutMSecs - 1;
+        QVERIFY(_udpLink->_sessionTargets.contains(peerEndpoint));
+        _udpLink->_sessionTargets[peerEndpoint] = staleMSecs;
+        _udpLink->_nextSessionExpiryMSecs = 0;
+    }
+
+    const QByteArray secondPayload = QByteArrayLiteral("after expiry");
+    _udpLink->writeBytesThreadSafe(secondPayload);
+    QTRY_VERIFY(!_writeTargets().contains(peerEndpoint));
+    QVERIFY(!_peerReceived(secondPayload, 500));
+
+    // Hearing from it again brings it back
+    QVERIFY(_peer->writeDatagram(QByteArrayLiteral("hello again"), QHostAddress::LocalHost, _linkPort) > 0);
+    QTRY_VERIFY(_writeTargets().contains(peerEndpoint));
+}
+
+void UDPLinkTest::_testHostListChange()
+{
+    const UDPEndpoint peerEndpoint{ QHostAddress(QHostAddress::LocalHost), _peer->localPort() };
+    QVERIFY(!_writeTargets().contains(peerEndpoint));
+
+    // Adding a host to the running link's configuration starts sending to it
+    _udpConfig->addHost(QStringLiteral("127.0.0.1"), _peer->localPort());
+    QTRY_VERIFY(_writeTargets().contains(peerEndpoint));
+    const QByteArray payload = QByteArrayLiteral("configured host");
+    _udpLink->writeBytesThreadSafe(payload);
+    QVERIFY(_peerReceived(payload, 5000));
+
+    // Copying in a configuration without hosts must drop it again
+    UDPConfiguration emptyConfig(QStringLiteral("UDPLinkTestEmpty"));
+    for (const QString& host: emptyConfig.hostList()) {
+        emptyConfig.removeHost(host);
+    }
+    _udpConfig->copyFrom(&emptyConfig);
+    QVERIFY(_udpConfig->hostList().isEmpty());
+    QTRY_VERIFY(!_writeTargets().contains(peerEndpoint));
+
+    // As must removing it
+    _udpConfig->addHost(QStringLiteral("127.0.0.1"), _peer->localPort());
+    QTRY_VERIFY(_writeTargets().contains(peerEndpoint));
+    _udpConfig->removeHost(QStringLiteral("127.0.0.1:%1").arg(_peer->localPort()));
+    QTRY_VERIFY(!_writeTargets().contains(peerEndpoint));
+}
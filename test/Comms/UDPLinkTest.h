@@ -0,0 +1,38 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "UDPLink.h"
+
+class QUdpSocket;
+
+class UDPLinkTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init() override;
+    void cleanup() override;
+
+    void _testSessionTargetExpiry();
+    void _testHostListChange();
+
+private:
+    /// Snapshot of the link's write targets, taken under its lock
+    QList<UDPEndpoint> _writeTargets();
+    /// Waits for @a payload to arrive on the peer socket, other traffic such as GCS heartbeats is skipped
+    bool _peerReceived(const QByteArray& payload, int timeoutMSecs);
+
+    UDPConfiguration*   _udpConfig = nullptr;
+    UDPLink*            _udpLink = nullptr;
+    QUdpSocket*         _peer = nullptr;     ///< Stands in for a vehicle on the other end of the link
+    quint16             _linkPort = 0;
+};
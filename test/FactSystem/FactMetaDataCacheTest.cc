@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactMetaDataCacheTest.h"
+#include "FactMetaData.h"
+#include "VehicleBatteryFactGroup.h"
+
+#include <QtTest/QTest>
+
+void FactMetaDataCacheTest::_testSharedBetweenGroups()
+{
+    VehicleBatteryFactGroup batteryGroup1(0);
+    VehicleBatteryFactGroup batteryGroup2(1);
+
+    QVERIFY(batteryGroup1.voltage()->metaData()->isShared());
+    QCOMPARE(batteryGroup1.voltage()->metaData(), batteryGroup2.voltage()->metaData());
+    QCOMPARE(batteryGroup1.function()->metaData(), batteryGroup2.function()->metaData());
+
+    // Repeated lookups hand out the same meta data
+    const QMap<QString, FactMetaData*> metaDataMap1 = FactMetaData::sharedMapFromJsonFile(QStringLiteral(":/json/Vehicle/BatteryFact.json"));
+    const QMap<QString, FactMetaData*> metaDataMap2 = FactMetaData::sharedMapFromJsonFile(QStringLiteral(":/json/Vehicle/BatteryFact.json"));
+    QCOMPARE(metaDataMap1, metaDataMap2);
+    QCOMPARE(metaDataMap1.value(QStringLiteral("voltage")), batteryGroup1.voltage()->metaData());
+}
+
+void FactMetaDataCacheTest::_testCopyOnWrite()
+{
+    VehicleBatteryFactGroup batteryGroup1(0);
+    VehicleBatteryFactGroup batteryGroup2(1);
+
+    FactMetaData* const sharedMetaData = batteryGroup2.function()->metaData();
+    const QStringList sharedEnumStrings = sharedMetaData->enumStrings();
+
+    // An unknown enum value adds an enum entry, which must only show up in the fact which has the value
+    batteryGroup1.function()->setRawValue(99);
+    (void) batteryGroup1.function()->enumIndex();
+
+    QVERIFY(batteryGroup1.function()->metaData() != sharedMetaData);
+    QVERIFY(!batteryGroup1.function()->metaData()->isShared());
+    QCOMPARE(batteryGroup1.function()->enumStrings().count(), sharedEnumStrings.count() + 1);
+    QCOMPARE(batteryGroup2.function()->metaData(), sharedMetaData);
+    QCOMPARE(sharedMetaData->enumStrings(), sharedEnumStrings);
+}
+
+void FactMetaDataCacheTest::_testSharedVariant()
+{
+    const QMap<QString, FactMetaData*> metaDataMap = FactMetaData::sharedMapFromJsonFile(QStringLiteral(":/json/Vehicle/BatteryFact.json"));
+    FactMetaData* const sharedMetaData = metaDataMap.value(QStringLiteral("voltage"));
+    QVERIFY(sharedMetaData);
+    const QString sharedDescription = sharedMetaData->shortDescription();
+
+    int adjustCount = 0;
+    auto adjust = [&adjustCount](FactMetaData* metaData) {
+        adjustCount++;
+        metaData->setShortDescription(QStringLiteral("Adjusted"));
+    };
+
+    FactMetaData* const variant1 = FactMetaData::sharedVariant(sharedMetaData, QStringLiteral("test"), adjust);
+    FactMetaData* const variant2 = FactMetaData::sharedVariant(sharedMetaData, QStringLiteral("test"), adjust);
+    QCOMPARE(variant1, variant2);
+    QCOMPARE(adjustCount, 1);
+    QVERIFY(variant1 != sharedMetaData);
+    QVERIFY(variant1->isShared());
+    QCOMPARE(variant1->shortDescription(), QStringLiteral("Adjusted"));
+    QCOMPARE(sharedMetaData->shortDescription(), sharedDescription);
+
+    // Meta data which isn't shared is adjusted in place
+    FactMetaData ownedMetaData(FactMetaData::valueTypeDouble);
+    QCOMPARE(FactMetaData::sharedVariant(&ownedMetaData, QStringLiteral("test"), adjust), &ownedMetaData);
+    QCOMPARE(adjustCount, 2);
+    QCOMPARE(ownedMetaData.shortDescription(), QStringLiteral("Adjusted"));
+}
@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactTypedSetterTest.h"
+#include "Fact.h"
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <limits>
+
+void FactTypedSetterTest::_testNativeStorage()
+{
+    Fact doubleFact(0, QStringLiteral("double"), FactMetaData::valueTypeDouble);
+    Fact floatFact(0, QStringLiteral("float"), FactMetaData::valueTypeFloat);
+    Fact int32Fact(0, QStringLiteral("int32"), FactMetaData::valueTypeInt32);
+    Fact uint8Fact(0, QStringLiteral("uint8"), FactMetaData::valueTypeUint8);
+    Fact int64Fact(0, QStringLiteral("int64"), FactMetaData::valueTypeInt64);
+
+    QSignalSpy valueSpy(&doubleFact, &Fact::valueChanged);
+    QSignalSpy rawValueSpy(&doubleFact, &Fact::rawValueChanged);
+
+    doubleFact.setRawDouble(1.5);
+    QCOMPARE(doubleFact.rawValue().typeId(), QMetaType::Double);
+    QCOMPARE(doubleFact.rawValue().toDouble(), 1.5);
+    QCOMPARE(valueSpy.count(), 1);
+    QCOMPARE(rawValueSpy.count(), 1);
+
+    floatFact.setRawDouble(2.5);
+    QCOMPARE(floatFact.rawValue().typeId(), QMetaType::Float);
+    QCOMPARE(floatFact.rawValue().toFloat(), 2.5f);
+
+    int32Fact.setRawInt(-7);
+    QCOMPARE(int32Fact.rawValue().typeId(), QMetaType::Int);
+    QCOMPARE(int32Fact.rawValue().toInt(), -7);
+
+    uint8Fact.setRawInt(200);
+    QCOMPARE(uint8Fact.rawValue().typeId(), QMetaType::UInt);
+    QCOMPARE(uint8Fact.rawValue().toUInt(), 200u);
+
+    int64Fact.setRawInt(std::numeric_limits<qint64>::max());
+    QCOMPARE(int64Fact.rawValue().typeId(), QMetaType::LongLong);
+    QCOMPARE(int64Fact.rawValue().toLongLong(), std::numeric_limits<qint64>::max());
+
+    // The typed setters must leave the fact exactly as setRawValue would
+    Fact referenceFact(0, QStringLiteral("reference"), FactMetaData::valueTypeDouble);
+    referenceFact.setRawValue(1.5);
+    QCOMPARE(doubleFact.rawValue(), referenceFact.rawValue());
+    QCOMPARE(doubleFact.cookedValue(), referenceFact.cookedValue());
+}
+
+void FactTypedSetterTest::_testUnchangedValueNotSignalled()
+{
+    Fact fact(0, QStringLiteral("double"), FactMetaData::valueTypeDouble);
+    QSignalSpy spy(&fact, &Fact::valueChanged);
+
+    fact.setRawDouble(3.0);
+    fact.setRawDouble(3.0);
+    QCOMPARE(spy.count(), 1);
+
+    // Unset telemetry repeats NaN every sample
+    fact.setRawDouble(qQNaN());
+    fact.setRawDouble(qQNaN());
+    QCOMPARE(spy.count(), 2);
+
+    fact.setRawDouble(4.0);
+    QCOMPARE(spy.count(), 3);
+}
+
+void FactTypedSetterTest::_testFallbackConversion()
+{
+    // Types without a native fast path go through setRawValue conversion
+    Fact stringFact(0, QStringLiteral("string"), FactMetaData::valueTypeString);
+    stringFact.setRawInt(42);
+    QCOMPARE(stringFact.rawValue().typeId(), QMetaType::QString);
+    QCOMPARE(stringFact.rawValue().toString(), QStringLiteral("42"));
+
+    Fact int32Fact(0, QStringLiteral("int32"), FactMetaData::valueTypeInt32);
+    int32Fact.setRawDouble(5.0);
+    QCOMPARE(int32Fact.rawValue().typeId(), QMetaType::Int);
+    QCOMPARE(int32Fact.rawValue().toInt(), 5);
+
+    // A value out of the storage range is handled like setRawValue handles it
+    Fact uint32Fact(0, QStringLiteral("uint32"), FactMetaData::valueTypeUint32);
+    Fact referenceFact(0, QStringLiteral("reference"), FactMetaData::valueTypeUint32);
+    uint32Fact.setRawInt(-1);
+    referenceFact.setRawValue(static_cast<qlonglong>(-1));
+    QCOMPARE(uint32Fact.rawValue(), referenceFact.rawValue());
+}
+
+void FactTypedSetterTest::_testDeferredCookedValue()
+{
+    FactMetaData* metaData = new FactMetaData(FactMetaData::valueTypeDouble, this);
+    metaData->setRawUnits(QStringLiteral("rad"));
+    Fact fact(0, QStringLiteral("angle"), FactMetaData::valueTypeDouble);
+    fact.setMetaData(metaData);
+    fact.setSendValueChangedSignals(false);
+
+    QSignalSpy spy(&fact, &Fact::valueChanged);
+    QSignalSpy rawValueSpy(&fact, &Fact::rawValueChanged);
+
+    fact.setRawDouble(M_PI);
+    fact.setRawDouble(M_PI_2);
+    QCOMPARE(spy.count(), 0);
+    QCOMPARE(rawValueSpy.count(), 2);
+    QVERIFY(fact.deferredValueChangeSignal());
+
+    // The cooked value is translated when the deferred signal goes out and reflects the latest sample
+    fact.sendDeferredValueChangedSignal();
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0), fact.cookedValue());
+    QCOMPARE(spy.at(0).at(0).toDouble(), 90.0);
+    QVERIFY(!fact.deferredValueChangeSignal());
+}
+
+void FactTypedSetterTest::_benchmarkSetRawValue()
+{
+    Fact fact(0, QStringLiteral("double"), FactMetaData::valueTypeDouble);
+    fact.setSendValueChangedSignals(false);
+
+    double value = 0;
+    QBENCHMARK {
+        fact.setRawValue(value);
+        value += 0.001;
+    }
+}
+
+void FactTypedSetterTest::_benchmarkSetRawDouble()
+{
+    Fact fact(0, QStringLiteral("double"), FactMetaData::valueTypeDouble);
+    fact.setSendValueChangedSignals(false);
+
+    double value = 0;
+    QBENCHMARK {
+        fact.setRawDouble(value);
+        value += 0.001;
+    }
+}
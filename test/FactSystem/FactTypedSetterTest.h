@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class FactTypedSetterTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testNativeStorage();
+    void _testUnchangedValueNotSignalled();
+    void _testFallbackConversion();
+    void _testDeferredCookedValue();
+    void _benchmarkSetRawValue();
+    void _benchmarkSetRawDouble();
+};
@@ -0,0 +1,124 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactUpdateSchedulerTest.h"
+#include "FactUpdateScheduler.h"
+#include "FactGroup.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace {
+    class TestFactGroup : public FactGroup
+    {
+    public:
+        TestFactGroup(int updateRateMSecs)
+            : FactGroup(updateRateMSecs)
+            , valueFact(0, QStringLiteral("value"), FactMetaData::valueTypeDouble)
+        {
+            _addFact(&valueFact, QStringLiteral("value"));
+        }
+
+        Fact valueFact;
+    };
+
+    constexpr int kUpdateRateMSecs = 50;
+}
+
+void FactUpdateSchedulerTest::_testCoalescedValueChanged()
+{
+    TestFactGroup factGroup(kUpdateRateMSecs);
+    QSignalSpy spy(&factGroup.valueFact, &Fact::valueChanged);
+
+    for (int i = 1; i <= 10; i++) {
+        factGroup.valueFact.setRawValue(i);
+    }
+    QCOMPARE(spy.count(), 0);
+
+    // One signal with the latest value once the group is due
+    QVERIFY(spy.wait(kUpdateRateMSecs * 10));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toDouble(), 10.0);
+}
+
+void FactUpdateSchedulerTest::_testIdleGroupNotScheduled()
+{
+    FactUpdateScheduler* scheduler = FactUpdateScheduler::instance();
+    const int scheduledCount = scheduler->scheduledCount();
+
+    TestFactGroup factGroup(kUpdateRateMSecs);
+    QCOMPARE(scheduler->scheduledCount(), scheduledCount);
+
+    factGroup.valueFact.setRawValue(1);
+    QCOMPARE(scheduler->scheduledCount(), scheduledCount + 1);
+
+    // Nothing left to send after the update, so the group drops out of the schedule
+    QSignalSpy spy(&factGroup.valueFact, &Fact::valueChanged);
+    QVERIFY(spy.wait(kUpdateRateMSecs * 10));
+    QCOMPARE(scheduler->scheduledCount(), scheduledCount);
+}
+
+void FactUpdateSchedulerTest::_testSameRateGroupsFlushTogether()
+{
+    TestFactGroup factGroup1(kUpdateRateMSecs);
+    TestFactGroup factGroup2(kUpdateRateMSecs);
+
+    // Start right after an update so both changes below fall into the same update period
+    QSignalSpy spy1(&factGroup1.valueFact, &Fact::valueChanged);
+    factGroup1.valueFact.setRawValue(1);
+    QVERIFY(spy1.wait(kUpdateRateMSecs * 10));
+
+    qint64 signalTime1 = -1;
+    qint64 signalTime2 = -1;
+    QElapsedTimer clock;
+    clock.start();
+    (void) connect(&factGroup1.valueFact, &Fact::valueChanged, this, [&]() { signalTime1 = clock.elapsed(); });
+    (void) connect(&factGroup2.valueFact, &Fact::valueChanged, this, [&]() { signalTime2 = clock.elapsed(); });
+
+    factGroup1.valueFact.setRawValue(2);
+    QTest::qWait(kUpdateRateMSecs / 5);
+    factGroup2.valueFact.setRawValue(2);
+
+    // Changed at different times, but sent in the same pass
+    QVERIFY(QTest::qWaitFor([&]() { return (signalTime1 >= 0) && (signalTime2 >= 0); }, kUpdateRateMSecs * 10));
+    QVERIFY(qAbs(signalTime2 - signalTime1) < FactUpdateScheduler::defaultTickMSecs);
+}
+
+void FactUpdateSchedulerTest::_testLiveUpdates()
+{
+    TestFactGroup factGroup(kUpdateRateMSecs);
+    QSignalSpy spy(&factGroup.valueFact, &Fact::valueChanged);
+
+    factGroup.setLiveUpdates(true);
+    factGroup.valueFact.setRawValue(1);
+    factGroup.valueFact.setRawValue(2);
+    QCOMPARE(spy.count(), 2);
+
+    factGroup.setLiveUpdates(false);
+    factGroup.valueFact.setRawValue(3);
+    QCOMPARE(spy.count(), 2);
+    QVERIFY(spy.wait(kUpdateRateMSecs * 10));
+    QCOMPARE(spy.count(), 3);
+}
+
+void FactUpdateSchedulerTest::_testDeletedGroupCancelled()
+{
+    FactUpdateScheduler* scheduler = FactUpdateScheduler::instance();
+    const int scheduledCount = scheduler->scheduledCount();
+
+    TestFactGroup* factGroup = new TestFactGroup(kUpdateRateMSecs);
+    factGroup->valueFact.setRawValue(1);
+    QCOMPARE(scheduler->scheduledCount(), scheduledCount + 1);
+    delete factGroup;
+    QCOMPARE(scheduler->scheduledCount(), scheduledCount);
+
+    // Must not touch the deleted group
+    QTest::qWait(kUpdateRateMSecs * 2);
+}
@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterCacheFileTest.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+#include <algorithm>
+
+/// Parameters in the variant types they have when received from the vehicle, deliberately not sorted by name
+QList<ParameterCacheFile::Entry> ParameterCacheFileTest::_entries()
+{
+    return {
+        { QStringLiteral("SYS_AUTOSTART"),   FactMetaData::valueTypeInt32,   QVariant(static_cast<qint32>(4001)),    false },
+        { QStringLiteral("BAT1_V_CHARGED"),  FactMetaData::valueTypeFloat,   QVariant(4.05f),                        false },
+        { QStringLiteral("COM_FLIGHT_UUID"), FactMetaData::valueTypeInt32,   QVariant(static_cast<qint32>(17)),      true },
+        { QStringLiteral("MAV_TYPE"),        FactMetaData::valueTypeUint8,   QVariant(static_cast<quint8>(2)),       false },
+        { QStringLiteral("RC_MAP_ROLL"),     FactMetaData::valueTypeInt16,   QVariant(static_cast<qint16>(-1)),      false },
+    };
+}
+
+void ParameterCacheFileTest::_testSaveAndLoad()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("1_1.v3"));
+
+    QVERIFY(ParameterCacheFile::save(fileName, _entries()));
+
+    ParameterCacheFile cache;
+    QVERIFY(cache.load(fileName));
+    QVERIFY(cache.isValid());
+    QCOMPARE(cache.count(), _entries().count());
+
+    // Entries come back sorted by name with the same values
+    QStringList names;
+    for (int index = 0; index < cache.count(); index++) {
+        names.append(cache.entry(index).name);
+    }
+    QStringList sortedNames = names;
+    sortedNames.sort();
+    QCOMPARE(names, sortedNames);
+
+    for (const ParameterCacheFile::Entry& expected: _entries()) {
+        const ParameterCacheFile::Entry entry = cache.entry(names.indexOf(expected.name));
+        QCOMPARE(entry.name, expected.name);
+        QCOMPARE(entry.type, expected.type);
+        QCOMPARE(entry.value, expected.value);
+        QCOMPARE(entry.volatileValue, expected.volatileValue);
+    }
+}
+
+void ParameterCacheFileTest::_testHash()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("1_1.v3"));
+
+    QList<ParameterCacheFile::Entry> entries = _entries();
+    QVERIFY(ParameterCacheFile::save(fileName, entries));
+
+    ParameterCacheFile cache;
+    QVERIFY(cache.load(fileName));
+
+    // The stored hash is the one computed over the parameters in name order
+    QList<ParameterCacheFile::Entry> sorted;
+    for (int index = 0; index < cache.count(); index++) {
+        sorted.append(cache.entry(index));
+    }
+    const quint32 hash = cache.hash();
+    QVERIFY(hash != 0);
+    QCOMPARE(ParameterCacheFile::computeHash(sorted), hash);
+
+    // Volatile parameters don't change the hash
+    for (ParameterCacheFile::Entry& entry: sorted) {
+        if (entry.volatileValue) {
+            entry.value = QVariant(static_cast<qint32>(entry.value.toInt() + 1));
+        }
+    }
+    QCOMPARE(ParameterCacheFile::computeHash(sorted), hash);
+
+    // Everything else does
+    for (ParameterCacheFile::Entry& entry: sorted) {
+        if (entry.name == QStringLiteral("MAV_TYPE")) {
+            entry.value = QVariant(static_cast<quint8>(1));
+        }
+    }
+    QVERIFY(ParameterCacheFile::computeHash(sorted) != hash);
+}
+
+/// The hash must match the one the firmware reports in _HASH_CHECK, otherwise the cache is silently never used
+void ParameterCacheFileTest::_testHashKnownAnswer()
+{
+    QList<ParameterCacheFile::Entry> sorted = _entries();
+    std::sort(sorted.begin(), sorted.end(), [](const ParameterCacheFile::Entry& left, const ParameterCacheFile::Entry& right) {
+        return left.name < right.name;
+    });
+
+    // Value of the QDataStream cache crc32 code for the same parameters, with COM_FLIGHT_UUID volatile
+    static constexpr quint32 expectedHash = 0x2E4DC00C;
+    QCOMPARE(ParameterCacheFile::computeHash(sorted), expectedHash);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("1_1.v3"));
+    QVERIFY(ParameterCacheFile::save(fileName, _entries()));
+
+    ParameterCacheFile cache;
+    QVERIFY(cache.load(fileName));
+    QCOMPARE(cache.hash(), expectedHash);
+}
+
+void ParameterCacheFileTest::_testInvalidCache()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    ParameterCacheFile cache;
+    QVERIFY(!cache.load(tempDir.filePath(QStringLiteral("missing.v3"))));
+    QVERIFY(!cache.isValid());
+
+    // A cache in the previous QDataStream format or a truncated cache is rejected, not misread
+    const QString fileName = tempDir.filePath(QStringLiteral("1_1.v3"));
+    QVERIFY(ParameterCacheFile::save(fileName, _entries()));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() / 2));
+    file.close();
+    QVERIFY(!cache.load(fileName));
+
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    (void) file.write(QByteArray(64, 'x'));
+    file.close();
+    QVERIFY(!cache.load(fileName));
+    QCOMPARE(cache.count(), 0);
+}
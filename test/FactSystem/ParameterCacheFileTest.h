@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "ParameterCacheFile.h"
+
+class ParameterCacheFileTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testSaveAndLoad();
+    void _testHash();
+    void _testHashKnownAnswer();
+    void _testInvalidCache();
+
+private:
+    QList<ParameterCacheFile::Entry> _entries();
+};
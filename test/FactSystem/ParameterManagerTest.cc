@@ -13,7 +13,15 @@
 #include "Vehicle.h"
 #include "QGCApplication.h"
 #include "ParameterManager.h"
-
+#include "ParameterCacheFile.h"
+#include "LinkManager.h"
+#include "ParameterEditorController.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
 
@@ -184,6 +192,381 @@ void ParameterManagerTest::_FTPnoFailure()
     QCOMPARE(arguments.at(0).toFloat(), 0.0f);
 }
 
+/// Replays a full index based parameter download through mavlinkMessageReceived using the vehicle's own parameters
+void ParameterManagerTest::_benchmarkParamValueReplay(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    ParameterManager*   paramManager    = _vehicle->parameterManager();
+    const int           componentId     = _vehicle->defaultComponentId();
+    QVERIFY(paramManager->parametersReady());
+    const QStringList   paramNames      = paramManager->parameterNames(componentId);
+    QVERIFY(!paramNames.isEmpty());
+
+    QList<mavlink_message_t> messages;
+    messages.reserve(paramNames.count());
+    for (int paramIndex = 0; paramIndex < paramNames.count(); paramIndex++) {
+        const Fact* fact = paramManager->getParameter(componentId, paramNames[paramIndex]);
+
+        mavlink_param_union_t paramUnion;
+        paramUnion.param_float = 0;
+        paramUnion.type = ParameterManager::factTypeToMavType(fact->type());
+        switch (paramUnion.type) {
+        case MAV_PARAM_TYPE_UINT8:
+            paramUnion.param_uint8 = static_cast<uint8_t>(fact->rawValue().toUInt());
+            break;
+        case MAV_PARAM_TYPE_INT8:
+            paramUnion.param_int8 = static_cast<int8_t>(fact->rawValue().toInt());
+            break;
+        case MAV_PARAM_TYPE_UINT16:
+            paramUnion.param_uint16 = static_cast<uint16_t>(fact->rawValue().toUInt());
+            break;
+        case MAV_PARAM_TYPE_INT16:
+            paramUnion.param_int16 = static_cast<int16_t>(fact->rawValue().toInt());
+            break;
+        case MAV_PARAM_TYPE_UINT32:
+            paramUnion.param_uint32 = fact->rawValue().toUInt();
+            break;
+        case MAV_PARAM_TYPE_REAL32:
+            paramUnion.param_float = fact->rawValue().toFloat();
+            break;
+        default:
+            paramUnion.param_int32 = fact->rawValue().toInt();
+            break;
+        }
+
+        char paramId[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN + 1] = {};
+        strncpy(paramId, qPrintable(paramNames[paramIndex]), MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN);
+
+        mavlink_message_t message;
+        (void) mavlink_msg_param_value_pack_chan(static_cast<uint8_t>(_vehicle->id()),
+                                                 static_cast<uint8_t>(componentId),
+                                                 MAVLINK_COMM_0,
+                                                 &message,
+                                                 paramId,
+                                                 paramUnion.param_float,
+                                                 paramUnion.type,
+                                                 static_cast<uint16_t>(paramNames.count()),
+                                                 static_cast<uint16_t>(paramIndex));
+        messages.append(message);
+    }
+
+    ParameterManager::ComponentParameters& component = paramManager->_components[componentId];
+    QCOMPARE(component.paramCount, paramNames.count());
+
+    QBENCHMARK {
+        // Put the component back to the start of an index based download
+        component.waitingReadIndexRetries.fill(0, component.paramCount);
+        component.waitingReadIndexCount = component.paramCount;
+
+        for (const mavlink_message_t& message: messages) {
+            paramManager->mavlinkMessageReceived(message);
+        }
+    }
+
+    QCOMPARE(component.waitingReadIndexCount, 0);
+    QCOMPARE(paramManager->parameterNames(componentId), paramNames);
+
+    _disconnectMockLink();
+}
+
+void ParameterManagerTest::_lossyLinkLoadTime_data(void)
+{
+    QTest::addColumn<int>("lossPercent");
+
+    QTest::newRow("0%")     << 0;
+    QTest::newRow("5%")     << 5;
+    QTest::newRow("15%")    << 15;
+}
+
+/// Times a full parameter load with PARAM_VALUE messages being dropped by the link. Lost parameters are recovered
+/// through the index based re-requests, which is what the load time measures.
+void ParameterManagerTest::_lossyLinkLoadTime(void)
+{
+    QFETCH(int, lossPercent);
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    Q_ASSERT(!_mockLink);
+    _mockLink = MockLink::startPX4MockLink(false);
+    _mockLink->setParamValueLossPercent(lossPercent);
+
+    MultiVehicleManager* vehicleMgr = qgcApp()->toolbox()->multiVehicleManager();
+    QSignalSpy spyParamsReady(vehicleMgr, SIGNAL(parameterReadyVehicleAvailableChanged(bool)));
+    QCOMPARE(spyParamsReady.wait(60000), true);
+    QCOMPARE(spyParamsReady.takeFirst().at(0).toBool(), true);
+
+    const qint64 loadMSecs = loadTimer.elapsed();
+
+    Vehicle* vehicle = vehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    // Lost parameters must all be recovered by the re-requests, not just reported as missing
+    QCOMPARE(vehicle->parameterManager()->missingParameters(), false);
+    QCOMPARE(vehicle->parameterManager()->parametersReady(), true);
+
+    QTest::setBenchmarkResult(static_cast<qreal>(loadMSecs), QTest::WalltimeMilliseconds);
+}
+
+void ParameterManagerTest::_bulkWrite_data(void)
+{
+    QTest::addColumn<int>("lossPercent");
+
+    QTest::newRow("0%")     << 0;
+    QTest::newRow("20%")    << 20;
+}
+
+/// Writes a batch of parameters as one transaction, lost acks must be recovered by the resends
+void ParameterManagerTest::_bulkWrite(void)
+{
+    QFETCH(int, lossPercent);
+
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    ParameterManager*   paramManager    = _vehicle->parameterManager();
+    const int           componentId     = _vehicle->defaultComponentId();
+
+    QList<QPair<Fact*, QVariant>> writes;
+    for (const QString& paramName: paramManager->parameterNames(componentId)) {
+        Fact* fact = paramManager->getParameter(componentId, paramName);
+        if (fact->type() == FactMetaData::valueTypeFloat) {
+            writes.append({ fact, QVariant(fact->rawValue().toFloat() + 1.0f) });
+            if (writes.count() == 50) {
+                break;
+            }
+        }
+    }
+    QCOMPARE(writes.count(), 50);
+
+    _mockLink->setParamValueLossPercent(lossPercent);
+
+    // Written counts as seen through the progress properties
+    QList<int> writtenCounts;
+    (void) connect(paramManager, &ParameterManager::bulkWriteProgressChanged, this, [paramManager, &writtenCounts]() {
+        if (paramManager->bulkWriteInProgress()) {
+            writtenCounts.append(paramManager->bulkWriteWrittenCount());
+            QCOMPARE(paramManager->bulkWriteTotalCount(), 50);
+        }
+    });
+    QSignalSpy spyComplete(paramManager, &ParameterManager::bulkWriteComplete);
+    QVERIFY(paramManager->writeParameters(writes));
+    QVERIFY(paramManager->bulkWriteInProgress());
+    QVERIFY(paramManager->pendingWrites());
+
+    // Only one transaction at a time
+    QVERIFY(!paramManager->writeParameters(writes));
+
+    QVERIFY(spyComplete.wait(30000));
+    QCOMPARE(spyComplete.takeFirst().at(0).toBool(), true);
+    QVERIFY(!paramManager->bulkWriteInProgress());
+    QVERIFY(!paramManager->pendingWrites());
+
+    // Start of the transaction and then one update per parameter
+    QCOMPARE(writtenCounts.count(), writes.count() + 1);
+    QCOMPARE(writtenCounts.first(), 0);
+    QCOMPARE(writtenCounts.last(), writes.count());
+    QCOMPARE(paramManager->bulkWriteWrittenCount(), 0);
+
+    // Facts only take the new values once the vehicle acknowledged them
+    for (const QPair<Fact*, QVariant>& write: writes) {
+        QCOMPARE(write.first->rawValue().toFloat(), write.second.toFloat());
+    }
+
+    _disconnectMockLink();
+}
+
+/// Bulk write values are converted to the fact's type before they are sent, values which don't convert fail up front
+void ParameterManagerTest::_bulkWriteConversion(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    ParameterManager*   paramManager    = _vehicle->parameterManager();
+    const int           componentId     = _vehicle->defaultComponentId();
+
+    QList<Fact*> facts;
+    for (const QString& paramName: paramManager->parameterNames(componentId)) {
+        Fact* fact = paramManager->getParameter(componentId, paramName);
+        if ((fact->type() == FactMetaData::valueTypeFloat) && !fact->readOnly()) {
+            facts.append(fact);
+            if (facts.count() == 3) {
+                break;
+            }
+        }
+    }
+    QCOMPARE(facts.count(), 3);
+
+    // A string as loaded from a file, and a double which only matches the vehicle's answer once converted to float
+    const float stringValue = facts[0]->rawValue().toFloat() + 1.0f;
+    const double doubleValue = facts[2]->rawValue().toDouble() + 1.1;
+    const QVariant invalidFactValue = facts[1]->rawValue();
+    const QString invalidParam = QStringLiteral("%1:%2").arg(componentId).arg(facts[1]->name());
+
+    // With rollback nothing is written if any of the values is invalid
+    QList<QPair<Fact*, QVariant>> writes;
+    writes.append({ facts[0], QString::number(stringValue, 'g', 9) });
+    writes.append({ facts[1], QStringLiteral("not a number") });
+    writes.append({ facts[2], doubleValue });
+    QSignalSpy spyComplete(paramManager, &ParameterManager::bulkWriteComplete);
+    QVERIFY(paramManager->writeParameters(writes, true /* rollbackOnFailure */));
+    QCOMPARE(spyComplete.count(), 1);
+    QList<QVariant> arguments = spyComplete.takeFirst();
+    QCOMPARE(arguments.at(0).toBool(), false);
+    QCOMPARE(arguments.at(1).toStringList(), QStringList(invalidParam));
+    QVERIFY(!paramManager->bulkWriteInProgress());
+    QVERIFY(facts[0]->rawValue().toFloat() != stringValue);
+
+    // Without rollback the valid values are written and acknowledged, the invalid one is reported as failed
+    QVERIFY(paramManager->writeParameters(writes));
+    QCOMPARE(paramManager->bulkWriteTotalCount(), 2);
+    QVERIFY(spyComplete.wait(30000));
+    arguments = spyComplete.takeFirst();
+    QCOMPARE(arguments.at(0).toBool(), false);
+    QCOMPARE(arguments.at(1).toStringList(), QStringList(invalidParam));
+    QCOMPARE(facts[0]->rawValue().toFloat(), stringValue);
+    QCOMPARE(facts[1]->rawValue(), invalidFactValue);
+    QCOMPARE(facts[2]->rawValue().toFloat(), static_cast<float>(doubleValue));
+
+    _disconnectMockLink();
+}
+
+/// Loading a parameter file through the parameter editor writes the changes as one transaction
+void ParameterManagerTest::_sendDiff(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    ParameterManager*   paramManager    = _vehicle->parameterManager();
+    const int           componentId     = _vehicle->defaultComponentId();
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("sendDiff.params"));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream stream(&file);
+
+    QList<QPair<Fact*, float>> changes;
+    for (const QString& paramName: paramManager->parameterNames(componentId)) {
+        Fact* fact = paramManager->getParameter(componentId, paramName);
+        if ((fact->type() == FactMetaData::valueTypeFloat) && !fact->readOnly()) {
+            const float fileValue = fact->rawValue().toFloat() + 1.0f;
+            changes.append({ fact, fileValue });
+            stream << _vehicle->id() << "\t" << componentId << "\t" << paramName << "\t" << QString::number(fileValue, 'g', 9) << "\t" << MAV_PARAM_TYPE_REAL32 << "\n";
+            if (changes.count() == 20) {
+                break;
+            }
+        }
+    }
+    QCOMPARE(changes.count(), 20);
+    stream.flush();
+    file.close();
+
+    ParameterEditorController controller;
+    QVERIFY(controller.buildDiffFromFile(fileName));
+    QCOMPARE(controller.diffList()->count(), changes.count());
+
+    // Parameters which aren't selected for loading keep their value
+    const QPair<Fact*, float> skipped = changes.takeLast();
+    const QVariant skippedValue = skipped.first->rawValue();
+    for (int i=0; i<controller.diffList()->count(); i++) {
+        ParameterEditorDiff* paramDiff = controller.diffList()->value<ParameterEditorDiff*>(i);
+        if (paramDiff->name == skipped.first->name()) {
+            paramDiff->load = false;
+        }
+    }
+
+    QSignalSpy spyComplete(paramManager, &ParameterManager::bulkWriteComplete);
+    controller.sendDiff();
+    QVERIFY(paramManager->bulkWriteInProgress());
+    QCOMPARE(paramManager->bulkWriteTotalCount(), changes.count());
+
+    // Facts only change once the vehicle acknowledges the transaction's writes
+    QVERIFY(changes.first().first->rawValue().toFloat() != changes.first().second);
+
+    QVERIFY(spyComplete.wait(30000));
+    QCOMPARE(spyComplete.takeFirst().at(0).toBool(), true);
+    for (const QPair<Fact*, float>& change: changes) {
+        QCOMPARE(change.first->rawValue().toFloat(), change.second);
+    }
+    QCOMPARE(skipped.first->rawValue(), skippedValue);
+
+    _disconnectMockLink();
+}
+
+/// Starts a PX4 MockLink which keeps the same vehicle id across connections, so the second connection finds the
+/// parameter cache written by the first one
+MockLink* ParameterManagerTest::_startFixedIdPX4MockLink(void)
+{
+    MockConfiguration* mockConfig = new MockConfiguration(QStringLiteral("PX4 Fixed Id MockLink"));
+    mockConfig->setFirmwareType(MAV_AUTOPILOT_PX4);
+    mockConfig->setVehicleType(MAV_TYPE_QUADROTOR);
+    mockConfig->setSendStatusText(false);
+    mockConfig->setIncrementVehicleId(false);
+    mockConfig->setDynamic(true);
+
+    LinkManager* linkMgr = qgcApp()->toolbox()->linkManager();
+    SharedLinkConfigurationPtr config = linkMgr->addConfiguration(mockConfig);
+    return linkMgr->createConnectedLink(config) ? qobject_cast<MockLink*>(config->link()) : nullptr;
+}
+
+/// Second connection to the same vehicle loads the autopilot parameters from the cache through _HASH_CHECK
+void ParameterManagerTest::_cacheLoad(void)
+{
+    MultiVehicleManager* vehicleMgr = qgcApp()->toolbox()->multiVehicleManager();
+
+    Q_ASSERT(!_mockLink);
+    _mockLink = _startFixedIdPX4MockLink();
+    QVERIFY(_mockLink);
+    QSignalSpy spyParamsReady(vehicleMgr, SIGNAL(parameterReadyVehicleAvailableChanged(bool)));
+    QCOMPARE(spyParamsReady.wait(60000), true);
+
+    Vehicle* vehicle = vehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    const int vehicleId = vehicle->id();
+    const int componentId = MAV_COMP_ID_AUTOPILOT1;
+
+    // A cache left behind in the previous format is removed when the new one is written
+    const QString oldCacheFileName = ParameterManager::parameterCacheDir().filePath(QStringLiteral("%1_%2.v2").arg(vehicleId).arg(componentId));
+    QVERIFY(QDir().mkpath(ParameterManager::parameterCacheDir().absolutePath()));
+    QFile oldCacheFile(oldCacheFileName);
+    QVERIFY(oldCacheFile.open(QIODevice::WriteOnly));
+    oldCacheFile.close();
+
+    vehicle->parameterManager()->_writeLocalParamCache(vehicleId, componentId);
+    QVERIFY(!QFile::exists(oldCacheFileName));
+
+    const QString cacheFileName = ParameterManager::parameterCacheFile(vehicleId, componentId);
+    quint32 hash = 0;
+    int cachedCount = 0;
+    {
+        ParameterCacheFile cache;
+        QVERIFY(cache.load(cacheFileName));
+        hash = cache.hash();
+        cachedCount = cache.count();
+    }
+    QVERIFY(hash != 0);
+    QCOMPARE(cachedCount, vehicle->parameterManager()->parameterNames(componentId).count());
+
+    _disconnectMockLink();
+
+    // Reconnect with the vehicle reporting the hash of its parameter set
+    _mockLink = _startFixedIdPX4MockLink();
+    QVERIFY(_mockLink);
+    _mockLink->setParamHashCheck(hash);
+    spyParamsReady.clear();
+    QCOMPARE(spyParamsReady.wait(60000), true);
+    QCOMPARE(spyParamsReady.takeFirst().at(0).toBool(), true);
+
+    vehicle = vehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    QCOMPARE(vehicle->id(), vehicleId);
+    QVERIFY(_mockLink->paramHashCheckAcked());
+    QCOMPARE(vehicle->parameterManager()->missingParameters(), false);
+    QCOMPARE(vehicle->parameterManager()->parameterNames(componentId).count(), cachedCount);
+
+    _disconnectMockLink();
+    (void) QFile::remove(cacheFileName);
+}
+
 #if 0
 void ParameterManagerTest::_FTPChangeParam()
 {
@@ -25,10 +25,19 @@ private slots:
     void _requestListMissingParamFail(void);
     void _FTPnoFailure(void);
     // void _FTPChangeParam(void);
+    void _benchmarkParamValueReplay(void);
+    void _lossyLinkLoadTime_data(void);
+    void _lossyLinkLoadTime(void);
+    void _bulkWrite_data(void);
+    void _bulkWrite(void);
+    void _bulkWriteConversion(void);
+    void _sendDiff(void);
+    void _cacheLoad(void);
 
 
 private:
     void _noFailureWorker(MockConfiguration::FailureMode_t failureMode);
+    MockLink* _startFixedIdPX4MockLink(void);
 };
 
 #endif
@@ -0,0 +1,169 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterMetaDataTableTest.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+void ParameterMetaDataTableTest::_writeSourceFile(const QString& fileName, const QByteArray& contents)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    (void) file.write(contents);
+}
+
+QList<ParameterMetaDataTable::Parameter> ParameterMetaDataTableTest::_parameters()
+{
+    QList<ParameterMetaDataTable::Parameter> parameters;
+
+    ParameterMetaDataTable::Parameter parameter;
+    parameter.section           = QStringLiteral("ArduCopter");
+    parameter.name              = QStringLiteral("RTL_ALT");
+    parameter.category          = QStringLiteral("Standard");
+    parameter.group             = QStringLiteral("RTL");
+    parameter.shortDescription  = QStringLiteral("RTL Altitude");
+    parameter.min               = QStringLiteral("200");
+    parameter.max               = QStringLiteral("300000");
+    parameter.units             = QStringLiteral("cm");
+    parameter.increment         = QStringLiteral("1");
+    parameter.rebootRequired    = true;
+    parameters.append(parameter);
+
+    parameter = ParameterMetaDataTable::Parameter();
+    parameter.section           = QStringLiteral("ArduCopter");
+    parameter.name              = QStringLiteral("FRAME_CLASS");
+    parameter.group             = QStringLiteral("FRAME");
+    parameter.values            = { { QStringLiteral("1"), QStringLiteral("Quad") }, { QStringLiteral("2"), QStringLiteral("Hexa") } };
+    parameters.append(parameter);
+
+    parameter = ParameterMetaDataTable::Parameter();
+    parameter.section           = QStringLiteral("libraries");
+    parameter.name              = QStringLiteral("LOG_BITMASK");
+    parameter.type              = 5;
+    parameter.readOnly          = true;
+    parameter.volatileValue     = true;
+    parameter.boolean           = true;
+    parameter.bitmask           = { { QStringLiteral("0"), QStringLiteral("Fast attitude") }, { QStringLiteral("1"), QStringLiteral("Medium attitude") } };
+    parameters.append(parameter);
+
+    return parameters;
+}
+
+void ParameterMetaDataTableTest::_testBuildAndFind()
+{
+    QTemporaryDir tempDir;
+    const QString sourceFile = tempDir.filePath(QStringLiteral("build.xml"));
+    _writeSourceFile(sourceFile, QByteArrayLiteral("<paramfile/>"));
+
+    ParameterMetaDataTable table;
+    QVERIFY(!table.isValid());
+    table.build(sourceFile, _parserVersion, _parameters());
+    QVERIFY(table.isValid());
+    QCOMPARE(table.count(), 3);
+
+    ParameterMetaDataTable::Parameter parameter;
+    QVERIFY(table.find(QStringLiteral("ArduCopter"), QStringLiteral("RTL_ALT"), parameter));
+    QCOMPARE(parameter.name, QStringLiteral("RTL_ALT"));
+    QCOMPARE(parameter.group, QStringLiteral("RTL"));
+    QCOMPARE(parameter.shortDescription, QStringLiteral("RTL Altitude"));
+    QCOMPARE(parameter.min, QStringLiteral("200"));
+    QCOMPARE(parameter.max, QStringLiteral("300000"));
+    QCOMPARE(parameter.units, QStringLiteral("cm"));
+    QCOMPARE(parameter.increment, QStringLiteral("1"));
+    QVERIFY(parameter.longDescription.isEmpty());
+    QCOMPARE(parameter.type, -1);
+    QVERIFY(parameter.rebootRequired);
+    QVERIFY(!parameter.readOnly);
+
+    QVERIFY(table.find(QStringLiteral("ArduCopter"), QStringLiteral("FRAME_CLASS"), parameter));
+    QCOMPARE(parameter.values.count(), 2);
+    QCOMPARE(parameter.values[1].first, QStringLiteral("2"));
+    QCOMPARE(parameter.values[1].second, QStringLiteral("Hexa"));
+    QVERIFY(parameter.bitmask.isEmpty());
+
+    QVERIFY(table.find(QStringLiteral("libraries"), QStringLiteral("LOG_BITMASK"), parameter));
+    QCOMPARE(parameter.type, 5);
+    QVERIFY(parameter.readOnly);
+    QVERIFY(parameter.volatileValue);
+    QVERIFY(parameter.boolean);
+    QVERIFY(parameter.values.isEmpty());
+    QCOMPARE(parameter.bitmask.count(), 2);
+    QCOMPARE(parameter.bitmask[0].second, QStringLiteral("Fast attitude"));
+
+    // Names are only found in their own section
+    QVERIFY(!table.find(QStringLiteral("libraries"), QStringLiteral("RTL_ALT"), parameter));
+    QVERIFY(!table.find(QStringLiteral("ArduCopter"), QStringLiteral("NOT_A_PARAM"), parameter));
+
+    QCOMPARE(table.names(QStringLiteral("ArduCopter")), QStringList({ QStringLiteral("FRAME_CLASS"), QStringLiteral("RTL_ALT") }));
+    QCOMPARE(table.names(QStringLiteral("libraries")), QStringList({ QStringLiteral("LOG_BITMASK") }));
+    QVERIFY(table.names(QStringLiteral("ArduPlane")).isEmpty());
+
+    (void) QFile::remove(ParameterMetaDataTable::cacheFileName(sourceFile));
+}
+
+void ParameterMetaDataTableTest::_testLoadFromCache()
+{
+    QTemporaryDir tempDir;
+    const QString sourceFile = tempDir.filePath(QStringLiteral("cache.xml"));
+    _writeSourceFile(sourceFile, QByteArrayLiteral("<paramfile/>"));
+    (void) QFile::remove(ParameterMetaDataTable::cacheFileName(sourceFile));
+
+    {
+        ParameterMetaDataTable table;
+        QVERIFY(!table.load(sourceFile, _parserVersion));
+        table.build(sourceFile, _parserVersion, _parameters());
+    }
+    QVERIFY(QFile::exists(ParameterMetaDataTable::cacheFileName(sourceFile)));
+
+    ParameterMetaDataTable table;
+    QVERIFY(table.load(sourceFile, _parserVersion));
+    QCOMPARE(table.count(), 3);
+
+    ParameterMetaDataTable::Parameter parameter;
+    QVERIFY(table.find(QStringLiteral("ArduCopter"), QStringLiteral("FRAME_CLASS"), parameter));
+    QCOMPARE(parameter.values[0].second, QStringLiteral("Quad"));
+    QVERIFY(table.find(QStringLiteral("libraries"), QStringLiteral("LOG_BITMASK"), parameter));
+    QCOMPARE(parameter.bitmask[1].second, QStringLiteral("Medium attitude"));
+
+    (void) QFile::remove(ParameterMetaDataTable::cacheFileName(sourceFile));
+}
+
+void ParameterMetaDataTableTest::_testStaleCache()
+{
+    QTemporaryDir tempDir;
+    const QString sourceFile = tempDir.filePath(QStringLiteral("stale.xml"));
+    _writeSourceFile(sourceFile, QByteArrayLiteral("<paramfile/>"));
+
+    {
+        ParameterMetaDataTable table;
+        table.build(sourceFile, _parserVersion, _parameters());
+    }
+
+    // Cache from a different parser is ignored
+    ParameterMetaDataTable table;
+    QVERIFY(!table.load(sourceFile, _parserVersion + 1));
+    QVERIFY(!table.isValid());
+    QVERIFY(table.load(sourceFile, _parserVersion));
+
+    // Changing the source file invalidates the cache
+    _writeSourceFile(sourceFile, QByteArrayLiteral("<paramfile></paramfile>"));
+    QVERIFY(!table.load(sourceFile, _parserVersion));
+
+    // So does a damaged cache file
+    table.build(sourceFile, _parserVersion, _parameters());
+    QFile cacheFile(ParameterMetaDataTable::cacheFileName(sourceFile));
+    QVERIFY(cacheFile.open(QIODevice::ReadWrite));
+    QVERIFY(cacheFile.resize(cacheFile.size() / 2));
+    cacheFile.close();
+    QVERIFY(!table.load(sourceFile, _parserVersion));
+
+    (void) QFile::remove(ParameterMetaDataTable::cacheFileName(sourceFile));
+}
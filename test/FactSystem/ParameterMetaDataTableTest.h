@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "ParameterMetaDataTable.h"
+
+class ParameterMetaDataTableTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testBuildAndFind();
+    void _testLoadFromCache();
+    void _testStaleCache();
+
+private:
+    void _writeSourceFile(const QString& fileName, const QByteArray& contents);
+    QList<ParameterMetaDataTable::Parameter> _parameters();
+
+    static constexpr quint32 _parserVersion = 1;
+};
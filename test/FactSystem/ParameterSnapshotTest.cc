@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterSnapshotTest.h"
+#include "ParameterSnapshot.h"
+#include "ParameterManager.h"
+#include "Vehicle.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
+#include <QtTest/QTest>
+
+void ParameterSnapshotTest::_writeFile(const QString& fileName, const QByteArray& contents)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    (void) file.write(contents);
+}
+
+void ParameterSnapshotTest::_testFromStream()
+{
+    QByteArray contents(
+        "# Onboard parameters for Vehicle 1\n"
+        "#\n"
+        "1\t1\tSYS_AUTOSTART\t4001\t6\n"
+        "1\t1\tBAT1_V_CHARGED\t4.05000019073486328\t9\n"
+        "1\t1\tMAV_TYPE\t2\t1\n"
+        "1\t1\tSYS_AUTOSTART\t4010\t6\n");
+    QTextStream stream(&contents);
+
+    QString errorString;
+    const ParameterSnapshot snapshot = ParameterSnapshot::fromStream(stream, errorString);
+    QVERIFY(errorString.isEmpty());
+    QCOMPARE(snapshot.vehicleId(), 1);
+    QCOMPARE(snapshot.count(), 3);
+
+    // Sorted by name, last value for a duplicate wins
+    QCOMPARE(snapshot.entries()[0].name, QStringLiteral("BAT1_V_CHARGED"));
+    QCOMPARE(snapshot.entries()[0].value, QVariant(4.05f));
+    QCOMPARE(snapshot.entries()[0].type, FactMetaData::valueTypeFloat);
+    const ParameterSnapshot::Entry* entry = snapshot.find(1, QStringLiteral("SYS_AUTOSTART"));
+    QVERIFY(entry);
+    QCOMPARE(entry->value.toInt(), 4010);
+    QVERIFY(!snapshot.find(2, QStringLiteral("SYS_AUTOSTART")));
+
+    QByteArray badContents("1\t1\tSYS_AUTOSTART\t4001\n");
+    QTextStream badStream(&badContents);
+    QVERIFY(ParameterSnapshot::fromStream(badStream, errorString).isEmpty());
+    QVERIFY(!errorString.isEmpty());
+}
+
+void ParameterSnapshotTest::_testDiff()
+{
+    const ParameterSnapshot golden(1, {
+        { 1, QStringLiteral("A"), FactMetaData::valueTypeInt32, QVariant(1) },
+        { 1, QStringLiteral("B"), FactMetaData::valueTypeFloat, QVariant(2.5f) },
+        { 1, QStringLiteral("C"), FactMetaData::valueTypeUint8, QVariant(3u) },
+        { 2, QStringLiteral("A"), FactMetaData::valueTypeInt32, QVariant(4) },
+    });
+    const ParameterSnapshot other(2, {
+        { 2, QStringLiteral("A"), FactMetaData::valueTypeInt32, QVariant(4) },
+        { 1, QStringLiteral("C"), FactMetaData::valueTypeUint8, QVariant(3) },      // Same value in another variant type
+        { 1, QStringLiteral("B"), FactMetaData::valueTypeFloat, QVariant(2.75f) },
+        { 1, QStringLiteral("D"), FactMetaData::valueTypeInt32, QVariant(5) },
+    });
+
+    QVERIFY(golden.diff(golden).isEmpty());
+
+    const QList<ParameterSnapshot::Difference> differences = golden.diff(other);
+    QCOMPARE(differences.count(), 3);
+
+    QCOMPARE(differences[0].kind, ParameterSnapshot::Difference::OnlyInThis);
+    QCOMPARE(differences[0].name, QStringLiteral("A"));
+    QCOMPARE(differences[0].componentId, 1);
+
+    QCOMPARE(differences[1].kind, ParameterSnapshot::Difference::ValueChanged);
+    QCOMPARE(differences[1].name, QStringLiteral("B"));
+    QCOMPARE(differences[1].value, QVariant(2.5f));
+    QCOMPARE(differences[1].otherValue, QVariant(2.75f));
+
+    QCOMPARE(differences[2].kind, ParameterSnapshot::Difference::OnlyInOther);
+    QCOMPARE(differences[2].name, QStringLiteral("D"));
+    QCOMPARE(differences[2].otherValue, QVariant(5));
+}
+
+void ParameterSnapshotTest::_testCompareFiles()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QString goldenFile = tempDir.filePath(QStringLiteral("golden.params"));
+    _writeFile(goldenFile, "1\t1\tSYS_AUTOSTART\t4001\t6\n1\t1\tMAV_TYPE\t2\t1\n");
+    _writeFile(tempDir.filePath(QStringLiteral("airframe1.params")), "2\t1\tMAV_TYPE\t2\t1\n3\t1\tSYS_AUTOSTART\t4001\t6\n");
+
+    QString output;
+    QTextStream outputStream(&output);
+    QCOMPARE(ParameterSnapshot::compareFiles(goldenFile, tempDir.path(), outputStream), 0);
+    QVERIFY(output.contains(QStringLiteral("airframe1.params: 0 differences")));
+
+    _writeFile(tempDir.filePath(QStringLiteral("airframe2.params")), "4\t1\tSYS_AUTOSTART\t4010\t6\n");
+    output.clear();
+    QCOMPARE(ParameterSnapshot::compareFiles(goldenFile, tempDir.path(), outputStream), 1);
+    QVERIFY(output.contains(QStringLiteral("airframe2.params: 2 differences")));
+    QVERIFY(output.contains(QStringLiteral("SYS_AUTOSTART\t4001 -> 4010")));
+    QVERIFY(output.contains(QStringLiteral("MAV_TYPE\t2 -> missing")));
+
+    QCOMPARE(ParameterSnapshot::compareFiles(tempDir.filePath(QStringLiteral("missing.params")), tempDir.path(), outputStream), -1);
+}
+
+/// A vehicle's snapshot must match the parameter file the vehicle writes
+void ParameterSnapshotTest::_testVehicleSnapshot()
+{
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+
+    ParameterManager* paramManager = _vehicle->parameterManager();
+    const ParameterSnapshot snapshot = paramManager->snapshot();
+    QVERIFY(!snapshot.isEmpty());
+    QCOMPARE(snapshot.vehicleId(), _vehicle->id());
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("vehicle.params"));
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+        QTextStream stream(&file);
+        paramManager->writeParametersToStream(stream);
+    }
+
+    QString errorString;
+    const ParameterSnapshot fileSnapshot = ParameterSnapshot::fromFile(fileName, errorString);
+    QVERIFY(errorString.isEmpty());
+    QCOMPARE(fileSnapshot.count(), snapshot.count());
+    QVERIFY(snapshot.diff(fileSnapshot).isEmpty());
+    QVERIFY(paramManager->compareToFile(fileName).isEmpty());
+
+    // Change one value on the vehicle side
+    const ParameterSnapshot::Entry& first = snapshot.entries().first();
+    Fact* fact = paramManager->getParameter(first.componentId, first.name);
+    fact->_containerSetRawValue(QVariant(fact->rawValue().toDouble() + 1));
+
+    const QVariantList differences = paramManager->compareToFile(fileName);
+    QCOMPARE(differences.count(), 1);
+    const QVariantMap difference = differences.first().toMap();
+    QCOMPARE(difference[QStringLiteral("name")].toString(), first.name);
+    QCOMPARE(difference[QStringLiteral("missingOnVehicle")].toBool(), false);
+    QCOMPARE(difference[QStringLiteral("missingInFile")].toBool(), false);
+
+    _disconnectMockLink();
+}
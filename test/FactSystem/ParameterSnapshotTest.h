@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class ParameterSnapshotTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testFromStream();
+    void _testDiff();
+    void _testCompareFiles();
+    void _testVehicleSnapshot();
+
+private:
+    void _writeFile(const QString& fileName, const QByteArray& contents);
+};
@@ -0,0 +1,316 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainTileTest.h"
+#include "ElevationMapProvider.h"
+#include "MapsSettings.h"
+#include "QGCApplication.h"
+#include "QGCMapUrlEngine.h"
+#include "SettingsManager.h"
+#include "TerrainQueryInterface.h"
+#include "TerrainTileCopernicus.h"
+#include "TerrainTileManager.h"
+
+#include <QtCore/QtMath>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace {
+
+/// Records the tile downloads instead of going to the network, the test completes them through _tileDownloaded
+class FakeDownloadTileManager : public TerrainTileManager
+{
+public:
+    QList<quint64> downloadedTiles;
+
+private:
+    void _downloadTile(quint64 key) override { downloadedTiles.append(key); }
+};
+
+} // namespace
+
+/// 3x3 tile with 0.01 degree cells starting at 0,0. Each value is 10 * row + column, rows run south to north.
+QByteArray TerrainTileTest::_tileData()
+{
+    static const char *json = R"({
+        "status": "success",
+        "data": {
+            "bounds": { "sw": [ 0.0, 0.0 ], "ne": [ 0.03, 0.03 ] },
+            "stats": { "min": 0, "max": 22, "avg": 11 },
+            "carpet": [ [ 0, 1, 2 ], [ 10, 11, 12 ], [ 20, 21, 22 ] ]
+        }
+    })";
+
+    return TerrainTileCopernicus::serializeFromJson(QByteArray(json));
+}
+
+quint64 TerrainTileTest::_tileKey(const QGeoCoordinate &coordinate)
+{
+    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(CopernicusElevationProvider::kProviderKey);
+    return TerrainTileManager::_tileKey(provider->long2tileX(coordinate.longitude(), 1), provider->lat2tileY(coordinate.latitude(), 1), 1);
+}
+
+void TerrainTileTest::_testElevation()
+{
+    const TerrainTile tile(_tileData());
+    QVERIFY(tile.isValid());
+    QCOMPARE(tile.minElevation(), 0.0);
+    QCOMPARE(tile.maxElevation(), 22.0);
+
+    // Cell centers return the cell value
+    QVERIFY(qAbs(tile.elevation(QGeoCoordinate(0.005, 0.005))) < 0.001);
+    QVERIFY(qAbs(tile.elevation(QGeoCoordinate(0.015, 0.025)) - 12.0) < 0.001);
+    QVERIFY(qAbs(tile.elevation(QGeoCoordinate(0.025, 0.015)) - 21.0) < 0.001);
+
+    // Between cell centers the values are interpolated
+    QVERIFY(qAbs(tile.elevation(QGeoCoordinate(0.01, 0.01)) - 5.5) < 0.001);
+    QVERIFY(qAbs(tile.elevation(QGeoCoordinate(0.005, 0.0125)) - 0.75) < 0.001);
+    QVERIFY(qAbs(tile.elevation(QGeoCoordinate(0.02, 0.025)) - 17.0) < 0.001);
+
+    // Between the outermost centers and the tile edge the edge values are used
+    QVERIFY(qAbs(tile.elevation(QGeoCoordinate(0.001, 0.001))) < 0.001);
+    QVERIFY(qAbs(tile.elevation(QGeoCoordinate(0.029, 0.029)) - 22.0) < 0.001);
+
+    // Outside of the tile
+    QVERIFY(qIsNaN(tile.elevation(QGeoCoordinate(-0.001, 0.01))));
+    QVERIFY(qIsNaN(tile.elevation(QGeoCoordinate(0.01, 0.031))));
+}
+
+void TerrainTileTest::_testElevations()
+{
+    const TerrainTile tile(_tileData());
+    QVERIFY(tile.isValid());
+
+    QList<QGeoCoordinate> coordinates;
+    for (int i = 0; i <= 40; i++) {
+        for (int j = 0; j <= 40; j++) {
+            // Also covers coordinates outside of the tile
+            coordinates.append(QGeoCoordinate(-0.002 + (i * 0.0008), -0.002 + (j * 0.0008)));
+        }
+    }
+
+    const QList<double> elevations = tile.elevations(coordinates);
+    QCOMPARE(elevations.count(), coordinates.count());
+    for (qsizetype i = 0; i < coordinates.count(); i++) {
+        const double elevation = tile.elevation(coordinates[i]);
+        if (qIsNaN(elevation)) {
+            QVERIFY(qIsNaN(elevations[i]));
+        } else {
+            QVERIFY(qAbs(elevations[i] - elevation) < 0.001);
+        }
+    }
+
+    QVERIFY(tile.elevations(QList<QGeoCoordinate>()).isEmpty());
+}
+
+void TerrainTileTest::_testInvalidTile()
+{
+    const TerrainTile emptyTile;
+    QVERIFY(!emptyTile.isValid());
+    QVERIFY(qIsNaN(emptyTile.elevation(QGeoCoordinate(0.01, 0.01))));
+    QCOMPARE(emptyTile.elevations({ QGeoCoordinate(0.01, 0.01) }).count(), 1);
+    QVERIFY(qIsNaN(emptyTile.elevations({ QGeoCoordinate(0.01, 0.01) }).first()));
+
+    // Too short for the header
+    const TerrainTile headerTile(QByteArray(4, 0));
+    QVERIFY(!headerTile.isValid());
+
+    // Too short for the grid
+    const TerrainTile truncatedTile(_tileData().chopped(2));
+    QVERIFY(!truncatedTile.isValid());
+}
+
+void TerrainTileTest::_testTileCache()
+{
+    TerrainTileManager manager;
+    const TerrainTile tile(_tileData());
+    QVERIFY(tile.isValid());
+
+    // Room for two tiles
+    manager.setMaxCacheSize((tile.memorySize() * 2) + (tile.memorySize() / 2));
+
+    manager._cacheTile(_tileData(), TerrainTileManager::_tileKey(1, 1, 1));
+    manager._cacheTile(_tileData(), TerrainTileManager::_tileKey(2, 1, 1));
+    QCOMPARE(manager.cachedTileCount(), 2);
+    QCOMPARE(manager.cacheSize(), tile.memorySize() * 2);
+    QCOMPARE(manager.cacheEvictions(), 0ULL);
+
+    // Using the first tile makes the second one the least recently used
+    QVERIFY(manager._getCachedTile(TerrainTileManager::_tileKey(1, 1, 1)));
+    QCOMPARE(manager.cacheHits(), 1ULL);
+
+    manager._cacheTile(_tileData(), TerrainTileManager::_tileKey(3, 1, 1));
+    QCOMPARE(manager.cachedTileCount(), 2);
+    QCOMPARE(manager.cacheEvictions(), 1ULL);
+    QVERIFY(manager._getCachedTile(TerrainTileManager::_tileKey(1, 1, 1)));
+    QVERIFY(manager._getCachedTile(TerrainTileManager::_tileKey(3, 1, 1)));
+    QVERIFY(!manager._getCachedTile(TerrainTileManager::_tileKey(2, 1, 1)));
+    QCOMPARE(manager.cacheHits(), 3ULL);
+    QCOMPARE(manager.cacheMisses(), 1ULL);
+
+    // Invalid tiles are not cached
+    manager._cacheTile(QByteArray(4, 0), TerrainTileManager::_tileKey(4, 1, 1));
+    QVERIFY(!manager._getCachedTile(TerrainTileManager::_tileKey(4, 1, 1)));
+
+    // Shrinking the cache evicts down to the new bound
+    manager.setMaxCacheSize(tile.memorySize());
+    QCOMPARE(manager.cachedTileCount(), 1);
+    QCOMPARE(manager.cacheEvictions(), 2ULL);
+}
+
+void TerrainTileTest::_testTileRequests()
+{
+    TerrainTileManager manager;
+
+    // Each missing tile is queued once no matter how many queries need it
+    manager._requestTile(1, 1, 1);
+    manager._requestTile(2, 1, 1);
+    manager._requestTile(1, 1, 1);
+    QCOMPARE(manager._pendingDownloads.count(), 2);
+    QCOMPARE(manager._requestedTiles.count(), 2);
+    QCOMPARE(manager._downloadsInFlight, 0);
+
+    // Copernicus tiles are tileSizeDegrees squares counted from -180, -90
+    const QGeoCoordinate coordinate(47.3977, 8.5456);
+    const QGeoCoordinate otherCoordinate(47.4177, 8.5456);
+    const quint64 key = TerrainTileManager::_tileKey(
+        qFloor((coordinate.longitude() + 180.0) / TerrainTileCopernicus::tileSizeDegrees),
+        qFloor((coordinate.latitude() + 90.0) / TerrainTileCopernicus::tileSizeDegrees),
+        1
+    );
+    QVERIFY(TerrainTileManager::_coordinatesInTile({ otherCoordinate, coordinate }, key));
+    QVERIFY(!TerrainTileManager::_coordinatesInTile({ otherCoordinate }, key));
+}
+
+void TerrainTileTest::_testConcurrentDownloads()
+{
+    FakeDownloadTileManager manager;
+    manager.setMaxConcurrentDownloads(2);
+
+    // One query over three missing tiles, more than there are download slots
+    TerrainQueryInterface queryA;
+    const QList<QGeoCoordinate> coordinatesA = { QGeoCoordinate(0.005, 0.015), QGeoCoordinate(0.005, 0.025), QGeoCoordinate(0.015, 0.005) };
+    manager.addCoordinateQuery(&queryA, coordinatesA);
+    QCOMPARE(manager.downloadedTiles.count(), 2);
+    QCOMPARE(manager._downloadsInFlight, 2);
+    QCOMPARE(manager._pendingDownloads.count(), 1);
+    QCOMPARE(manager._requestQueue.count(), 1);
+
+    // A second query waits for a slot as well
+    TerrainQueryInterface queryB;
+    manager.addCoordinateQuery(&queryB, { QGeoCoordinate(0.005, 0.005) });
+    QCOMPARE(manager.downloadedTiles.count(), 2);
+    QCOMPARE(manager._downloadsInFlight, 2);
+    QCOMPARE(manager._pendingDownloads.count(), 2);
+
+    // Each finished download starts the next pending one
+    manager._tileDownloaded(manager.downloadedTiles[0], _tileData(), false);
+    QCOMPARE(manager.downloadedTiles.count(), 3);
+    QVERIFY(manager._downloadsInFlight <= manager.maxConcurrentDownloads());
+    QCOMPARE(manager.downloadedTiles[2], _tileKey(coordinatesA[2]));
+
+    // Raising the limit starts the remaining download right away
+    manager.setMaxConcurrentDownloads(3);
+    QCOMPARE(manager.downloadedTiles.count(), 4);
+    QCOMPARE(manager._downloadsInFlight, 3);
+    QVERIFY(manager._pendingDownloads.isEmpty());
+}
+
+void TerrainTileTest::_testDownloadLimitSetting()
+{
+    Fact* const maxDownloadsFact = qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxConcurrentTerrainDownloads();
+    const QVariant savedValue = maxDownloadsFact->rawValue();
+
+    // The limit comes from the setting without any UI around, and follows changes to it
+    maxDownloadsFact->setRawValue(3);
+    FakeDownloadTileManager manager;
+    QCOMPARE(manager.maxConcurrentDownloads(), 3);
+
+    TerrainQueryInterface query;
+    const QList<QGeoCoordinate> coordinates = { QGeoCoordinate(0.005, 0.005), QGeoCoordinate(0.005, 0.015), QGeoCoordinate(0.005, 0.025), QGeoCoordinate(0.015, 0.005) };
+    manager.addCoordinateQuery(&query, coordinates);
+    QCOMPARE(manager._downloadsInFlight, 3);
+
+    maxDownloadsFact->setRawValue(4);
+    QCOMPARE(manager.maxConcurrentDownloads(), 4);
+    QCOMPARE(manager._downloadsInFlight, 4);
+
+    maxDownloadsFact->setRawValue(savedValue);
+}
+
+void TerrainTileTest::_testDownloadFailure()
+{
+    FakeDownloadTileManager manager;
+    manager.setMaxConcurrentDownloads(2);
+
+    TerrainQueryInterface queryA;
+    TerrainQueryInterface queryB;
+    QSignalSpy spyA(&queryA, &TerrainQueryInterface::coordinateHeightsReceived);
+    QSignalSpy spyB(&queryB, &TerrainQueryInterface::coordinateHeightsReceived);
+
+    const QList<QGeoCoordinate> coordinatesA = { QGeoCoordinate(0.005, 0.015), QGeoCoordinate(0.005, 0.025), QGeoCoordinate(0.015, 0.005) };
+    const QGeoCoordinate coordinateB(0.005, 0.005);
+    manager.addCoordinateQuery(&queryA, coordinatesA);
+    manager.addCoordinateQuery(&queryB, { coordinateB });
+    QCOMPARE(manager.downloadedTiles.count(), 2);
+
+    // A failed tile only fails the queries which need it
+    manager._tileDownloaded(_tileKey(coordinatesA[0]), QByteArray(), false);
+    QCOMPARE(spyA.count(), 1);
+    QCOMPARE(spyA.first().at(0).toBool(), false);
+    QCOMPARE(spyB.count(), 0);
+    QCOMPARE(manager._requestQueue.count(), 1);
+
+    // The freed slot went to the next pending tile
+    QCOMPARE(manager.downloadedTiles.count(), 3);
+    QCOMPARE(manager._downloadsInFlight, 2);
+
+    // The tiles of the failed query still complete, then the other query gets its tile
+    manager._tileDownloaded(_tileKey(coordinatesA[1]), _tileData(), false);
+    QCOMPARE(manager.downloadedTiles.count(), 4);
+    QCOMPARE(manager.downloadedTiles.last(), _tileKey(coordinateB));
+    QVERIFY(manager._downloadsInFlight <= manager.maxConcurrentDownloads());
+    QCOMPARE(spyB.count(), 0);
+
+    manager._tileDownloaded(_tileKey(coordinateB), _tileData(), true);
+    QCOMPARE(spyB.count(), 1);
+    QCOMPARE(spyB.first().at(0).toBool(), true);
+    QCOMPARE(spyB.first().at(1).value<QList<double>>().count(), 1);
+    QCOMPARE(manager.diskCacheHits(), 1ULL);
+    QVERIFY(manager._requestQueue.isEmpty());
+    QCOMPARE(spyA.count(), 1);
+}
+
+void TerrainTileTest::_testTilesForPolygon()
+{
+    const std::shared_ptr<const CopernicusElevationProvider> provider = std::dynamic_pointer_cast<const CopernicusElevationProvider>(
+        UrlFactory::getMapProviderFromProviderType(CopernicusElevationProvider::kProviderKey));
+    QVERIFY(provider);
+
+    // Triangle over a 3x3 block of tiles starting at 0,0, the tiles beyond its long edge are not needed
+    const QList<QGeoCoordinate> triangle = {
+        QGeoCoordinate(0.0005, 0.0005),
+        QGeoCoordinate(0.0005, 0.0285),
+        QGeoCoordinate(0.0285, 0.0005),
+    };
+    const int x0 = provider->long2tileX(0.0, 1);
+    const int y0 = provider->lat2tileY(0.0, 1);
+
+    const QList<QPoint> tiles = provider->getTilesForPolygon(triangle);
+    QCOMPARE(tiles.count(), 6);
+    for (const QPoint &tile : { QPoint(0, 0), QPoint(1, 0), QPoint(2, 0), QPoint(0, 1), QPoint(1, 1), QPoint(0, 2) }) {
+        QVERIFY(tiles.contains(QPoint(x0, y0) + tile));
+    }
+
+    // The bounding box would need all nine
+    QCOMPARE(provider->getTileCount(1, 0.0005, 0.0285, 0.0285, 0.0005).tileCount, 9ULL);
+
+    QVERIFY(provider->getTilesForPolygon(triangle.mid(0, 2)).isEmpty());
+}
@@ -0,0 +1,35 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QGeoCoordinate;
+
+class TerrainTileTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testElevation();
+    void _testElevations();
+    void _testInvalidTile();
+    void _testTileCache();
+    void _testTileRequests();
+    void _testConcurrentDownloads();
+    void _testDownloadFailure();
+    void _testDownloadLimitSetting();
+    void _testTilesForPolygon();
+
+private:
+    static QByteArray _tileData();
+    /// Key of the tile which holds @a coordinate
+    static quint64 _tileKey(const QGeoCoordinate &coordinate);
+};
@@ -29,12 +29,25 @@
 // #include "RadioConfigTest.h"
 
 // Comms
+#include "LinkInterfaceTest.h"
+#include "LogReplayLinkTest.h"
+#include "MAVLinkForwardRouteTest.h"
+#include "MAVLinkParserTest.h"
 #include "QGCSerialPortInfoTest.h"
+#include "TLogIndexTest.h"
+#include "TLogWriterTest.h"
+#include "UDPLinkTest.h"
 
 // FactSystem
 #include "FactSystemTestGeneric.h"
 #include "FactSystemTestPX4.h"
+#include "FactUpdateSchedulerTest.h"
+#include "FactTypedSetterTest.h"
+#include "FactMetaDataCacheTest.h"
+#include "ParameterCacheFileTest.h"
 #include "ParameterManagerTest.h"
+#include "ParameterMetaDataTableTest.h"
+#include "ParameterSnapshotTest.h"
 
 // FollowMe
 #include "FollowMeTest.h"
@@ -81,6 +94,7 @@
 
 // Terrain
 #include "TerrainQueryTest.h"
+#include "TerrainTileTest.h"
 
 // UI
 
@@ -93,6 +107,8 @@
 #include "ComponentInformationCacheTest.h"
 #include "ComponentInformationTranslationTest.h"
 #include "FTPManagerTest.h"
+#include "TerrainProtocolHandlerTest.h"
+#include "VehicleMessageDispatchTest.h"
 // #include "InitialConnectTest.h"
 // #include "RequestMessageTest.h"
 // #include "SendMavCommandWithHandlerTest.h"
@@ -125,12 +141,25 @@ int runTests(bool stress, QStringView unitTestOptions)
 	// UT_REGISTER_TEST(RadioConfigTest)
 
 	// Comms
+	UT_REGISTER_TEST(LinkInterfaceTest)
+	UT_REGISTER_TEST(LogReplayLinkTest)
+	UT_REGISTER_TEST(MAVLinkForwardRouteTest)
+	UT_REGISTER_TEST(MAVLinkParserTest)
 	UT_REGISTER_TEST(QGCSerialPortInfoTest)
+	UT_REGISTER_TEST(TLogIndexTest)
+	UT_REGISTER_TEST(TLogWriterTest)
+	UT_REGISTER_TEST(UDPLinkTest)
 
 	// FactSystem
 	UT_REGISTER_TEST(FactSystemTestGeneric)
 	UT_REGISTER_TEST(FactSystemTestPX4)
+	UT_REGISTER_TEST(FactUpdateSchedulerTest)
+	UT_REGISTER_TEST(FactTypedSetterTest)
+	UT_REGISTER_TEST(FactMetaDataCacheTest)
+	UT_REGISTER_TEST(ParameterCacheFileTest)
 	UT_REGISTER_TEST(ParameterManagerTest)
+	UT_REGISTER_TEST(ParameterMetaDataTableTest)
+	UT_REGISTER_TEST(ParameterSnapshotTest)
 
 	// FollowMe
 	UT_REGISTER_TEST(FollowMeTest)
@@ -175,6 +204,7 @@ int runTests(bool stress, QStringView unitTestOptions)
 
 	// Terrain
 	UT_REGISTER_TEST(TerrainQueryTest)
+	UT_REGISTER_TEST(TerrainTileTest)
 
 	// UI
 
@@ -187,6 +217,8 @@ int runTests(bool stress, QStringView unitTestOptions)
 	UT_REGISTER_TEST(ComponentInformationCacheTest)
 	UT_REGISTER_TEST(ComponentInformationTranslationTest)
 	UT_REGISTER_TEST(FTPManagerTest)
+	UT_REGISTER_TEST(TerrainProtocolHandlerTest)
+	UT_REGISTER_TEST(VehicleMessageDispatchTest)
 	// UT_REGISTER_TEST(InitialConnectTest)
 	// UT_REGISTER_TEST(RequestMessageTest)
 	// UT_REGISTER_TEST(SendMavCommandWithHandlerTest)
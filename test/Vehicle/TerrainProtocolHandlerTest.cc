@@ -0,0 +1,121 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainProtocolHandlerTest.h"
+#include "TerrainProtocolHandler.h"
+#include "TerrainTileManager.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "MockLink.h"
+#include "UDPLink.h"
+#include "Vehicle.h"
+#ifndef NO_SERIAL_LINK
+#include "SerialLink.h"
+#endif
+
+#include <QtTest/QTest>
+
+void TerrainProtocolHandlerTest::_testGridCoordinates()
+{
+    const QGeoCoordinate gridSWCorner(47.3977, 8.5456);
+    const double gridSpacing = 100;
+    const QList<int> gridBits = { 0, 7, 27, 48, 55 };
+
+    QList<QGeoCoordinate> blockCoordinates;
+    for (const int gridBit : gridBits) {
+        const QList<QGeoCoordinate> coordinates = TerrainProtocolHandler::_gridCoordinates(gridSWCorner, gridSpacing, 1ull << gridBit);
+        QCOMPARE(coordinates.count(), 16);
+
+        // Positions the way they were computed before, one atDistanceAndAzimuth step east and then north for each offset
+        const double blockSpacing = gridSpacing * 4;
+        QGeoCoordinate blockSWCorner = gridSWCorner.atDistanceAndAzimuth(blockSpacing * (gridBit % 8), 90);
+        blockSWCorner = blockSWCorner.atDistanceAndAzimuth(blockSpacing * (gridBit / 8), 0);
+        for (int row=0; row<4; row++) {
+            for (int col=0; col<4; col++) {
+                QGeoCoordinate expected = blockSWCorner.atDistanceAndAzimuth(gridSpacing * col, 90);
+                expected = expected.atDistanceAndAzimuth(gridSpacing * row, 0);
+                QVERIFY2(coordinates[(row * 4) + col].distanceTo(expected) < 1.0, qPrintable(QStringLiteral("gridBit %1 row %2 col %3").arg(gridBit).arg(row).arg(col)));
+            }
+        }
+        blockCoordinates.append(coordinates);
+    }
+
+    // Several blocks in one mask come back as the single block results in gridBit order
+    uint64_t mask = 0;
+    for (const int gridBit : gridBits) {
+        mask |= 1ull << gridBit;
+    }
+    QCOMPARE(TerrainProtocolHandler::_gridCoordinates(gridSWCorner, gridSpacing, mask), blockCoordinates);
+    QVERIFY(TerrainProtocolHandler::_gridCoordinates(gridSWCorner, gridSpacing, 0).isEmpty());
+}
+
+void TerrainProtocolHandlerTest::_testBlocksPerTick()
+{
+    // Network links get the whole 8x7 grid in one tick
+    UDPConfiguration udpConfig(QStringLiteral("TerrainProtocolHandlerTest"));
+    QCOMPARE(TerrainProtocolHandler::_blocksPerTick(&udpConfig), 56);
+
+#ifndef NO_SERIAL_LINK
+    // A quarter of 57600 baud at 12 ticks a second is 120 bytes per tick, room for two TERRAIN_DATA messages
+    SerialConfiguration serialConfig(QStringLiteral("TerrainProtocolHandlerTest"));
+    serialConfig.setBaud(57600);
+    QCOMPARE(TerrainProtocolHandler::_blocksPerTick(&serialConfig), 2);
+
+    // Slow links still send one block per tick
+    serialConfig.setBaud(1200);
+    QCOMPARE(TerrainProtocolHandler::_blocksPerTick(&serialConfig), 1);
+#endif
+}
+
+void TerrainProtocolHandlerTest::_testRepeatedRequest()
+{
+    _connectMockLinkNoInitialConnectSequence();
+    Vehicle* vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    QVERIFY(vehicle);
+
+    TerrainProtocolHandler handler(vehicle, qobject_cast<TerrainFactGroup*>(vehicle->terrainFactGroup()));
+    const TerrainTileManager* const tileManager = TerrainTileManager::instance();
+
+    mavlink_terrain_request_t terrainRequest{};
+    terrainRequest.lat = 473977000;
+    terrainRequest.lon = 85456000;
+    terrainRequest.grid_spacing = 100;
+    terrainRequest.mask = 0x7;
+    mavlink_message_t message;
+    (void) mavlink_msg_terrain_request_encode_chan(static_cast<uint8_t>(vehicle->id()), MAV_COMP_ID_AUTOPILOT1, _mockLink->mavlinkChannel(), &message, &terrainRequest);
+
+    // A new grid looks up its blocks
+    quint64 lookups = tileManager->cacheHits() + tileManager->cacheMisses();
+    QVERIFY(!handler.mavlinkMessageReceived(message));
+    QVERIFY((tileManager->cacheHits() + tileManager->cacheMisses()) > lookups);
+
+    // Stand in for the terrain tiles arriving
+    for (int gridBit=0; gridBit<3; gridBit++) {
+        for (int pointIndex=0; pointIndex<16; pointIndex++) {
+            handler._terrainData[gridBit][pointIndex] = static_cast<int16_t>(gridBit);
+        }
+    }
+    handler._resolvedMask = terrainRequest.mask;
+
+    // The vehicle repeating the request for the same grid gets the resolved blocks without another terrain lookup
+    lookups = tileManager->cacheHits() + tileManager->cacheMisses();
+    QVERIFY(!handler.mavlinkMessageReceived(message));
+    QCOMPARE(tileManager->cacheHits() + tileManager->cacheMisses(), lookups);
+    QCOMPARE(handler._resolvedMask, terrainRequest.mask);
+    QCOMPARE(handler._currentTerrainRequest.mask, static_cast<uint64_t>(0));
+
+    // A different grid starts over
+    terrainRequest.lat += 10000;
+    (void) mavlink_msg_terrain_request_encode_chan(static_cast<uint8_t>(vehicle->id()), MAV_COMP_ID_AUTOPILOT1, _mockLink->mavlinkChannel(), &message, &terrainRequest);
+    QVERIFY(!handler.mavlinkMessageReceived(message));
+    QVERIFY((tileManager->cacheHits() + tileManager->cacheMisses()) > lookups);
+    QCOMPARE(handler._resolvedMask, static_cast<uint64_t>(0));
+
+    _disconnectMockLink();
+}
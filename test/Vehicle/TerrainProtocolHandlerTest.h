@@ -0,0 +1,23 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Tests the TERRAIN_REQUEST grid points, the TERRAIN_DATA burst size and the reuse of resolved blocks
+class TerrainProtocolHandlerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testGridCoordinates();
+    void _testBlocksPerTick();
+    void _testRepeatedRequest();
+};
@@ -0,0 +1,240 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleMessageDispatchTest.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "MockLink.h"
+#include "TLogIndex.h"
+#include "Vehicle.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+void VehicleMessageDispatchTest::_testDispatchTable()
+{
+    _connectMockLinkNoInitialConnectSequence();
+    Vehicle* vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    QVERIFY(vehicle);
+
+    const Vehicle::MessageHandlers gpsHandlers = vehicle->_messageHandlers.value(MAVLINK_MSG_ID_GPS_RAW_INT);
+    QVERIFY(gpsHandlers.factGroups.contains(vehicle->gpsFactGroup()));
+    QVERIFY(!gpsHandlers.factGroups.contains(vehicle->windFactGroup()));
+    QVERIFY(!gpsHandlers.factGroups.contains(vehicle));
+
+    // The vehicle is a fact group itself
+    QVERIFY(vehicle->_messageHandlers.value(MAVLINK_MSG_ID_ATTITUDE).factGroups.contains(vehicle));
+
+    QVERIFY(vehicle->_messageHandlers.value(MAVLINK_MSG_ID_PARAM_VALUE).parameter);
+    QVERIFY(vehicle->_messageHandlers.value(MAVLINK_MSG_ID_TERRAIN_REQUEST).terrainProtocol);
+    QVERIFY(!vehicle->_messageHandlers.value(MAVLINK_MSG_ID_ATTITUDE).terrainProtocol);
+
+    // Groups which don't consume messages are never called
+    for (const Vehicle::MessageHandlers& handlers : vehicle->_messageHandlers) {
+        QVERIFY(!handlers.factGroups.contains(vehicle->clockFactGroup()));
+    }
+    QVERIFY(!vehicle->_allMessageFactGroups.contains(vehicle->clockFactGroup()));
+
+    _disconnectMockLink();
+}
+
+void VehicleMessageDispatchTest::_testBatteryGroupAdded()
+{
+    _connectMockLinkNoInitialConnectSequence();
+    Vehicle* vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    QVERIFY(vehicle);
+
+    const int batteryCount = vehicle->batteries()->count();
+
+    mavlink_battery_status_t batteryStatus{};
+    batteryStatus.id = 7;
+    batteryStatus.battery_remaining = 42;
+    mavlink_message_t message;
+    (void) mavlink_msg_battery_status_encode_chan(static_cast<uint8_t>(vehicle->id()), MAV_COMP_ID_AUTOPILOT1, _mockLink->mavlinkChannel(), &message, &batteryStatus);
+    vehicle->_mavlinkMessageReceived(_mockLink, message);
+
+    // The group created while handling the message is in the table and got the message
+    QCOMPARE(vehicle->batteries()->count(), batteryCount + 1);
+    FactGroup* batteryGroup = vehicle->batteries()->value<FactGroup*>(batteryCount);
+    QVERIFY(vehicle->_messageHandlers.value(MAVLINK_MSG_ID_BATTERY_STATUS).factGroups.contains(batteryGroup));
+    QCOMPARE(batteryGroup->getFact(QStringLiteral("percentRemaining"))->rawValue().toInt(), 42);
+
+    _disconnectMockLink();
+}
+
+void VehicleMessageDispatchTest::_writeLog(const QString& fileName, uint8_t sysid)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+
+    // Typical telemetry mix, most of it consumed by a single fact group or nobody at all
+    QList<mavlink_message_t> messages;
+    mavlink_message_t message;
+    const uint8_t compid = MAV_COMP_ID_AUTOPILOT1;
+
+    mavlink_attitude_t attitude{};
+    (void) mavlink_msg_attitude_encode_chan(sysid, compid, MAVLINK_COMM_0, &message, &attitude);
+    messages.append(message);
+    mavlink_attitude_quaternion_t attitudeQuaternion{};
+    attitudeQuaternion.q1 = 1;
+    (void) mavlink_msg_attitude_quaternion_encode_chan(sysid, compid, MAVLINK_COMM_0, &message, &attitudeQuaternion);
+    messages.append(message);
+    mavlink_vfr_hud_t vfrHud{};
+    (void) mavlink_msg_vfr_hud_encode_chan(sysid, compid, MAVLINK_COMM_0, &message, &vfrHud);
+    messages.append(message);
+    mavlink_gps_raw_int_t gpsRawInt{};
+    (void) mavlink_msg_gps_raw_int_encode_chan(sysid, compid, MAVLINK_COMM_0, &message, &gpsRawInt);
+    messages.append(message);
+    mavlink_local_position_ned_t localPosition{};
+    (void) mavlink_msg_local_position_ned_encode_chan(sysid, compid, MAVLINK_COMM_0, &message, &localPosition);
+    messages.append(message);
+    mavlink_attitude_target_t attitudeTarget{};
+    (void) mavlink_msg_attitude_target_encode_chan(sysid, compid, MAVLINK_COMM_0, &message, &attitudeTarget);
+    messages.append(message);
+    mavlink_servo_output_raw_t servoOutput{};
+    (void) mavlink_msg_servo_output_raw_encode_chan(sysid, compid, MAVLINK_COMM_0, &message, &servoOutput);
+    messages.append(message);
+    mavlink_highres_imu_t highresImu{};
+    (void) mavlink_msg_highres_imu_encode_chan(sysid, compid, MAVLINK_COMM_0, &message, &highresImu);
+    messages.append(message);
+    mavlink_vibration_t vibration{};
+    (void) mavlink_msg_vibration_encode_chan(sysid, compid, MAVLINK_COMM_0, &message, &vibration);
+    messages.append(message);
+    mavlink_scaled_pressure_t scaledPressure{};
+    (void) mavlink_msg_scaled_pressure_encode_chan(sysid, compid, MAVLINK_COMM_0, &message, &scaledPressure);
+    messages.append(message);
+
+    quint64 timeUSecs = 1700000000000000ULL;
+    for (const mavlink_message_t& logMessage : messages) {
+        uchar timestamp[TLogIndex::cbTimestamp];
+        qToBigEndian(timeUSecs, timestamp);
+        timeUSecs += 1000;
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t length = mavlink_msg_to_send_buffer(buffer, &logMessage);
+        (void) file.write(reinterpret_cast<const char*>(timestamp), sizeof(timestamp));
+        (void) file.write(reinterpret_cast<const char*>(buffer), length);
+    }
+}
+
+QList<mavlink_message_t> VehicleMessageDispatchTest::_loadLog(const QString& fileName, uint8_t sysid)
+{
+    QList<mavlink_message_t> messages;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return messages;
+    }
+    const QByteArray log = file.readAll();
+    const uchar* const data = reinterpret_cast<const uchar*>(log.constData());
+
+    TLogIndex::Record record;
+    qint64 offset = 0;
+    while (TLogIndex::nextRecord(data, log.size(), offset, record)) {
+        mavlink_message_t rxMessage{};
+        mavlink_status_t rxStatus{};
+        mavlink_message_t message;
+        mavlink_status_t status;
+        for (int i = 0; i < record.frameLength; i++) {
+            if (mavlink_frame_char_buffer(&rxMessage, &rxStatus, data[record.frameOffset + i], &message, &status) == MAVLINK_FRAMING_OK) {
+                // Route everything in the log to the vehicle under test
+                message.sysid = sysid;
+                messages.append(message);
+            }
+        }
+        offset = record.endOffset();
+    }
+
+    return messages;
+}
+
+QList<mavlink_message_t> VehicleMessageDispatchTest::_benchmarkMessages(Vehicle* vehicle)
+{
+    const uint8_t sysid = static_cast<uint8_t>(vehicle->id());
+
+    QString fileName = qEnvironmentVariable("QGC_DISPATCH_BENCHMARK_TLOG");
+    QTemporaryDir tempDir;
+    if (fileName.isEmpty()) {
+        fileName = tempDir.filePath(QStringLiteral("dispatch.tlog"));
+        _writeLog(fileName, sysid);
+    }
+
+    const QList<mavlink_message_t> logMessages = _loadLog(fileName, sysid);
+    QList<mavlink_message_t> messages;
+    messages.reserve(logMessages.count() * _logRepeatCount);
+    for (int i = 0; i < _logRepeatCount; i++) {
+        messages.append(logMessages);
+    }
+    return messages;
+}
+
+void VehicleMessageDispatchTest::_benchmarkFactGroupDispatch_data()
+{
+    QTest::addColumn<bool>("messageIdTable");
+
+    QTest::newRow("allGroups") << false;
+    QTest::newRow("messageIdTable") << true;
+}
+
+void VehicleMessageDispatchTest::_benchmarkFactGroupDispatch()
+{
+    QFETCH(bool, messageIdTable);
+
+    _connectMockLinkNoInitialConnectSequence();
+    Vehicle* vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    QVERIFY(vehicle);
+
+    QList<mavlink_message_t> messages = _benchmarkMessages(vehicle);
+    QVERIFY(!messages.isEmpty());
+
+    if (messageIdTable) {
+        QBENCHMARK {
+            for (mavlink_message_t& message : messages) {
+                const Vehicle::MessageHandlers handlers = vehicle->_messageHandlers.value(message.msgid);
+                for (FactGroup* factGroup : vehicle->_allMessageFactGroups) {
+                    factGroup->handleMessage(vehicle, message);
+                }
+                for (FactGroup* factGroup : handlers.factGroups) {
+                    factGroup->handleMessage(vehicle, message);
+                }
+            }
+        }
+    } else {
+        // How dispatch worked before the table, every group sees every message
+        QBENCHMARK {
+            for (mavlink_message_t& message : messages) {
+                for (FactGroup* factGroup : vehicle->factGroups()) {
+                    factGroup->handleMessage(vehicle, message);
+                }
+                vehicle->handleMessage(vehicle, message);
+            }
+        }
+    }
+
+    _disconnectMockLink();
+}
+
+void VehicleMessageDispatchTest::_benchmarkMessageReceived()
+{
+    _connectMockLinkNoInitialConnectSequence();
+    Vehicle* vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    QVERIFY(vehicle);
+
+    const QList<mavlink_message_t> messages = _benchmarkMessages(vehicle);
+    QVERIFY(!messages.isEmpty());
+
+    QBENCHMARK {
+        for (const mavlink_message_t& message : messages) {
+            vehicle->_mavlinkMessageReceived(_mockLink, message);
+        }
+    }
+
+    _disconnectMockLink();
+}
@@ -0,0 +1,37 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "MAVLinkLib.h"
+
+class Vehicle;
+
+/// Tests the message id indexed dispatch in Vehicle::_mavlinkMessageReceived and benchmarks it against calling
+/// every fact group for every message. The benchmark replays a telemetry log, set QGC_DISPATCH_BENCHMARK_TLOG to
+/// use a recorded flight log instead of the generated one.
+class VehicleMessageDispatchTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testDispatchTable();
+    void _testBatteryGroupAdded();
+    void _benchmarkFactGroupDispatch_data();
+    void _benchmarkFactGroupDispatch();
+    void _benchmarkMessageReceived();
+
+private:
+    void _writeLog(const QString& fileName, uint8_t sysid);
+    QList<mavlink_message_t> _loadLog(const QString& fileName, uint8_t sysid);
+    QList<mavlink_message_t> _benchmarkMessages(Vehicle* vehicle);
+
+    static constexpr int _logRepeatCount = 1000;
+};